@@ -20,6 +20,15 @@
 #define SYNTHPATHY_ACTIVENOTE_H_
 
 #include "waveforms.h"
+#include "ModulationMatrix.h"
+#include "NoiseGenerator.h"
+#include "FmVoice.hpp"
+#include "PluckedString.h"
+#include "DelayArena.hpp"
+#include "SamplePlayer.h"
+#include "Unison.h"
+#include "NoteCache.h"
+#include "SmoothedParameter.hpp"
 
 #include <limits>
 
@@ -36,10 +45,28 @@ protected:
     MidiByte m_midi_note;
 
     /**
-     * @brief The period of the note in number of samples.
+     * @brief The pitch of the note in semitones, gliding towards the midi note.
      * 
      */
-    unsigned int m_period_fs;
+    SmoothedParameter<fxpt_Q15_16> m_pitch;
+
+    /**
+     * @brief The modulation of the pitch in semitones.
+     * 
+     */
+    fxpt_Q15_16 m_pitch_modulation;
+
+    /**
+     * @brief The phase of the oscillator, a full period being 2^32.
+     * 
+     */
+    fxpt_UQ0_32 m_phase;
+
+    /**
+     * @brief The increment of m_phase at each sample, updated at control rate.
+     * 
+     */
+    fxpt_UQ0_32 m_phase_increment;
 
     /**
      * @brief The velocity of the note between 0 and 1.
@@ -89,17 +116,304 @@ protected:
      */
     fxpt_Q0_31 m_ADSR_at_release;
 
+    /**
+     * @brief The modulation of the texture parameter, added to the texture given at each sample.
+     * 
+     */
+    fxpt_Q0_31 m_texture_modulation;
 
-    // Private methods -----------------------------------------------------------------------------
+    /**
+     * @brief The gain applied by the amplitude modulation, between 0 and 1.
+     * 
+     */
+    fxpt_Q0_31 m_amplitude;
 
     /**
-     * @brief Get the value level of the ADSR envelope
+     * @brief The increment of m_amplitude at each sample, so that it reaches its target in one audio block.
      * 
-     * @param time_fs Current time in number of periods of the audio sampling frequency.
-     * @param sustain Sustain level between 0 and 1.
+     */
+    fxpt_Q0_31 m_amplitude_step;
+
+    /**
+     * @brief The noise oscillator of the note, seeded by the note and its start time.
+     * 
+     */
+    NoiseGenerator m_noise;
+
+    /**
+     * @brief The noise samples of the current audio block.
+     * 
+     */
+    fxpt_Q0_31 m_noise_block[SIZE_AUDIO_BLOCK];
+
+    /**
+     * @brief The index of the next sample to be read in m_noise_block.
+     * 
+     */
+    unsigned int m_noise_idx;
+
+    /**
+     * @brief The FM voice of the note.
+     * 
+     */
+    FmVoice<FM_NB_OPERATORS_MAX> m_fm;
+
+    /**
+     * @brief The FM samples of the current audio block.
+     * 
+     */
+    fxpt_Q0_31 m_fm_block[SIZE_AUDIO_BLOCK];
+
+    /**
+     * @brief The index of the next sample to be read in m_fm_block.
+     * 
+     */
+    unsigned int m_fm_idx;
+
+    /**
+     * @brief The plucked string of the note, which only sounds when it was given a delay line.
+     * 
+     */
+    PluckedString m_pluck;
+
+    /**
+     * @brief The slot of the delay line of the plucked string in the arena of the NoteManager, DELAY_ARENA_NO_SLOT if none.
+     * 
+     */
+    int m_pluck_slot;
+
+    /**
+     * @brief The plucked string samples of the current audio block.
+     * 
+     */
+    fxpt_Q0_31 m_pluck_block[SIZE_AUDIO_BLOCK];
+
+    /**
+     * @brief The index of the next sample to be read in m_pluck_block.
+     * 
+     */
+    unsigned int m_pluck_idx;
+
+    /**
+     * @brief The sample player of the note, which only sounds when it was given a sample.
+     * 
+     */
+    SamplePlayer m_sample_player;
+
+    /**
+     * @brief The sampled samples of the current audio block.
+     * 
+     */
+    fxpt_Q0_31 m_sample_block[SIZE_AUDIO_BLOCK];
+
+    /**
+     * @brief The index of the next sample to be read in m_sample_block.
+     * 
+     */
+    unsigned int m_sample_idx;
+
+    /**
+     * @brief The number of samples of the oscillators of the unison mode per audio block, at the oversampled rate.
+     * 
+     */
+    static constexpr unsigned int SIZE_UNISON_BLOCK = SIZE_AUDIO_BLOCK * OVERSAMPLING_FACTOR;
+
+    /**
+     * @brief The phases of the oscillators of the unison mode, spread at note on.
+     * 
+     */
+    fxpt_UQ0_32 m_unison_phases[UNISON_NB_OSCILLATORS_MAX];
+
+    /**
+     * @brief The number of oscillators of the current audio block, 1 if the unison mode is disabled.
+     * 
+     */
+    unsigned int m_unison_nb_oscillators;
+
+    /**
+     * @brief The sum of the oscillators of the unison mode for the current audio block, used instead of the waveform.
+     * 
+     */
+    fxpt_Q0_31 m_unison_block[SIZE_UNISON_BLOCK];
+
+    /**
+     * @brief The index of the next sample to be read in m_unison_block.
+     * 
+     */
+    unsigned int m_unison_idx;
+
+    #ifdef AUDIO_STEREO
+    /**
+     * @brief The difference between the right and left oscillators of the unison mode for the current audio block.
+     * 
+     */
+    fxpt_Q0_31 m_unison_side_block[SIZE_UNISON_BLOCK];
+    #endif
+
+    #if defined(AUDIO_STEREO) || defined(AUDIO_OVERSAMPLING)
+    /**
+     * @brief The envelope applied by the last call to get_audio_value, in Q1.30 so that 1 is exact.
+     * 
+     */
+    fxpt_Q1_30 m_envelope;
+    #endif
+
+    #ifdef AUDIO_OVERSAMPLING
+    /**
+     * @brief The part of the waveform left by the crossfades with the other layers, given to render_unison.
+     * 
+     */
+    fxpt_Q0_31 m_waveform_weight;
+    #endif
+
+    /**
+     * @brief The gains of the note on the left and right channels, only used in stereo.
+     * 
+     */
+    fxpt_Q0_31 m_pan_gains[2];
+
+    /**
+     * @brief The entry of the note cache of the NoteManager streamed or recorded by the note, NOTE_CACHE_NO_ENTRY if none.
+     * 
+     */
+    int m_cache_entry;
+
+    /**
+     * @brief The frames of the entry of the note cache, enveloped but without velocity.
+     * 
+     */
+    fxpt_Q0_15* m_cache_frames;
+
+    /**
+     * @brief The number of frames of the entry of the note cache to stream or to record.
+     * 
+     */
+    unsigned int m_cache_length;
+
+    /**
+     * @brief Whether the note records the entry of the note cache, or streams it.
+     * 
+     */
+    bool m_is_cache_recording;
+
+    #ifdef AUDIO_Q15
+    /**
+     * @brief Apply the velocity and the amplitude modulation to an enveloped value, on 16 bits.
+     * 
+     * @param value The enveloped value.
+     * @return fxpt_Q0_31 The value only has 16 significant bits.
+     */
+    inline fxpt_Q0_31 apply_velocity_q15(fxpt_Q16_15 value)
+    {
+        value = fxpt_convert_n(value * fxpt_convert_n(m_velocity, 31, 15), 30, 15);
+        if(m_amplitude != std::numeric_limits<fxpt_Q0_31>::max() || m_amplitude_step != 0)
+        {
+            m_amplitude += m_amplitude_step;
+            value = fxpt_convert_n(value * fxpt_convert_n(m_amplitude, 31, 15), 30, 15);
+        }
+        // The velocity being lower than 1, the value fits on 16 bits
+        return fxpt_convert_n(value, 15, 31);
+    }
+    #else
+    /**
+     * @brief Apply the velocity and the amplitude modulation to an enveloped value.
+     * 
+     * @param value The enveloped value.
      * @return fxpt_Q0_31 
      */
-    fxpt_Q0_31 get_ADSR_envelope(unsigned int time_fs, fxpt_Q0_31 sustain) const;
+    inline fxpt_Q0_31 apply_velocity(fxpt_Q0_31 value)
+    {
+        value = fxpt_convert_n((fxpt64_t)value * (fxpt64_t)m_velocity, 62, 31);
+        // Apply amplitude modulation, only when there is one
+        if(m_amplitude != std::numeric_limits<fxpt_Q0_31>::max() || m_amplitude_step != 0)
+        {
+            m_amplitude += m_amplitude_step;
+            value = fxpt_convert_n((fxpt64_t)value * (fxpt64_t)m_amplitude, 62, 31);
+        }
+        return value;
+    }
+    #endif
+
+    #ifdef AUDIO_Q15
+    /**
+     * @brief Crossfade a value to the next sample of a layer rendered by block, on 16 bits.
+     * 
+     * @param block The block of the layer, see render_noise.
+     * @param idx The index of the next sample in the block, moved forward whenever the layer is heard.
+     * @param level The part of the layer in the result between 0 and 1, 0 leaving the value untouched.
+     * @param value The value to crossfade from.
+     * @return fxpt_Q16_15 
+     */
+    static inline fxpt_Q16_15 crossfade_layer_q15(const fxpt_Q0_31* block, unsigned int& idx, fxpt_Q0_31 level, fxpt_Q16_15 value)
+    {
+        if(level == 0)
+        {
+            return value;
+        }
+        const fxpt_Q16_15 l_layer = fxpt_convert_n(block[idx], 31, 15);
+        // SIZE_AUDIO_BLOCK being a power of two, the index cannot overflow if a block is not rendered
+        idx = (idx + 1) & (SIZE_AUDIO_BLOCK - 1);
+        // The difference needs 17 bits, its product with a Q0.15 still fits in 32 bits
+        return value + fxpt_convert_n((l_layer - value) * fxpt_convert_n(level, 31, 15), 15, 0);
+    }
+    #else
+    /**
+     * @brief Crossfade a value to the next sample of a layer rendered by block.
+     * 
+     * @param block The block of the layer, see render_noise.
+     * @param idx The index of the next sample in the block, moved forward whenever the layer is heard.
+     * @param level The part of the layer in the result between 0 and 1, 0 leaving the value untouched.
+     * @param value The value to crossfade from.
+     * @return fxpt_Q0_31 
+     */
+    static inline fxpt_Q0_31 crossfade_layer(const fxpt_Q0_31* block, unsigned int& idx, fxpt_Q0_31 level, fxpt_Q0_31 value)
+    {
+        if(level == 0)
+        {
+            return value;
+        }
+        const fxpt_Q0_31 l_layer = block[idx];
+        // SIZE_AUDIO_BLOCK being a power of two, the index cannot overflow if a block is not rendered
+        idx = (idx + 1) & (SIZE_AUDIO_BLOCK - 1);
+        return value + fxpt_convert_n(((fxpt64_t)l_layer - (fxpt64_t)value) * (fxpt64_t)level, 31, 0);
+    }
+    #endif
+
+    /**
+     * @brief Indicates whether the sample at the given time is streamed from the note cache.
+     * 
+     * @param time_fs The time in number of periods of the audio sampling frequency.
+     */
+    inline bool is_streaming_cache(unsigned int time_fs) const
+    {
+        return m_cache_entry != NOTE_CACHE_NO_ENTRY && !m_is_cache_recording && time_fs - m_time_start_fs < m_cache_length;
+    }
+
+    #if defined(AUDIO_STEREO) || defined(AUDIO_OVERSAMPLING)
+    /**
+     * @brief Apply the envelope, velocity and amplitude of the last call to get_audio_value to a value, without
+     * making the amplitude modulation progress.
+     * @param value The value to scale.
+     * @return fxpt_Q0_31 
+     */
+    fxpt_Q0_31 apply_last_envelope(fxpt_Q0_31 value) const;
+    #endif
+
+    /**
+     * @brief Apply the texture modulation, saturated between 0 and 1.
+     * 
+     * @param texture The texture parameter of the waveform.
+     * @return fxpt_Q0_31 The modulated texture.
+     */
+    inline fxpt_Q0_31 get_modulated_texture(fxpt_Q0_31 texture) const
+    {
+        if(m_texture_modulation == 0)
+        {
+            return texture;
+        }
+        const fxpt64_t l_texture = (fxpt64_t)texture + (fxpt64_t)m_texture_modulation;
+        return (l_texture < 0) ? 0 : ((l_texture > std::numeric_limits<fxpt_Q0_31>::max()) ? std::numeric_limits<fxpt_Q0_31>::max() : l_texture);
+    }
 
 public:
 
@@ -129,6 +443,198 @@ public:
      */
     inline MidiByte get_midi_note() const { return m_midi_note; }
 
+    /**
+     * @brief The velocity of the note between 0 and 1.
+     * 
+     * @return fxpt_Q0_31 
+     */
+    inline fxpt_Q0_31 get_velocity() const { return m_velocity; }
+
+    /**
+     * @brief Time at which the note started, in number of periods of the audio sampling frequency.
+     * 
+     * @return unsigned int 
+     */
+    inline unsigned int get_time_start_fs() const { return m_time_start_fs; }
+
+    /**
+     * @brief The current pitch of the note in semitones, without bend nor modulation.
+     * 
+     * @return fxpt_Q15_16 
+     */
+    inline fxpt_Q15_16 get_pitch() const { return m_pitch.get(); }
+
+    /**
+     * @brief Make the pitch of the note glide from the given pitch to the pitch of its midi note.
+     * 
+     * @param pitch The pitch to start from in semitones.
+     * @param duration_blocks The glide duration in number of control rate updates.
+     */
+    void glide_from(fxpt_Q15_16 pitch, unsigned int duration_blocks);
+
+    /**
+     * @brief Compute the phase increment of the note for the next audio block, to be called once per audio block.
+     * This makes the glide progress and applies the pitch modulation, it does not involve any division.
+     * @param pitch_offset The pitch offset common to all notes in semitones, such as the pitch bend.
+     */
+    void update_pitch(fxpt_Q15_16 pitch_offset);
+
+    /**
+     * @brief Get the value level of the ADSR envelope
+     * 
+     * @param time_fs Current time in number of periods of the audio sampling frequency.
+     * @param sustain Sustain level between 0 and 1.
+     * @return fxpt_Q0_31 
+     */
+    fxpt_Q0_31 get_ADSR_envelope(unsigned int time_fs, fxpt_Q0_31 sustain) const;
+
+    /**
+     * @brief Get the value level of the ADSR envelope, on 16 bits.
+     * Unlike get_ADSR_envelope, this only involves 32 bits multiplications and divisions, see AUDIO_Q15.
+     * @param time_fs Current time in number of periods of the audio sampling frequency.
+     * @param sustain Sustain level between 0 and 1.
+     * @return fxpt_Q16_15 The level between 0 and 1 included.
+     */
+    fxpt_Q16_15 get_ADSR_envelope_q15(unsigned int time_fs, fxpt_Q0_15 sustain) const;
+
+    /**
+     * @brief Set the modulations of the note, to be called once per audio block.
+     * The amplitude modulation is interpolated over the next SIZE_AUDIO_BLOCK samples.
+     * @param modulations The modulation of each parameter between -1 and 1, see ModulationDestination.
+     */
+    void set_modulation(const fxpt_Q0_31 modulations[NB_MODULATION_DESTINATIONS]);
+
+    /**
+     * @brief Generate the noise samples of the next audio block, to be called once per audio block when noise is mixed.
+     * 
+     * @param color The spectrum of the noise.
+     */
+    void render_noise(NoiseColor color);
+
+    /**
+     * @brief Generate the FM samples of the next audio block, to be called once per audio block when FM is mixed,
+     * after update_pitch.
+     * @param patch The parameters of the FM voice.
+     * @param time_fs The time of the beginning of the block, in number of periods of the audio sampling frequency.
+     */
+    void render_fm(const FmPatch& patch, unsigned int time_fs);
+
+    /**
+     * @brief Pluck the string of the note on a delay line lent by an arena.
+     * 
+     * @param line The delay line of PLUCK_DELAY_LINE_SIZE samples.
+     * @param slot The slot of the delay line in the arena, given back by detach_pluck.
+     */
+    void pluck(fxpt_Q0_15* line, int slot);
+
+    /**
+     * @brief Stop using the delay line of the plucked string.
+     * 
+     * @return int The slot to give back to the arena, DELAY_ARENA_NO_SLOT if the note had none.
+     */
+    int detach_pluck();
+
+    /**
+     * @brief Generate the plucked string samples of the next audio block, to be called once per audio block when
+     * the string is mixed, after update_pitch.
+     * @param damping The gain of the loss filter of the string, see PluckedString::render_block.
+     */
+    void render_pluck(fxpt_Q0_15 damping);
+
+    /**
+     * @brief Play a sample at the pitch of the note, from its beginning.
+     * 
+     * @param sample The sample to play, usually read in flash from a SampleBank.
+     */
+    void start_sample(const Sample& sample);
+
+    /**
+     * @brief Generate the sampled samples of the next audio block, to be called once per audio block when
+     * the sample is mixed, after update_pitch.
+     * @param interpolation The interpolation between the frames of the sample.
+     */
+    void render_sample(SampleInterpolation interpolation);
+
+    /**
+     * @brief Render the detuned oscillators of the unison mode for the next audio block, to be called once per
+     * audio block after update_pitch. Each oscillator only costs a waveform evaluation and an addition per sample,
+     * the envelope and velocity being applied once to their sum by get_audio_value.
+     * @param unison The unison settings, the waveform being used as is if they have a single oscillator.
+     * @param waveform The selected type of waveform.
+     * @param texture The texture parameter of the waveform.
+     * @param waveform_weight The part of the waveform left by the crossfades with the other layers, for the stereo side
+     * and the oversampled rendering.
+     */
+    void render_unison(const Unison& unison, fxpt_Q0_31(*waveform)(fxpt_UQ0_32, fxpt_Q0_31), fxpt_Q0_31 texture, fxpt_Q0_31 waveform_weight);
+
+    #ifdef AUDIO_STEREO
+    /**
+     * @brief Get the stereo side of the unison oscillators for the sample of the last call to get_audio_value,
+     * with the same envelope, to be subtracted from the left channel and added to the right one before the panning.
+     * @param time_fs The time in number of periods of the audio sampling frequency.
+     * @param sub_sample The sub-sample of the oversampled rendering, see OVERSAMPLING_FACTOR.
+     * @return fxpt_Q0_31 
+     */
+    fxpt_Q0_31 get_unison_side(unsigned int time_fs, unsigned int sub_sample = 0) const;
+    #endif
+
+    /**
+     * @brief Stream the attack and decay of the note from an entry of the note cache instead of synthesizing them,
+     * the oscillators still running so that the live synthesis can take over at any audio block.
+     * @param frames The frames of the entry.
+     * @param length The number of frames of the entry, a multiple of SIZE_AUDIO_BLOCK.
+     * @param entry The index of the entry, given back by detach_cache.
+     */
+    void stream_cache(fxpt_Q0_15* frames, unsigned int length, int entry);
+
+    /**
+     * @brief Record the attack and decay of the note in an entry of the note cache while synthesizing them.
+     * 
+     * @param frames The frames of the entry.
+     * @param length The number of frames to record, a multiple of SIZE_AUDIO_BLOCK.
+     * @param entry The index of the entry, given back by detach_cache.
+     */
+    void record_cache(fxpt_Q0_15* frames, unsigned int length, int entry);
+
+    /**
+     * @brief Get the entry of the note cache streamed or recorded by the note.
+     * 
+     * @return int NOTE_CACHE_NO_ENTRY if none.
+     */
+    inline int get_cache_entry() const { return m_cache_entry; }
+
+    /**
+     * @brief Indicates whether the next audio block of the note can still be streamed or recorded, that is
+     * if the entry is not over and the note is neither released, gliding nor modulated, amplitude excepted.
+     * To be called after set_modulation.
+     * @param time_fs The time of the beginning of the block, in number of periods of the audio sampling frequency.
+     */
+    bool can_follow_cache(unsigned int time_fs) const;
+
+    /**
+     * @brief Stop streaming or recording the note cache, the note being synthesized from the next sample on.
+     * 
+     * @param time_fs The time of the beginning of the block, in number of periods of the audio sampling frequency.
+     * @param nb_recorded_frames Set to the number of frames recorded if the recording is complete, 0 otherwise.
+     * @return int The entry to give back to the cache, NOTE_CACHE_NO_ENTRY if the note had none.
+     */
+    int detach_cache(unsigned int time_fs, unsigned int& nb_recorded_frames);
+
+    /**
+     * @brief Set the position of the note in the stereo field, with a constant power panning.
+     * 
+     * @param pan The position between -1 (left) and 1 (right), 0 being the center.
+     */
+    void set_pan(fxpt_Q0_31 pan);
+
+    /**
+     * @brief The gain of the note on the given channel, set by set_pan.
+     * 
+     * @param channel 0 for left, 1 for right.
+     * @return fxpt_Q0_31 
+     */
+    inline fxpt_Q0_31 get_pan_gain(unsigned int channel) const { return m_pan_gains[channel]; }
+
     /**
      * @brief Release the current note
      * 
@@ -149,14 +655,37 @@ public:
 
     /**
      * @brief Get the audio value at the given time.
-     * 
+     * This must be called once per sample, since the phase and the amplitude modulation progress at each call.
+     * When compiled with AUDIO_Q15 the value only has 16 significant bits, the lower ones being 0.
      * @param time_fs The time in number of periods of the audio sampling frequency.
      * @param waveform The selected type of waveform.
      * @param texture The texture parameter of the waveform.
      * @param sustain Sustain level between 0 and 1.
+     * @param noise_level The part of noise mixed with the waveform between 0 and 1, see render_noise.
+     * @param fm_level The part of FM replacing the waveform between 0 and 1, before the noise is mixed, see render_fm.
+     * @param pluck_level The part of plucked string replacing the former mix between 0 and 1, before the noise is mixed, see render_pluck.
+     * @param sample_level The part of sample replacing the former mix between 0 and 1, before the noise is mixed, see render_sample.
      * @return fxpt_Q0_31 
      */
-    fxpt_Q0_31 get_audio_value(unsigned int time_fs, fxpt_Q0_31(*waveform)(unsigned int, unsigned int, fxpt_Q0_31), fxpt_Q0_31 texture, fxpt_Q0_31 sustain) const;
+    fxpt_Q0_31 get_audio_value(unsigned int time_fs, fxpt_Q0_31(*waveform)(fxpt_UQ0_32, fxpt_Q0_31), fxpt_Q0_31 texture, fxpt_Q0_31 sustain, fxpt_Q0_31 noise_level = 0, fxpt_Q0_31 fm_level = 0, fxpt_Q0_31 pluck_level = 0, fxpt_Q0_31 sample_level = 0);
+
+    #ifdef AUDIO_OVERSAMPLING
+    /**
+     * @brief Get the OVERSAMPLING_FACTOR sub-samples of the audio value at the given time, in place of get_audio_value.
+     * Only the oscillators are rendered at the higher rate : the crossfades and the envelope being linear in the waveform,
+     * each sub-sample is the first one plus its scaled difference of waveform, the other layers being held over the sample.
+     * @param time_fs The time in number of periods of the audio sampling frequency.
+     * @param waveform The selected type of waveform.
+     * @param texture The texture parameter of the waveform.
+     * @param sustain Sustain level between 0 and 1.
+     * @param noise_level See get_audio_value.
+     * @param fm_level See get_audio_value.
+     * @param pluck_level See get_audio_value.
+     * @param sample_level See get_audio_value.
+     * @param values The OVERSAMPLING_FACTOR sub-samples to write, in time order.
+     */
+    void get_audio_values_oversampled(unsigned int time_fs, fxpt_Q0_31(*waveform)(fxpt_UQ0_32, fxpt_Q0_31), fxpt_Q0_31 texture, fxpt_Q0_31 sustain, fxpt_Q0_31 noise_level, fxpt_Q0_31 fm_level, fxpt_Q0_31 pluck_level, fxpt_Q0_31 sample_level, fxpt_Q0_31* values);
+    #endif
 
     /**
      * @brief Indicates whether the note is still alive or not.
@@ -176,7 +705,7 @@ public:
      * @return true The note is already released.
      * @return false The note has not been released yet.
      */
-    inline bool is_released()
+    inline bool is_released() const
     {
         return m_time_released_fs != std::numeric_limits<unsigned int>::max();
     }
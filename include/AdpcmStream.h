@@ -0,0 +1,138 @@
+/**
+ * Synthpathy is a small and versatile audio synthesizer on a microcontroler. 
+ * Copyright (C) 2022  Brice Croix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SYNTHPATHY_ADPCMSTREAM_H_
+#define SYNTHPATHY_ADPCMSTREAM_H_
+
+#include "global.h"
+#include "adpcm.h"
+#include "SampleBank.h"
+
+/**
+ * @brief Decodes an ADPCM sample just ahead of its playback, into a ring of decoded frames.
+ * Frames are indexed by a virtual index which keeps increasing when the sample loops, so that the
+ * frames following the end of the loop are the ones of its beginning, and the silence after a
+ * sample without loop. Indices wrap around 2^32, the ring size being a divider of it.
+ */
+class AdpcmStream
+{
+public:
+
+    /**
+     * @brief The mask applied on virtual indices to get their position in the ring.
+     * 
+     */
+    static constexpr unsigned int RING_MSK = SAMPLE_ADPCM_RING_SIZE - 1;
+
+protected:
+
+    static_assert((SAMPLE_ADPCM_RING_SIZE & RING_MSK) == 0, "The ring of decoded frames must be a power of two");
+
+    /**
+     * @brief The decoded frames, frame of virtual index i being at i & RING_MSK.
+     * 
+     */
+    int16_t m_ring[SAMPLE_ADPCM_RING_SIZE];
+
+    /**
+     * @brief The first block of the sample.
+     * 
+     */
+    const uint8_t* m_blocks;
+
+    /**
+     * @brief The frame after the last decoded one, the end of the loop or of the sample.
+     * 
+     */
+    unsigned int m_end;
+
+    /**
+     * @brief The first frame of the loop.
+     * 
+     */
+    unsigned int m_loop_start;
+
+    /**
+     * @brief Whether the sample loops.
+     * 
+     */
+    bool m_is_looped;
+
+    /**
+     * @brief The next frame of the sample to decode.
+     * 
+     */
+    unsigned int m_frame;
+
+    /**
+     * @brief The virtual index of the next frame to decode.
+     * 
+     */
+    uint32_t m_virtual_end;
+
+    /**
+     * @brief The state of the decoder before m_frame.
+     * 
+     */
+    AdpcmState m_state;
+
+    /**
+     * @brief The state of the decoder before the first frame of the loop, to jump back to it.
+     * 
+     */
+    AdpcmState m_loop_state;
+
+    /**
+     * @brief Read the state stored at the beginning of a block.
+     * 
+     * @param block The index of the block.
+     * @return AdpcmState 
+     */
+    AdpcmState read_block_state(unsigned int block) const;
+
+public:
+
+    /**
+     * @brief AdpcmStream constructor, nothing is decoded.
+     * 
+     */
+    AdpcmStream();
+
+    /**
+     * @brief Start decoding a sample from its beginning, the state of its loop being found once here.
+     * 
+     * @param sample An ADPCM sample.
+     */
+    void start(const Sample& sample);
+
+    /**
+     * @brief Decode the frames up to a virtual index, the older frames being overwritten.
+     * 
+     * @param virtual_end The virtual index after the last frame needed, at most SAMPLE_ADPCM_RING_SIZE frames ahead.
+     */
+    void decode_until(uint32_t virtual_end);
+
+    /**
+     * @brief Get the decoded frames.
+     * 
+     * @return const int16_t* The ring of SAMPLE_ADPCM_RING_SIZE frames, see RING_MSK.
+     */
+    inline const int16_t* get_ring() const { return m_ring; }
+};
+
+#endif //SYNTHPATHY_ADPCMSTREAM_H_
\ No newline at end of file
@@ -0,0 +1,78 @@
+/**
+ * Synthpathy is a small and versatile audio synthesizer on a microcontroler. 
+ * Copyright (C) 2022  Brice Croix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SYNTHPATHY_AUDIOINPUT_H_
+#define SYNTHPATHY_AUDIOINPUT_H_
+
+#include "fxpt.h"
+
+/**
+ * @brief Converts the raw ADC samples of the audio input to audio samples.
+ * The input is biased at half the ADC range, its DC offset is removed by a one-pole high-pass filter.
+ * This class does not access the hardware, the raw samples are given by the owner of the ADC.
+ */
+class AudioInput
+{
+public:
+
+    /**
+     * @brief The number of bits of the raw ADC samples.
+     * 
+     */
+    static constexpr unsigned int ADC_BIT_DEPTH = 12;
+
+protected:
+
+    /**
+     * @brief The shift of the pole of the DC blocker, its cutoff frequency being about fs / (2pi * 2^shift).
+     * 2^-10 gives about 7Hz at 46875Hz.
+     */
+    static constexpr unsigned int DC_BLOCKER_SHIFT = 10;
+
+    /**
+     * @brief The last input sample, centered.
+     * 
+     */
+    fxpt_Q2_29 m_x1;
+
+    /**
+     * @brief The last output sample, before saturation.
+     * 
+     */
+    fxpt_Q2_29 m_y1;
+
+public:
+
+    /**
+     * @brief AudioInput constructor.
+     * 
+     */
+    AudioInput();
+
+    /**
+     * @brief Convert raw ADC samples to a block of audio samples.
+     * 
+     * @param raw The raw samples, unsigned on ADC_BIT_DEPTH bits.
+     * @param stride The distance between two consecutive samples in raw, for interleaved ADC channels.
+     * @param samples The audio samples to write.
+     * @param nb_samples The number of samples to convert.
+     */
+    void process_block(const volatile uint16_t* raw, unsigned int stride, fxpt_Q0_31* samples, unsigned int nb_samples);
+};
+
+#endif //SYNTHPATHY_AUDIOINPUT_H_
\ No newline at end of file
@@ -156,6 +156,14 @@ public:
      */
     fxpt_Q0_31 process(fxpt_Q0_31 x = 0);
 
+    /**
+     * @brief Process given block of samples in place.
+     * 
+     * @param samples The samples to process.
+     * @param nb_samples The number of samples in the block.
+     */
+    void process_block(fxpt_Q0_31* samples, unsigned int nb_samples);
+
     friend std::ostream &operator<<(std::ostream &output, const Biquad &biquad)
     { 
         output << "Biquad(" <<
@@ -227,7 +235,12 @@ protected:
 
 public:
 
-    DynamicBiquad(const Biquad &biquad);
+    /**
+     * @brief Creates a filter tending to the given filter, all-pass by default.
+     * 
+     * @param biquad 
+     */
+    DynamicBiquad(const Biquad &biquad = Biquad());
 
     /**
      * @brief Getters for the target filter coefficients.
@@ -267,6 +280,14 @@ public:
      */
     fxpt_Q0_31 process(fxpt_Q0_31 x = 0);
 
+    /**
+     * @brief Process given block of samples in place and updates transition progress.
+     * 
+     * @param samples The samples to process.
+     * @param nb_samples The number of samples in the block.
+     */
+    void process_block(fxpt_Q0_31* samples, unsigned int nb_samples);
+
     friend std::ostream &operator<<(std::ostream &output, const DynamicBiquad &biquad)
     { 
         output << "DynamicBiquad(" <<
@@ -0,0 +1,70 @@
+/**
+ * Synthpathy is a small and versatile audio synthesizer on a microcontroler. 
+ * Copyright (C) 2022  Brice Croix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SYNTHPATHY_BUTTONMATRIXDEBOUNCER_H_
+#define SYNTHPATHY_BUTTONMATRIXDEBOUNCER_H_
+
+#include "pico/stdlib.h"
+
+/**
+ * @brief Software model of the debouncing state machine of the button_matrix PIO program.
+ * It behaves exactly like the PIO program, one call to scan() being one scan of the matrix,
+ * so that the debouncing can be verified without the hardware.
+ */
+class ButtonMatrixDebouncer
+{
+protected:
+
+    /**
+     * @brief The state read by the previous scan (Y register of the PIO program).
+     * 
+     */
+    uint32_t m_previous_scan;
+
+    /**
+     * @brief The last published state (OSR register of the PIO program).
+     * 
+     */
+    uint32_t m_published;
+
+public:
+
+    /**
+     * @brief ButtonMatrixDebouncer constructor, all buttons are released.
+     * 
+     */
+    ButtonMatrixDebouncer();
+
+    /**
+     * @brief Process one scan of the button matrix.
+     * 
+     * @param raw_state The raw state read by the scan, with one bit per button.
+     * @return true if a new state is published (pushed in the RX FIFO by the PIO program).
+     * @return false if nothing is published.
+     */
+    bool scan(uint32_t raw_state);
+
+    /**
+     * @brief Get the last published state.
+     * 
+     * @return uint32_t 
+     */
+    inline uint32_t get_state() const { return m_published; }
+};
+
+#endif //SYNTHPATHY_BUTTONMATRIXDEBOUNCER_H_
\ No newline at end of file
@@ -25,6 +25,15 @@
 #include "midi.h"
 #include "global.h"
 #include "waveforms.h"
+#include "SmoothedParameter.hpp"
+#include "Lfo.h"
+#include "ModulationMatrix.h"
+#include "AudioInput.h"
+#include "FmVoice.hpp"
+#include "SamplePlayer.h"
+#include "Unison.h"
+
+#include <limits>
 
 /**
  * @brief This class owns the GPIOs used by the user.
@@ -33,6 +42,14 @@
  */
 struct Controls
 {
+public:
+
+    /**
+     * @brief The number of Low Frequency Oscillators.
+     * 
+     */
+    static constexpr unsigned int NB_LFOS = 2;
+
 protected:
 
     Controls(); // Prevent construction
@@ -66,22 +83,16 @@ protected:
     /**@}*/
 
     /**
-     * @brief The minimum duration between two read_buttons execution in seconds.
-     * 
+     * @brief The duration of a complete scan of the button matrix by the PIO, in seconds.
+     * A button state must be read identical on two consecutive scans to be taken into account.
      */
-    static constexpr float BUTTONS_READ_TIME_INTERVAL_S = 0.0004;
+    static constexpr float BUTTONS_SCAN_PERIOD_S = 0.0002f;
 
     /**
-     * @brief The minimum duration between two read_buttons execution in number of samples.
-     * 
+     * @brief The number of button events that can be stored by the DMA before being processed.
+     * Must be a power of two.
      */
-    static constexpr unsigned int BUTTONS_READ_TIME_INTERVAL_FS = BUTTONS_READ_TIME_INTERVAL_S * AUDIO_SAMPLING_FREQUENCY;
-
-    /**
-     * @brief The number of times a button must be seen with the same value to be considered stable.
-     * 
-     */
-    static constexpr unsigned int BUTTONS_STABILITY_THRESHOLD = 3;
+    static constexpr unsigned int SIZE_BUTTON_EVENTS_RING_BUFFER = 8;
 
     /**
      * @brief The indices of each LED signification.
@@ -90,6 +101,34 @@ protected:
      */
     static constexpr unsigned int LED_WAVEFORM_SQUARE_ENABLED_IDX = 0;
     static constexpr unsigned int LED_WAVEFORM_SAW_ENABLED_IDX = 1;
+    static constexpr unsigned int LED_VOICE_LAYER_ENABLED_IDX = 2;
+    /**@}*/
+
+    /**
+     * @brief The voices selected in turn by the waveform button, shown in binary on the LEDs, square being 1.
+     * The waveforms come first, each other layer then replacing the waveform entirely.
+     * @{
+     */
+    static constexpr unsigned int VOICE_SQUARE_IDX = 0;
+    static constexpr unsigned int VOICE_SAW_IDX = 1;
+    static constexpr unsigned int VOICE_SINE_IDX = 2;
+    static constexpr unsigned int VOICE_PLUCK_IDX = 3;
+    static constexpr unsigned int VOICE_FM_IDX = 4;
+    static constexpr unsigned int VOICE_SAMPLE_IDX = 5;
+    static constexpr unsigned int VOICE_NOISE_IDX = 6;
+    static constexpr unsigned int NB_VOICES = 7;
+    /**@}*/
+    static_assert(NB_VOICES < (1U << (LED_VOICE_LAYER_ENABLED_IDX + 1)), "Each voice must be shown by the LEDs");
+
+    /**
+     * @brief The midi controllers handled by set_controller, among the ones left undefined by the midi standard.
+     * @{
+     */
+    static constexpr MidiByte CONTROLLER_SAMPLE_LEVEL = 20;
+    static constexpr MidiByte CONTROLLER_SAMPLE_INDEX = 21;
+    static constexpr MidiByte CONTROLLER_SAMPLE_INTERPOLATION = 22;
+    static constexpr MidiByte CONTROLLER_NOISE_LEVEL = 23;
+    static constexpr MidiByte CONTROLLER_NOISE_COLOR = 24;
     /**@}*/
 
     /**
@@ -102,6 +141,30 @@ protected:
     static constexpr unsigned int POTENTIOMETER_TEXTURE_IDX = 0xFF;
     /**@}*/
 
+    /**
+     * @brief The number of bits of the ADC results.
+     * 
+     */
+    static constexpr unsigned int POTENTIOMETERS_BIT_DEPTH = 12;
+
+    /**
+     * @brief The maximum value of a potentiometer.
+     * 
+     */
+    static constexpr uint16_t POTENTIOMETERS_MAX = (1<<POTENTIOMETERS_BIT_DEPTH) - 1;
+
+    /**
+     * @brief The minimum change of an averaged potentiometer value for it to be taken into account.
+     * This prevents the ADC noise from constantly modifying the parameters.
+     */
+    static constexpr uint16_t POTENTIOMETERS_HYSTERESIS = 8;
+
+    /**
+     * @brief The width of the dead bands at both ends of the potentiometers course.
+     * Values in these bands are snapped to 0 or to POTENTIOMETERS_MAX, so that both ends can be reached despite the noise.
+     */
+    static constexpr uint16_t POTENTIOMETERS_DEADBAND = 16;
+
     /**
      * @brief The default channel on which to create midi events.
      * 
@@ -206,10 +269,60 @@ protected:
 
     /**
      * @brief The maximum cutoff frequency of the low-pass filter in Hertz.
-     * 
+     * It stays below 0.45 times the sampling frequency, the coefficients of the filter overflowing at Nyquist.
      */
     static constexpr fxpt_UQ16_16 FILTER_CUTOFF_MAX_HZ =
-        fxpt_from_float(((AUDIO_SAMPLING_FREQUENCY/2 < 20000.f) ? AUDIO_SAMPLING_FREQUENCY/2 : 20000.f), 16);
+        fxpt_from_float(((0.45f * AUDIO_SAMPLING_FREQUENCY < 20000.f) ? 0.45f * AUDIO_SAMPLING_FREQUENCY : 20000.f), 16);
+    static_assert(FILTER_CUTOFF_MAX_HZ < fxpt_convert_n((fxpt_UQ16_16)AUDIO_SAMPLING_FREQUENCY / 2, 0, 16),
+        "The cutoff frequency of the filter must stay below Nyquist");
+
+    /**
+     * @brief The smoothing duration of the sustain value in seconds.
+     * 
+     */
+    static constexpr float SUSTAIN_SMOOTHING_S = 0.02f;
+
+    /**
+     * @brief The smoothing duration of the sustain value in number of control rate updates.
+     * 
+     */
+    static constexpr unsigned int SUSTAIN_SMOOTHING_BLOCKS = SUSTAIN_SMOOTHING_S * CONTROL_RATE_HZ;
+
+    /**
+     * @brief The smoothing duration of the texture parameter in seconds.
+     * 
+     */
+    static constexpr float TEXTURE_SMOOTHING_S = 0.01f;
+
+    /**
+     * @brief The smoothing duration of the texture parameter in number of control rate updates.
+     * 
+     */
+    static constexpr unsigned int TEXTURE_SMOOTHING_BLOCKS = TEXTURE_SMOOTHING_S * CONTROL_RATE_HZ;
+
+    /**
+     * @brief The smoothing time constant of the filter cutoff in seconds.
+     * The cutoff frequency is smoothed exponentially, which sounds more natural than a linear ramp.
+     */
+    static constexpr float FILTER_CUTOFF_SMOOTHING_S = 0.05f;
+
+    /**
+     * @brief The smoothing time constant of the filter cutoff in number of control rate updates.
+     * 
+     */
+    static constexpr unsigned int FILTER_CUTOFF_SMOOTHING_BLOCKS = FILTER_CUTOFF_SMOOTHING_S * CONTROL_RATE_HZ;
+
+    /**
+     * @brief The default duration of the glide from a held note to the next one, in seconds.
+     * 
+     */
+    static constexpr float GLIDE_DEFAULT_S = 0.05f;
+
+    /**
+     * @brief The default duration of the glide in number of control rate updates.
+     * 
+     */
+    static constexpr unsigned int GLIDE_DEFAULT_BLOCKS = GLIDE_DEFAULT_S * CONTROL_RATE_HZ;
     
 
     // Private members ---------------------------------------------------------
@@ -229,29 +342,52 @@ protected:
     uint32_t m_buttons_old = 0;
 
     /**
-     * @brief The raw status of the buttons, without debounce.
+     * @brief The time at which m_buttons was published by the PIO, in microseconds.
+     * 
+     */
+    uint32_t m_buttons_time_us = 0;
+
+    /**
+     * @brief The ring buffer in which the DMA writes the buttons states published by the PIO.
+     * It must be aligned on its size in bytes for the DMA ring to wrap around it.
+     */
+    alignas(SIZE_BUTTON_EVENTS_RING_BUFFER * sizeof(uint32_t)) volatile uint32_t m_button_states_ring_buffer[SIZE_BUTTON_EVENTS_RING_BUFFER];
+
+    /**
+     * @brief The ring buffer in which the DMA writes the time of each state of m_button_states_ring_buffer, in microseconds.
+     * It must be aligned on its size in bytes for the DMA ring to wrap around it.
+     */
+    alignas(SIZE_BUTTON_EVENTS_RING_BUFFER * sizeof(uint32_t)) volatile uint32_t m_button_timestamps_ring_buffer[SIZE_BUTTON_EVENTS_RING_BUFFER];
+
+    /**
+     * @brief The index of the next event to be read in the events ring buffers.
+     * 
+     */
+    unsigned int m_button_events_read_idx = 0;
+
+    /**
+     * @brief The DMA channel copying the buttons states from the PIO to m_button_states_ring_buffer.
      * 
      */
-    uint32_t m_buttons_raw = 0;
+    unsigned int m_button_states_dma_channel;
 
     /**
-     * @brief An array to keep track of the stability of the buttons.
-     * This counter is incremented each time a button has been seen with the
-     * same value.
+     * @brief The DMA channel copying the time to m_button_timestamps_ring_buffer, after each state.
+     * 
      */
-    unsigned int m_buttons_stability_count[NB_PIN_BUTTON_MATRIX_OUT];
+    unsigned int m_button_timestamps_dma_channel;
 
     /**
-     * @brief The index of the output pin that is currently high for the button matrix.
+     * @brief The Low Frequency Oscillators, updated at control rate.
      * 
      */
-    unsigned int m_button_matrix_out_idx = 0;
+    Lfo m_lfos[NB_LFOS];
 
     /**
-     * @brief The last time at which the read method was called and executed.
+     * @brief The routes from modulation sources to modulated parameters.
      * 
      */
-    unsigned int m_button_time_fs_last_read = 0;
+    ModulationMatrix m_modulation_matrix;
 
     /**
      * @brief The status of each LED, with one bit per LED.
@@ -263,13 +399,19 @@ protected:
      * @brief The currently selected type of waveform, as a pointer to the actual waveform function.
      * 
      */
-    fxpt_Q0_31(*m_selected_waveform)(unsigned int, unsigned int, fxpt_Q0_31)  = &square_wave;
+    fxpt_Q0_31(*m_selected_waveform)(fxpt_UQ0_32, fxpt_Q0_31)  = &square_wave;
+
+    /**
+     * @brief The voice selected by the waveform button, see VOICE_SQUARE_IDX.
+     * 
+     */
+    unsigned int m_selected_voice = VOICE_SQUARE_IDX;
 
     /**
      * @brief The additionnal parameter of each waveform function.
      * 
      */
-    fxpt_Q0_31 m_texture;
+    SmoothedParameter<fxpt_Q0_31> m_texture;
 
     /**
      * @brief The currently selected octave.
@@ -293,7 +435,7 @@ protected:
      * @brief The sustain value between 0 and 1.
      * 
      */
-    fxpt_Q0_31 m_sustain;
+    SmoothedParameter<fxpt_Q0_31> m_sustain;
 
     /**
      * @brief The release value of the ADSR envelope, in number of periods of the audio sampling frequency.
@@ -305,7 +447,92 @@ protected:
      * @brief The value of the low pass filter cutoff in Hertz.
      * 
      */
-    fxpt_UQ16_16 m_filter_cutoff;
+    SmoothedParameter<fxpt_UQ16_16> m_filter_cutoff;
+
+    /**
+     * @brief The duration of the glide from a held note to the next one, in number of control rate updates.
+     * 0 disables the glide.
+     */
+    unsigned int m_glide_blocks = GLIDE_DEFAULT_BLOCKS;
+
+    /**
+     * @brief The fine tuning of all notes, in semitones.
+     * 
+     */
+    fxpt_Q15_16 m_fine_tune = 0;
+
+    /**
+     * @brief The part of noise in the output of each note, between 0 and 1, 0 disabling the noise.
+     * 
+     */
+    fxpt_Q0_31 m_noise_level = 0;
+
+    /**
+     * @brief The spectrum of the noise of each note.
+     * 
+     */
+    NoiseColor m_noise_color = NOISE_WHITE;
+
+    /**
+     * @brief The part of FM replacing the selected waveform in each note, between 0 and 1, 0 disabling the FM voice.
+     * 
+     */
+    fxpt_Q0_31 m_fm_level = 0;
+
+    /**
+     * @brief The parameters of the FM voice of the notes.
+     * 
+     */
+    FmPatch m_fm_patch;
+
+    /**
+     * @brief The detuned oscillators of each note, a single one disabling the unison mode.
+     * 
+     */
+    Unison m_unison;
+
+    /**
+     * @brief Incremented whenever a parameter shaping the attack and decay of the notes changes, see NoteCache.
+     * 
+     */
+    unsigned int m_patch_version = 0;
+
+    /**
+     * @brief The part of plucked string replacing the waveform and FM mix in each note, between 0 and 1, 0 disabling the strings.
+     * 
+     */
+    fxpt_Q0_31 m_pluck_level = 0;
+
+    /**
+     * @brief The gain of the loss filter of the plucked strings, about 0.995.
+     * 
+     */
+    fxpt_Q0_15 m_pluck_damping = 32604;
+
+    /**
+     * @brief The part of sample replacing the former mix in each note, between 0 and 1, 0 disabling the samples.
+     * 
+     */
+    fxpt_Q0_31 m_sample_level = 0;
+
+    /**
+     * @brief The index in the sample bank of the sample played by the notes.
+     * 
+     */
+    unsigned int m_sample_index = 0;
+
+    /**
+     * @brief The interpolation between the frames of the samples.
+     * 
+     */
+    SampleInterpolation m_sample_interpolation = SAMPLE_INTERPOLATION_LINEAR;
+
+    /**
+     * @brief The width of the stereo field between 0 and 1, notes being panned from left to right along the keyboard.
+     * Half width by default : the notes actually played, in the four middle octaves of the midi range,
+     * stay within a quarter of the stereo field from the center instead of sounding from one side.
+     */
+    fxpt_Q0_31 m_stereo_spread = 1<<30;
 
     /**
      * @brief The previous value of the low pass filter cutoff in Hertz.
@@ -325,6 +552,45 @@ protected:
      */
     fxpt_UQ3_29 m_filter_Q_old;
 
+    /**
+     * @brief The ring buffer in which the DMA writes the ADC results.
+     * Channels are converted in round-robin, so that sample i comes from channel i % NB_ADC_CHANNELS.
+     * It must be aligned on its size in bytes for the DMA ring to wrap around it.
+     */
+    alignas(SIZE_ADC_RING_BUFFER * sizeof(uint16_t)) volatile uint16_t m_adc_ring_buffer[SIZE_ADC_RING_BUFFER];
+
+    /**
+     * @brief The DMA channel used to transfer the ADC results.
+     * 
+     */
+    unsigned int m_adc_dma_channel;
+
+    /**
+     * @brief The last published value of each potentiometer.
+     * 
+     */
+    uint16_t m_potentiometers[NB_PIN_POTENTIOMETERS];
+
+    /**
+     * @brief The part of the audio input mixed with the notes, between 0 and 1.
+     * 
+     */
+    fxpt_Q0_31 m_input_level = std::numeric_limits<fxpt_Q0_31>::max();
+
+    #ifdef AUDIO_INPUT
+    /**
+     * @brief The conversion of the audio input samples read in the ADC ring buffer.
+     * 
+     */
+    AudioInput m_audio_input;
+
+    /**
+     * @brief The half of the ADC ring buffer that was last read as audio input.
+     * The DMA starts with the first half, the second one is not read before being written.
+     */
+    unsigned int m_audio_input_half_read = 1;
+    #endif
+
 
     // Private methods ---------------------------------------------------------
 
@@ -335,15 +601,48 @@ protected:
     void write_leds() const;
 
     /**
-     * @brief Called by the ADC after a conversion is complete.
+     * @brief Select a voice, either a waveform or a layer heard alone, and show it on the LEDs.
+     * 
+     * @param voice_idx The index of the voice, below NB_VOICES.
+     */
+    void select_voice(unsigned int voice_idx);
+
+    /**
+     * @brief Called when a potentiometer value has changed.
      * Can also be used to set the potentiometers values in software.
+     * Smoothed parameters only have their target set, see update_parameters().
      * @param potentiometer_idx The index of the potentiometer.
-     * @param value The value of the ADC.
+     * @param value The value of the ADC, on POTENTIOMETERS_BIT_DEPTH bits.
      */
-    void set_potentiometer(unsigned int potentiometer_idx, uint8_t value);
+    void set_potentiometer(unsigned int potentiometer_idx, uint16_t value);
 
-    // ADC interrupt handler needs to be able to modify the Controls.
-    friend void adc_irq_handler();
+    /**
+     * @brief Averages the ADC samples written by the DMA and publishes the potentiometers that changed.
+     * 
+     */
+    void read_potentiometers();
+
+    /**
+     * @brief Exponential mapping of a potentiometer value, for logarithmic controls.
+     * This maps [0, POTENTIOMETERS_MAX] to [1/256, 1[.
+     * @param value The value of the potentiometer, on POTENTIOMETERS_BIT_DEPTH bits.
+     * @return fxpt_UQ0_16
+     */
+    static fxpt_UQ0_16 get_exponential_mapping(uint16_t value);
+
+    /**
+     * @brief Linear mapping of a midi controller value to a level, 127 being full scale.
+     * 
+     * @param value The value of the controller, on 7 bits.
+     * @return fxpt_Q0_31 
+     */
+    static inline fxpt_Q0_31 get_controller_level(MidiByte value)
+    {
+        return (value >= 127) ? std::numeric_limits<fxpt_Q0_31>::max() : fxpt_convert_n((fxpt_Q0_31)value, 7, 31);
+    }
+
+    // Controls initialization needs to be able to setup the ADC DMA.
+    friend void initialize_controls();
 
 
 public:
@@ -361,24 +660,28 @@ public:
     /**
      * @brief Get the currently selected type of waveform.
      * This function returned pointer has signature :
-     * fxpt_Q0_31 waveform(unsigned int time_fs, unsigned int period_fs, fxpt_Q0_31 texture);
+     * fxpt_Q0_31 waveform(fxpt_UQ0_32 phase, fxpt_Q0_31 texture);
      * 
-     * @return fxpt_Q0_31(*)(unsigned int, unsigned int, fxpt_Q0_31) 
+     * @return fxpt_Q0_31(*)(fxpt_UQ0_32, fxpt_Q0_31) 
      */
-    inline fxpt_Q0_31(*get_selected_waveform(void) const)(unsigned int, unsigned int, fxpt_Q0_31) { return m_selected_waveform; }
+    inline fxpt_Q0_31(*get_selected_waveform(void) const)(fxpt_UQ0_32, fxpt_Q0_31) { return m_selected_waveform; }
 
     /**
      * @brief Set the currently selected type of waveform.
      * 
      */
-    inline void set_selected_waveform(fxpt_Q0_31 (*type_waveform)(unsigned int, unsigned int, fxpt_Q0_31)) { m_selected_waveform = type_waveform; }
+    inline void set_selected_waveform(fxpt_Q0_31 (*type_waveform)(fxpt_UQ0_32, fxpt_Q0_31))
+    {
+        m_selected_waveform = type_waveform;
+        ++m_patch_version;
+    }
 
     /**
      * @brief Get the texture parameter for the selected waveform.
      * 
      * @return fxpt_Q0_31 
      */
-    inline fxpt_Q0_31 get_texture() const { return m_texture; }
+    inline fxpt_Q0_31 get_texture() const { return m_texture.get(); }
 
     /**
      * @brief The attack value of the ADSR envelope, in number of periods of the audio sampling frequency.
@@ -396,7 +699,7 @@ public:
      * @brief The sustain value between 0 and 1.
      * 
      */
-    inline fxpt_Q0_31 get_sustain() const { return m_sustain; }
+    inline fxpt_Q0_31 get_sustain() const { return m_sustain.get(); }
 
     /**
      * @brief The release value of the ADSR envelope, in number of periods of the audio sampling frequency.
@@ -404,12 +707,273 @@ public:
      */
     inline unsigned int get_release_fs() const { return m_release_fs; }
 
+    /**
+     * @brief The duration of the glide from a held note to the next one, in number of control rate updates.
+     * 
+     */
+    inline unsigned int get_glide_blocks() const { return m_glide_blocks; }
+
+    /**
+     * @brief Set the duration of the glide from a held note to the next one.
+     * 
+     * @param glide_blocks The duration in number of control rate updates, 0 disables the glide.
+     */
+    inline void set_glide_blocks(unsigned int glide_blocks) { m_glide_blocks = glide_blocks; }
+
+    /**
+     * @brief The fine tuning of all notes, in semitones.
+     * 
+     * @return fxpt_Q15_16 
+     */
+    inline fxpt_Q15_16 get_fine_tune() const { return m_fine_tune; }
+
+    /**
+     * @brief Set the fine tuning of all notes.
+     * 
+     * @param fine_tune The tuning in semitones, 1/100 being one cent.
+     */
+    inline void set_fine_tune(fxpt_Q15_16 fine_tune)
+    {
+        m_fine_tune = fine_tune;
+        ++m_patch_version;
+    }
+
+    /**
+     * @brief The part of noise in the output of each note, between 0 and 1.
+     * 
+     * @return fxpt_Q0_31 
+     */
+    inline fxpt_Q0_31 get_noise_level() const { return m_noise_level; }
+
+    /**
+     * @brief Set the part of noise in the output of each note, the rest being the selected waveform.
+     * 
+     * @param noise_level The part of noise between 0 and 1, 0 disabling the noise.
+     */
+    inline void set_noise_level(fxpt_Q0_31 noise_level) { m_noise_level = noise_level; }
+
+    /**
+     * @brief The spectrum of the noise of each note.
+     * 
+     * @return NoiseColor 
+     */
+    inline NoiseColor get_noise_color() const { return m_noise_color; }
+
+    /**
+     * @brief Set the spectrum of the noise of each note.
+     * 
+     * @param noise_color 
+     */
+    inline void set_noise_color(NoiseColor noise_color) { m_noise_color = noise_color; }
+
+    /**
+     * @brief The part of FM replacing the selected waveform in each note, between 0 and 1.
+     * 
+     * @return fxpt_Q0_31 
+     */
+    inline fxpt_Q0_31 get_fm_level() const { return m_fm_level; }
+
+    /**
+     * @brief Set the part of FM replacing the selected waveform in each note.
+     * 
+     * @param fm_level The part of FM between 0 and 1, 0 disabling the FM voice.
+     */
+    inline void set_fm_level(fxpt_Q0_31 fm_level) { m_fm_level = fm_level; }
+
+    /**
+     * @brief The parameters of the FM voice, in order to edit them.
+     * 
+     * @return FmPatch& 
+     */
+    inline FmPatch& get_fm_patch() { return m_fm_patch; }
+
+    /**
+     * @brief The parameters of the FM voice.
+     * 
+     * @return const FmPatch& 
+     */
+    inline const FmPatch& get_fm_patch() const { return m_fm_patch; }
+
+    /**
+     * @brief The unison settings, in order to edit them, which invalidates the note cache.
+     * 
+     * @return Unison& 
+     */
+    inline Unison& get_unison()
+    {
+        ++m_patch_version;
+        return m_unison;
+    }
+
+    /**
+     * @brief The unison settings.
+     * 
+     * @return const Unison& 
+     */
+    inline const Unison& get_unison() const { return m_unison; }
+
+    /**
+     * @brief The version of the parameters shaping the attack and decay of the notes : waveform, texture,
+     * envelope, fine tune and unison. The attacks and decays cached with another version are stale.
+     * @return unsigned int 
+     */
+    inline unsigned int get_patch_version() const { return m_patch_version; }
+
+    /**
+     * @brief The part of plucked string replacing the waveform and FM mix in each note, between 0 and 1.
+     * 
+     * @return fxpt_Q0_31 
+     */
+    inline fxpt_Q0_31 get_pluck_level() const { return m_pluck_level; }
+
+    /**
+     * @brief Set the part of plucked string in each note, only notes started afterwards are plucked.
+     * 
+     * @param pluck_level The part of plucked string between 0 and 1, 0 disabling the strings.
+     */
+    inline void set_pluck_level(fxpt_Q0_31 pluck_level) { m_pluck_level = pluck_level; }
+
+    /**
+     * @brief The gain of the loss filter of the plucked strings.
+     * 
+     * @return fxpt_Q0_15 
+     */
+    inline fxpt_Q0_15 get_pluck_damping() const { return m_pluck_damping; }
+
+    /**
+     * @brief Set the gain of the loss filter of the plucked strings, the closer to 1 the longer they sustain.
+     * 
+     * @param pluck_damping 
+     */
+    inline void set_pluck_damping(fxpt_Q0_15 pluck_damping) { m_pluck_damping = pluck_damping; }
+
+    /**
+     * @brief The part of sample replacing the former mix in each note, between 0 and 1.
+     * 
+     * @return fxpt_Q0_31 
+     */
+    inline fxpt_Q0_31 get_sample_level() const { return m_sample_level; }
+
+    /**
+     * @brief Set the part of sample in each note, only notes started afterwards play the sample.
+     * 
+     * @param sample_level The part of sample between 0 and 1, 0 disabling the samples.
+     */
+    inline void set_sample_level(fxpt_Q0_31 sample_level) { m_sample_level = sample_level; }
+
+    /**
+     * @brief The index in the sample bank of the sample played by the notes.
+     * 
+     * @return unsigned int 
+     */
+    inline unsigned int get_sample_index() const { return m_sample_index; }
+
+    /**
+     * @brief Select the sample played by the notes started afterwards.
+     * 
+     * @param sample_index The index in the sample bank, notes are silent if there is no such sample.
+     */
+    inline void set_sample_index(unsigned int sample_index) { m_sample_index = sample_index; }
+
+    /**
+     * @brief The interpolation between the frames of the samples.
+     * 
+     * @return SampleInterpolation 
+     */
+    inline SampleInterpolation get_sample_interpolation() const { return m_sample_interpolation; }
+
+    /**
+     * @brief Set the interpolation between the frames of the samples, the cubic one costing more.
+     * 
+     * @param sample_interpolation 
+     */
+    inline void set_sample_interpolation(SampleInterpolation sample_interpolation) { m_sample_interpolation = sample_interpolation; }
+
+    /**
+     * @brief The width of the stereo field between 0 and 1.
+     * 
+     * @return fxpt_Q0_31 
+     */
+    inline fxpt_Q0_31 get_stereo_spread() const { return m_stereo_spread; }
+
+    /**
+     * @brief Set the width of the stereo field, only used in stereo.
+     * 
+     * @param stereo_spread 0 centers all notes, 1 pans the lowest midi note fully left and the highest one fully right,
+     * 0.5 by default.
+     */
+    inline void set_stereo_spread(fxpt_Q0_31 stereo_spread) { m_stereo_spread = stereo_spread; }
+
+    /**
+     * @brief The part of the audio input mixed with the notes, between 0 and 1.
+     * 
+     * @return fxpt_Q0_31 
+     */
+    inline fxpt_Q0_31 get_input_level() const { return m_input_level; }
+
+    /**
+     * @brief Set the part of the audio input mixed with the notes, only used when compiled with AUDIO_INPUT.
+     * 
+     * @param input_level 
+     */
+    inline void set_input_level(fxpt_Q0_31 input_level) { m_input_level = input_level; }
+
+    #ifdef AUDIO_INPUT
+    /**
+     * @brief Read the audio input block that the DMA has completed since the last call, if any.
+     * The ADC ring buffer holds two blocks of rounds : one is read while the DMA writes the other,
+     * so that the capture of the input adds a single block of latency.
+     * @param samples The SIZE_AUDIO_BLOCK samples to write.
+     * @return true if a new block was read.
+     * @return false if the DMA has not completed a new block yet, samples are then left untouched.
+     */
+    bool read_audio_input(fxpt_Q0_31* samples);
+    #endif
+
     /**
      * @brief The filter cutoff value in Hertz
      * 
      * @return fxpt_UQ16_16 
      */
-    inline fxpt_UQ16_16 get_filter_cutoff() const { return m_filter_cutoff; }
+    inline fxpt_UQ16_16 get_filter_cutoff() const { return m_filter_cutoff.get(); }
+
+    /**
+     * @brief The filter cutoff value in Hertz, shifted by a modulation.
+     * 
+     * @param modulation The modulation between -1 and 1, see MODULATION_FILTER_CUTOFF_RANGE_OCTAVES.
+     * @return fxpt_UQ16_16 
+     */
+    fxpt_UQ16_16 get_modulated_filter_cutoff(fxpt_Q0_31 modulation) const;
+
+    /**
+     * @brief Get a Low Frequency Oscillator in order to configure it.
+     * 
+     * @param lfo_idx The index of the oscillator, lower than NB_LFOS.
+     * @return Lfo& 
+     */
+    inline Lfo& get_lfo(unsigned int lfo_idx) { return m_lfos[lfo_idx]; }
+
+    /**
+     * @brief Get the current value of a Low Frequency Oscillator.
+     * 
+     * @param lfo_idx The index of the oscillator, lower than NB_LFOS.
+     * @return fxpt_Q0_31 
+     */
+    inline fxpt_Q0_31 get_lfo_value(unsigned int lfo_idx) const { return m_lfos[lfo_idx].get_value(); }
+
+    /**
+     * @brief Get the modulation matrix.
+     * 
+     * @return ModulationMatrix& 
+     */
+    inline ModulationMatrix& get_modulation_matrix() { return m_modulation_matrix; }
+
+    /**
+     * @brief Get the modulation matrix.
+     * 
+     * @return const ModulationMatrix& 
+     */
+    inline const ModulationMatrix& get_modulation_matrix() const { return m_modulation_matrix; }
 
     /**
      * @brief The filter Q factor.
@@ -426,54 +990,47 @@ public:
      */
     bool have_filter_params_changed();
 
+    /**
+     * @brief Read the potentiometers, make the smoothed parameters progress towards their targets
+     * and update the Low Frequency Oscillators.
+     * Must be called once per audio block, at control rate.
+     */
+    void update_parameters();
+
     /**
      * @brief Reads the buttons and update its internal values accordingly.
-     * One call of this method only reads one row of the button matrix.
-     * @param time_fs The time in number of periods of sampling frequency.
+     * One call of this method only reads one button event published by the PIO.
      * @return true if at least one button has changed its status.
      * @return false if there is no button status change.
      */
-    bool read_buttons(unsigned int time_fs);
+    bool read_buttons();
+
+    /**
+     * @brief The time at which the current buttons status was published, in microseconds.
+     * 
+     * @return uint32_t 
+     */
+    inline uint32_t get_buttons_time_us() const { return m_buttons_time_us; }
 
     /**
      * @brief Process the buttons status change.
      * 
      */
     void process_buttons();
+
+    /**
+     * @brief Called when a midi controller has changed, unknown controllers being ignored.
+     * The layer levels set this way are overwritten when another voice is selected with the waveform button.
+     * @param controller The number of the controller, see CONTROLLER_SAMPLE_LEVEL.
+     * @param value The value of the controller, on 7 bits.
+     */
+    void set_controller(MidiByte controller, MidiByte value);
 };
 
 /**
  * @brief Initializes the GPIO used by the Controls instance.
- * Also initializes the Analog to Digital Converter.
+ * Also initializes the Analog to Digital Converter and its DMA channel.
  */
 void initialize_controls();
 
-/**
- * @brief The handler function for the ADC end of conversion interrupt.
- * 
- */
-void adc_irq_handler();
-
-/**
- * @brief Puts a gpio output to high impedance.
- * This is simply an alias to configure the gpio as input.
- * @param gpio gpio number.
- */
-inline void gpio_put_high_z(unsigned int gpio)
-{
-    //gpio_put(gpio, false);
-    gpio_set_dir(gpio, GPIO_IN);
-}
-
-/**
- * @brief Remove high impedance state from gpio output and put it high.
- * This reconfigures the gpio as output then puts it high.
- * @param gpio gpio number.
- */
-inline void gpio_put_1_from_high_z(unsigned int gpio)
-{
-    gpio_set_dir(gpio, GPIO_OUT);
-    gpio_put(gpio, true);
-}
-
 #endif //SYNTHPATHY_CONTROLS_H_
\ No newline at end of file
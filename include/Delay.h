@@ -0,0 +1,189 @@
+/**
+ * Synthpathy is a small and versatile audio synthesizer on a microcontroler. 
+ * Copyright (C) 2022  Brice Croix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SYNTHPATHY_DELAY_H_
+#define SYNTHPATHY_DELAY_H_
+
+#include "global.h"
+#include "DelayLine.hpp"
+#include "SmoothedParameter.hpp"
+
+#include <limits>
+
+/**
+ * @brief Audio delay effect (echo), with feedback and damping of the repetitions.
+ * Samples are stored as Q0.15 within DELAY_MEMORY_BUDGET_BYTES.
+ * The delay time can be changed while playing, it then slides smoothly to the new value.
+ */
+class Delay
+{
+public:
+
+    /**
+     * @brief The number of samples stored by the delay line.
+     * 
+     */
+    static constexpr unsigned int SIZE_DELAY_LINE = fxpt_floor_pow2(DELAY_MEMORY_BUDGET_BYTES / sizeof(fxpt_Q0_15));
+
+    /**
+     * @brief The maximum delay time in number of samples.
+     * One sample is kept for the interpolation.
+     */
+    static constexpr unsigned int DELAY_MAX_FS = SIZE_DELAY_LINE - 1;
+
+    /**
+     * @brief The maximum delay time in milliseconds.
+     * 
+     */
+    static constexpr unsigned int DELAY_MAX_MS = (uint64_t)DELAY_MAX_FS * 1000 / AUDIO_SAMPLING_FREQUENCY;
+
+protected:
+
+    /**
+     * @brief The duration of the slide from a delay time to another, in seconds.
+     * 
+     */
+    static constexpr float DELAY_SMOOTHING_S = 0.1f;
+
+    /**
+     * @brief The duration of the slide from a delay time to another, in number of processed blocks.
+     * 
+     */
+    static constexpr unsigned int DELAY_SMOOTHING_BLOCKS = DELAY_SMOOTHING_S * CONTROL_RATE_HZ;
+
+    /**
+     * @brief The maximum feedback, slightly below 1 so that repetitions always fade out.
+     * 
+     */
+    static constexpr fxpt_Q0_31 FEEDBACK_MAX = std::numeric_limits<fxpt_Q0_31>::max() - (1<<24);
+
+    /**
+     * @brief The past samples.
+     * 
+     */
+    DelayLine<SIZE_DELAY_LINE> m_line;
+
+    /**
+     * @brief The delay time in number of samples, with a fractional part.
+     * 
+     */
+    SmoothedParameter<fxpt_UQ16_16> m_delay_fs;
+
+    /**
+     * @brief The part of the delayed signal that is added back in the delay line, between 0 and FEEDBACK_MAX.
+     * 
+     */
+    fxpt_Q0_31 m_feedback;
+
+    /**
+     * @brief The amount of delayed signal in the output, between 0 and 1.
+     * 
+     */
+    fxpt_Q0_31 m_mix;
+
+    /**
+     * @brief The coefficient of the low-pass filter applied on the repetitions, between 0 and 1.
+     * 0 means no damping, the closer to 1 the darker each repetition.
+     */
+    fxpt_Q0_31 m_damping;
+
+    /**
+     * @brief The state of the damping low-pass filter.
+     * 
+     */
+    fxpt_Q0_31 m_damped;
+
+public:
+
+    /**
+     * @brief Delay constructor.
+     * 
+     * @param delay_ms The delay time in milliseconds, up to DELAY_MAX_MS.
+     * @param feedback The part of the delayed signal added back in the line, between 0 and 1.
+     * @param mix The amount of delayed signal in the output, between 0 and 1.
+     * @param damping The damping of the repetitions, between 0 and 1.
+     */
+    Delay(unsigned int delay_ms = 300, fxpt_Q0_31 feedback = (1<<29), fxpt_Q0_31 mix = (1<<29), fxpt_Q0_31 damping = (1<<29));
+
+    /**
+     * @brief Set the delay time in milliseconds.
+     * 
+     * @param delay_ms The delay time, saturated to DELAY_MAX_MS.
+     */
+    void set_delay_ms(unsigned int delay_ms);
+
+    /**
+     * @brief Set the delay time as a fraction of a beat, at given tempo.
+     * Example : a dotted eighth note at 120 bpm is set_delay_tempo(120, 3, 4).
+     * @param tempo_bpm The tempo in beats per minute, clamped to at least 1.
+     * @param numerator The numerator of the fraction of a beat.
+     * @param denominator The denominator of the fraction of a beat, clamped to at least 1.
+     */
+    void set_delay_tempo(unsigned int tempo_bpm, unsigned int numerator = 1, unsigned int denominator = 1);
+
+    /**
+     * @brief Set the delay time in number of samples, with a fractional part.
+     * This can be used to modulate the delay (chorus, flanger), the delay then slides to the new value.
+     * @param delay_fs The delay time, between 1 and DELAY_MAX_FS.
+     */
+    void set_delay_fs(fxpt_UQ16_16 delay_fs);
+
+    /**
+     * @brief Get the delay time the effect is sliding to, in number of samples.
+     * 
+     * @return fxpt_UQ16_16 
+     */
+    inline fxpt_UQ16_16 get_delay_fs() const { return m_delay_fs.get_target(); }
+
+    /**
+     * @brief Set the part of the delayed signal added back in the delay line.
+     * 
+     * @param feedback Between 0 and 1, saturated to FEEDBACK_MAX.
+     */
+    inline void set_feedback(fxpt_Q0_31 feedback) { m_feedback = (feedback < 0) ? 0 : ((feedback > FEEDBACK_MAX) ? FEEDBACK_MAX : feedback); }
+
+    /**
+     * @brief Set the amount of delayed signal in the output.
+     * 
+     * @param mix Between 0 and 1.
+     */
+    inline void set_mix(fxpt_Q0_31 mix) { m_mix = mix; }
+
+    /**
+     * @brief Set the damping of the repetitions.
+     * 
+     * @param damping Between 0 (no damping) and 1.
+     */
+    inline void set_damping(fxpt_Q0_31 damping) { m_damping = damping; }
+
+    /**
+     * @brief Silence the delay line.
+     * 
+     */
+    void clear();
+
+    /**
+     * @brief Process given block of samples in place.
+     * The delay time slides towards its target once per block.
+     * @param samples The samples to process.
+     * @param nb_samples The number of samples in the block.
+     */
+    void process_block(fxpt_Q0_31* samples, unsigned int nb_samples);
+};
+
+#endif //SYNTHPATHY_DELAY_H_
\ No newline at end of file
@@ -0,0 +1,127 @@
+/**
+ * Synthpathy is a small and versatile audio synthesizer on a microcontroler. 
+ * Copyright (C) 2022  Brice Croix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SYNTHPATHY_DELAYARENA_HPP_
+#define SYNTHPATHY_DELAYARENA_HPP_
+
+#include "fxpt.h"
+
+/**
+ * @brief The slot returned by DelayArena::allocate when all delay lines are lent.
+ * 
+ */
+constexpr int DELAY_ARENA_NO_SLOT = -1;
+
+/**
+ * @brief A preallocated pool of delay lines of Q0.15 samples, lent to the voices that need one.
+ * All lines have the same size, so that allocating and releasing are a few bit operations on a mask,
+ * without any dynamic allocation nor fragmentation.
+ * 
+ * @tparam nb_slots The number of delay lines, usually the number of voices, 32 at most.
+ * @tparam slot_size The number of samples of each delay line, a power of two.
+ */
+template<unsigned int nb_slots, unsigned int slot_size>
+class DelayArena
+{
+protected:
+
+    static_assert(nb_slots > 0 && nb_slots <= 32, "The slots of a delay arena are tracked by a 32 bits mask");
+    static_assert((slot_size & (slot_size - 1)) == 0, "The size of the delay lines must be a power of two");
+
+    /**
+     * @brief The samples of all delay lines.
+     * 
+     */
+    fxpt_Q0_15 m_data[nb_slots][slot_size];
+
+    /**
+     * @brief The slots which are not lent, bit i standing for slot i.
+     * 
+     */
+    uint32_t m_free_mask;
+
+public:
+
+    /**
+     * @brief The number of delay lines.
+     * 
+     */
+    static constexpr unsigned int NB_SLOTS = nb_slots;
+
+    /**
+     * @brief The number of samples of each delay line.
+     * 
+     */
+    static constexpr unsigned int SLOT_SIZE = slot_size;
+
+    /**
+     * @brief DelayArena constructor, all slots are free.
+     * 
+     */
+    DelayArena()
+    {
+        m_free_mask = (nb_slots == 32) ? 0xFFFFFFFF : ((1U << nb_slots) - 1);
+    }
+
+    /**
+     * @brief Lend a delay line, its content being undefined.
+     * 
+     * @return int The index of the slot, or DELAY_ARENA_NO_SLOT if all are lent.
+     */
+    int allocate()
+    {
+        if(m_free_mask == 0)
+        {
+            return DELAY_ARENA_NO_SLOT;
+        }
+        // Lowest free slot
+        const int l_slot = __builtin_ctz(m_free_mask);
+        m_free_mask &= ~(1U << l_slot);
+        return l_slot;
+    }
+
+    /**
+     * @brief Give a delay line back to the arena.
+     * 
+     * @param slot The index given by allocate, DELAY_ARENA_NO_SLOT being ignored.
+     */
+    void release(int slot)
+    {
+        if(slot != DELAY_ARENA_NO_SLOT)
+        {
+            m_free_mask |= (1U << slot);
+        }
+    }
+
+    /**
+     * @brief The samples of a delay line.
+     * 
+     * @param slot The index given by allocate.
+     * @return fxpt_Q0_15* 
+     */
+    inline fxpt_Q0_15* get_line(int slot) { return m_data[slot]; }
+
+    /**
+     * @brief The number of delay lines that are not lent.
+     * 
+     * @return unsigned int 
+     */
+    inline unsigned int get_nb_free() const { return __builtin_popcount(m_free_mask); }
+};
+
+#endif //SYNTHPATHY_DELAYARENA_HPP_
\ No newline at end of file
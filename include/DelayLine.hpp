@@ -0,0 +1,123 @@
+/**
+ * Synthpathy is a small and versatile audio synthesizer on a microcontroler. 
+ * Copyright (C) 2022  Brice Croix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SYNTHPATHY_DELAYLINE_HPP_
+#define SYNTHPATHY_DELAYLINE_HPP_
+
+#include "CircularBuffer.hpp"
+#include "fxpt.h"
+
+/**
+ * @brief A delay line of audio samples stored as Q0.15, to halve the memory footprint.
+ * The most recent samples are always kept, writing never fails.
+ * Since the size is a power of two, wrapping around the buffer is a simple mask.
+ * 
+ * @tparam size The number of stored samples, a power of two.
+ */
+template<unsigned int size>
+class DelayLine : protected CircularBuffer<fxpt_Q0_15, size>
+{
+protected:
+
+    static_assert((size & (size - 1)) == 0, "The size of a delay line must be a power of two");
+
+    /**
+     * @brief The mask applied on indices to wrap around the buffer.
+     * 
+     */
+    static constexpr unsigned int IDX_MSK = size - 1;
+
+    using CircularBuffer<fxpt_Q0_15, size>::m_data;
+    using CircularBuffer<fxpt_Q0_15, size>::m_write_idx;
+
+public:
+
+    /**
+     * @brief DelayLine constructor, the line is filled with silence.
+     * 
+     */
+    DelayLine()
+    {
+        clear();
+    }
+
+    /**
+     * @brief The maximum delay that can be read, in number of samples.
+     * 
+     */
+    static constexpr unsigned int MAX_DELAY = size;
+
+    /**
+     * @brief The memory footprint of the stored samples, in bytes.
+     * 
+     */
+    static constexpr unsigned int SIZE_BYTES = size * sizeof(fxpt_Q0_15);
+
+    /**
+     * @brief Fill the line with silence.
+     * 
+     */
+    void clear()
+    {
+        for(unsigned int i = 0; i < size; ++i)
+        {
+            m_data[i] = 0;
+        }
+        m_write_idx = 0;
+    }
+
+    /**
+     * @brief Write the next sample in the line, overwriting the oldest one.
+     * 
+     * @param sample 
+     */
+    inline void write(fxpt_Q0_15 sample)
+    {
+        m_data[m_write_idx] = sample;
+        m_write_idx = (m_write_idx + 1) & IDX_MSK;
+    }
+
+    /**
+     * @brief Read the sample written a given number of samples ago.
+     * 
+     * @param delay The delay, between 1 (last written sample) and MAX_DELAY.
+     * @return fxpt_Q0_15 
+     */
+    inline fxpt_Q0_15 read(unsigned int delay) const
+    {
+        return m_data[(m_write_idx - delay) & IDX_MSK];
+    }
+
+    /**
+     * @brief Read the line at a fractional delay, linearly interpolated between two samples.
+     * 
+     * @param delay The delay in number of samples, between 1 and MAX_DELAY - 1.
+     * @return fxpt_Q0_15 
+     */
+    inline fxpt_Q0_15 read_interpolated(fxpt_UQ16_16 delay) const
+    {
+        const unsigned int l_delay = fxpt_convert_n(delay, 16, 0);
+        // Keep 15 bits of fraction so that the product with a 17 bits difference fits in 32 bits
+        const fxpt_Q0_15 l_fraction = fxpt_convert_n(delay & 0xFFFF, 16, 15);
+        const fxpt_Q0_15 l_newer = read(l_delay);
+        const fxpt_Q0_15 l_older = read(l_delay + 1);
+        return l_newer + fxpt_convert_n(((fxpt_Q15_16)l_older - (fxpt_Q15_16)l_newer) * l_fraction, 15, 0);
+    }
+};
+
+#endif //SYNTHPATHY_DELAYLINE_HPP_
\ No newline at end of file
@@ -0,0 +1,170 @@
+/**
+ * Synthpathy is a small and versatile audio synthesizer on a microcontroler. 
+ * Copyright (C) 2022  Brice Croix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SYNTHPATHY_EFFECTSCHAIN_HPP_
+#define SYNTHPATHY_EFFECTSCHAIN_HPP_
+
+#include "fxpt.h"
+
+template<class... Effects>
+class EffectsChain;
+
+/**
+ * @brief Compile-time access to the effect at a given position of an EffectsChain.
+ * 
+ * @tparam I The position of the effect in the chain.
+ * @tparam Chain The EffectsChain type.
+ */
+template<unsigned int I, class Chain>
+struct EffectsChainStage;
+
+/**
+ * @brief A chain of audio effects processing blocks of samples in place, one after the other.
+ * The chain is composed at compile time : each effect is stored by value and called directly,
+ * without any virtual dispatch. Each effect must implement :
+ * void process_block(fxpt_Q0_31* samples, unsigned int nb_samples);
+ * A bypassed effect costs a single test per block.
+ * 
+ * @tparam Effect The first effect of the chain.
+ * @tparam Effects The following effects, in processing order.
+ */
+template<class Effect, class... Effects>
+class EffectsChain<Effect, Effects...>
+{
+protected:
+
+    /**
+     * @brief The first effect of the chain.
+     * 
+     */
+    Effect m_effect;
+
+    /**
+     * @brief Whether the first effect processes the audio or is bypassed.
+     * 
+     */
+    bool m_enabled;
+
+    /**
+     * @brief The rest of the chain.
+     * 
+     */
+    EffectsChain<Effects...> m_next;
+
+    template<unsigned int I, class Chain>
+    friend struct EffectsChainStage;
+
+public:
+
+    /**
+     * @brief EffectsChain constructor, all effects are enabled.
+     * 
+     */
+    EffectsChain() : m_effect(), m_enabled(true), m_next() {}
+
+    /**
+     * @brief The number of effects in the chain.
+     * 
+     */
+    static constexpr unsigned int NB_EFFECTS = 1 + sizeof...(Effects);
+
+    /**
+     * @brief Get the effect at given position in order to configure it.
+     * 
+     * @tparam I The position of the effect, 0 being the first one.
+     */
+    template<unsigned int I>
+    inline typename EffectsChainStage<I, EffectsChain>::type& get_effect()
+    {
+        return EffectsChainStage<I, EffectsChain>::get_effect(*this);
+    }
+
+    /**
+     * @brief Indicates whether the effect at given position is enabled or bypassed.
+     * 
+     * @tparam I The position of the effect, 0 being the first one.
+     */
+    template<unsigned int I>
+    inline bool is_enabled() const
+    {
+        return EffectsChainStage<I, EffectsChain>::is_enabled(*this);
+    }
+
+    /**
+     * @brief Enable or bypass the effect at given position.
+     * 
+     * @tparam I The position of the effect, 0 being the first one.
+     * @param enabled
+     */
+    template<unsigned int I>
+    inline void set_enabled(bool enabled)
+    {
+        EffectsChainStage<I, EffectsChain>::set_enabled(*this, enabled);
+    }
+
+    /**
+     * @brief Process a block of samples in place by each enabled effect, in order.
+     * 
+     * @param samples The samples to process.
+     * @param nb_samples The number of samples in the block.
+     */
+    inline void process_block(fxpt_Q0_31* samples, unsigned int nb_samples)
+    {
+        if(m_enabled)
+        {
+            m_effect.process_block(samples, nb_samples);
+        }
+        m_next.process_block(samples, nb_samples);
+    }
+};
+
+/**
+ * @brief The end of any chain, which does nothing.
+ * 
+ */
+template<>
+class EffectsChain<>
+{
+public:
+    static constexpr unsigned int NB_EFFECTS = 0;
+
+    inline void process_block(fxpt_Q0_31* /*samples*/, unsigned int /*nb_samples*/) {}
+};
+
+template<class Effect, class... Effects>
+struct EffectsChainStage<0, EffectsChain<Effect, Effects...>>
+{
+    typedef Effect type;
+
+    static inline type& get_effect(EffectsChain<Effect, Effects...>& chain) { return chain.m_effect; }
+    static inline bool is_enabled(const EffectsChain<Effect, Effects...>& chain) { return chain.m_enabled; }
+    static inline void set_enabled(EffectsChain<Effect, Effects...>& chain, bool enabled) { chain.m_enabled = enabled; }
+};
+
+template<unsigned int I, class Effect, class... Effects>
+struct EffectsChainStage<I, EffectsChain<Effect, Effects...>>
+{
+    typedef EffectsChainStage<I-1, EffectsChain<Effects...>> next;
+    typedef typename next::type type;
+
+    static inline type& get_effect(EffectsChain<Effect, Effects...>& chain) { return next::get_effect(chain.m_next); }
+    static inline bool is_enabled(const EffectsChain<Effect, Effects...>& chain) { return next::is_enabled(chain.m_next); }
+    static inline void set_enabled(EffectsChain<Effect, Effects...>& chain, bool enabled) { next::set_enabled(chain.m_next, enabled); }
+};
+
+#endif //SYNTHPATHY_EFFECTSCHAIN_HPP_
\ No newline at end of file
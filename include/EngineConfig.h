@@ -0,0 +1,120 @@
+/**
+ * Synthpathy is a small and versatile audio synthesizer on a microcontroler. 
+ * Copyright (C) 2022  Brice Croix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SYNTHPATHY_ENGINECONFIG_H_
+#define SYNTHPATHY_ENGINECONFIG_H_
+
+/**
+ * @brief The parameters from which the timing of the audio engine is derived at compile time : sampling frequency,
+ * audio block size and number of voices. Every duration, table and limit given in number of samples follows
+ * the selected configuration, see ENGINE_CONFIG.
+ */
+struct EngineConfig
+{
+    /**
+     * @brief The system clock frequency in kHz.
+     * 
+     */
+    unsigned int system_clock_frequency_khz;
+
+    /**
+     * @brief The clock divider of the pwm audio output, a pwm period being 2^pwm_audio_bit_depth_per_channel cycles.
+     * 
+     */
+    unsigned int pwm_audio_clk_divider;
+
+    /**
+     * @brief The number of bits used by one channel of the pwm audio output slice.
+     * 
+     */
+    unsigned int pwm_audio_bit_depth_per_channel;
+
+    /**
+     * @brief The number of samples computed at once, between two updates at control rate, a power of two.
+     * 
+     */
+    unsigned int size_audio_block;
+
+    /**
+     * @brief The maximum number of notes that can be active at the same time.
+     * 
+     */
+    unsigned int nb_active_notes;
+
+    /**
+     * @brief The sampling frequency of the configuration in Hertz, one sample being output per pwm period.
+     * 
+     */
+    constexpr unsigned int get_sampling_frequency() const
+    {
+        return (system_clock_frequency_khz * 1000) / (pwm_audio_clk_divider * (1U << pwm_audio_bit_depth_per_channel));
+    }
+
+    /**
+     * @brief The rate in Hertz at which parameters are updated, once per audio block.
+     * 
+     */
+    constexpr unsigned int get_control_rate() const
+    {
+        return get_sampling_frequency() / size_audio_block;
+    }
+};
+
+/**
+ * @brief Fewer samples and more voices : 192MHz / (24*256) = 31250Hz, 6 voices.
+ * Blocks keep the default size, so that the control rate drops to 976Hz against 1465Hz.
+ */
+constexpr EngineConfig ENGINE_CONFIG_LOW_CPU = {192000U, 24, 8, 32, 6};
+
+/**
+ * @brief The default configuration : 192MHz / (16*256) = 46875Hz, 4 voices.
+ * 
+ */
+constexpr EngineConfig ENGINE_CONFIG_DEFAULT = {192000U, 16, 8, 32, 4};
+
+/**
+ * @brief Twice the default sampling frequency for half the voices : 192MHz / (8*256) = 93750Hz, 2 voices.
+ * Blocks are twice as long, so that the control rate stays the same.
+ */
+constexpr EngineConfig ENGINE_CONFIG_HIGH_QUALITY = {192000U, 8, 8, 64, 2};
+
+/**
+ * @brief The configuration of the audio engine, selected with ENGINE_LOW_CPU or ENGINE_HIGH_QUALITY.
+ * 
+ */
+constexpr EngineConfig ENGINE_CONFIG =
+#if defined(ENGINE_LOW_CPU)
+    ENGINE_CONFIG_LOW_CPU;
+#elif defined(ENGINE_HIGH_QUALITY)
+    ENGINE_CONFIG_HIGH_QUALITY;
+#else
+    ENGINE_CONFIG_DEFAULT;
+#endif
+
+#if defined(ENGINE_LOW_CPU) && defined(ENGINE_HIGH_QUALITY)
+#error "ENGINE_LOW_CPU and ENGINE_HIGH_QUALITY cannot be defined together"
+#endif
+
+static_assert((ENGINE_CONFIG.size_audio_block & (ENGINE_CONFIG.size_audio_block - 1)) == 0,
+    "The size of an audio block must be a power of two");
+static_assert(ENGINE_CONFIG.nb_active_notes > 0 && ENGINE_CONFIG.nb_active_notes <= 32,
+    "The voices are between 1 and 32, the delay lines of their strings being tracked by a 32 bits mask");
+static_assert((ENGINE_CONFIG.system_clock_frequency_khz * 1000) % (ENGINE_CONFIG.pwm_audio_clk_divider * (1U << ENGINE_CONFIG.pwm_audio_bit_depth_per_channel)) == 0,
+    "The sampling frequency must be an integer number of Hertz, so that the tables derived from it are exact");
+
+#endif //SYNTHPATHY_ENGINECONFIG_H_
\ No newline at end of file
@@ -0,0 +1,193 @@
+/**
+ * Synthpathy is a small and versatile audio synthesizer on a microcontroler. 
+ * Copyright (C) 2022  Brice Croix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SYNTHPATHY_FIR_HPP_
+#define SYNTHPATHY_FIR_HPP_
+
+#include <math.h>
+#include <limits>
+
+#include "fxpt.h"
+
+/**
+ * @brief Digital FIR filter with symmetric coefficients, hence a linear phase.
+ * Transfer function is H(z) = sum of h[k] * z^(-k), with h[k] = h[nb_taps - 1 - k].
+ * Samples sharing a coefficient are added before their multiplication, so that a sample costs (nb_taps + 1) / 2
+ * multiplications. The past samples are written twice in a buffer of twice their number, so that the window of
+ * the filter is always contiguous, without any wrapping of the indices.
+ * 
+ * @tparam nb_taps The number of taps of the filter.
+ */
+template<unsigned int nb_taps>
+class Fir
+{
+public:
+
+    static_assert(nb_taps > 0, "A FIR filter has at least one tap");
+
+    /**
+     * @brief The number of distinct coefficients, the first half of the taps.
+     * 
+     */
+    static constexpr unsigned int NB_COEFFICIENTS = (nb_taps + 1) / 2;
+
+protected:
+
+    /**
+     * @brief The first half of the coefficients, the middle one included when nb_taps is odd.
+     * A low-pass filter has coefficients in range [-1, 1], the precision Q1.30 is the one of Biquad.
+     */
+    fxpt_Q1_30 m_coeffs[NB_COEFFICIENTS];
+
+    /**
+     * @brief The past samples, each one being stored at m_idx and m_idx + nb_taps.
+     * 
+     */
+    fxpt_Q0_31 m_line[2 * nb_taps];
+
+    /**
+     * @brief The position of the most recent sample, the oldest one being at m_idx + nb_taps - 1.
+     * 
+     */
+    unsigned int m_idx;
+
+public:
+
+    /**
+     * @brief Creates a filter with given coefficients, the past samples being silence.
+     * 
+     * @param coeffs The NB_COEFFICIENTS first coefficients, or nullptr to create a pure delay of (nb_taps - 1) / 2 samples,
+     * which is only exact when nb_taps is odd.
+     */
+    Fir(const fxpt_Q1_30* coeffs = nullptr) : m_idx(0)
+    {
+        for(unsigned int i = 0; i < NB_COEFFICIENTS; ++i)
+        {
+            m_coeffs[i] = (coeffs != nullptr) ? coeffs[i] : 0;
+        }
+        if(coeffs == nullptr)
+        {
+            // The middle tap, or half of each of the two middle ones
+            m_coeffs[NB_COEFFICIENTS - 1] = (nb_taps & 1) ? (1<<30) : (1<<29);
+        }
+        for(unsigned int i = 0; i < 2 * nb_taps; ++i)
+        {
+            m_line[i] = 0;
+        }
+    }
+
+    /**
+     * @brief Get the array where coefficients are stored.
+     * 
+     * @return const fxpt_Q1_30* The NB_COEFFICIENTS first coefficients.
+     */
+    inline const fxpt_Q1_30* get_coeffs() const { return m_coeffs; }
+
+    /**
+     * @brief Copy the coefficients of another filter on current filter.
+     * This does not reset the past samples.
+     */
+    void copy_coefficients(const Fir& other)
+    {
+        for(unsigned int i = 0; i < NB_COEFFICIENTS; ++i)
+        {
+            m_coeffs[i] = other.m_coeffs[i];
+        }
+    }
+
+    /**
+     * @brief Get low pass filter, a windowed sinc whose gain at 0Hz is exactly 1.
+     * The Hamming window gives about -53dB of stop band, the transition band being about 3.3 * sampling_rate / nb_taps wide.
+     * 
+     * @param freq_cutoff The cutoff frequency, at which the gain is -6dB.
+     * @param sampling_rate The sampling frequency.
+     * @return Fir 
+     */
+    static Fir get_low_pass(fxpt_UQ16_16 freq_cutoff, unsigned int sampling_rate)
+    {
+        // The design is only done when the cutoff changes, floats are precise enough
+        const float l_cutoff = fxpt_to_float(freq_cutoff, 16) / sampling_rate;
+        const float l_middle = 0.5f * (nb_taps - 1);
+        float l_taps[NB_COEFFICIENTS];
+        float l_sum = 0.f;
+        for(unsigned int i = 0; i < NB_COEFFICIENTS; ++i)
+        {
+            const float l_t = i - l_middle;
+            const float l_sinc = (l_t == 0.f) ? 2.f * l_cutoff : sinf(2.f * (float)M_PI * l_cutoff * l_t) / ((float)M_PI * l_t);
+            const float l_window = (nb_taps > 1) ? 0.54f - 0.46f * cosf(2.f * (float)M_PI * i / (nb_taps - 1)) : 1.f;
+            l_taps[i] = l_sinc * l_window;
+            // The middle tap is not mirrored
+            l_sum += (2 * i + 1 == nb_taps) ? l_taps[i] : 2.f * l_taps[i];
+        }
+
+        fxpt_Q1_30 l_coeffs[NB_COEFFICIENTS];
+        for(unsigned int i = 0; i < NB_COEFFICIENTS; ++i)
+        {
+            l_coeffs[i] = fxpt_from_float(l_taps[i] / l_sum, 30);
+        }
+        return Fir(l_coeffs);
+    }
+
+    /**
+     * @brief Process given sample.
+     * 
+     * @param x 
+     * @return fxpt_Q0_31 
+     */
+    inline fxpt_Q0_31 process(fxpt_Q0_31 x = 0)
+    {
+        constexpr fxpt64_t l_max = std::numeric_limits<fxpt_Q0_31>::max();
+        constexpr fxpt64_t l_min = std::numeric_limits<fxpt_Q0_31>::min();
+
+        // The line is walked backwards, the most recent sample being written in both halves
+        m_idx = (m_idx == 0) ? nb_taps - 1 : m_idx - 1;
+        m_line[m_idx] = x;
+        m_line[m_idx + nb_taps] = x;
+
+        const fxpt_Q0_31* l_window = &m_line[m_idx];
+        fxpt64_t l_sum = 0;
+        for(unsigned int k = 0; k < nb_taps / 2; ++k)
+        {
+            l_sum += (fxpt64_t)m_coeffs[k] * ((fxpt64_t)l_window[k] + (fxpt64_t)l_window[nb_taps - 1 - k]);
+        }
+        if(nb_taps & 1)
+        {
+            l_sum += (fxpt64_t)m_coeffs[NB_COEFFICIENTS - 1] * (fxpt64_t)l_window[NB_COEFFICIENTS - 1];
+        }
+
+        // The ripple of the filter may overshoot full scale
+        l_sum = fxpt_convert_n(l_sum, 30, 0);
+        return (l_sum > l_max) ? l_max : ((l_sum < l_min) ? l_min : l_sum);
+    }
+
+    /**
+     * @brief Process given block of samples in place.
+     * 
+     * @param samples The samples to process.
+     * @param nb_samples The number of samples in the block.
+     */
+    void process_block(fxpt_Q0_31* samples, unsigned int nb_samples)
+    {
+        for(unsigned int i = 0; i < nb_samples; ++i)
+        {
+            samples[i] = process(samples[i]);
+        }
+    }
+};
+
+#endif //SYNTHPATHY_FIR_HPP_
\ No newline at end of file
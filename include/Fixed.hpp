@@ -0,0 +1,295 @@
+/**
+ * Synthpathy is a small and versatile audio synthesizer on a microcontroler. 
+ * Copyright (C) 2022  Brice Croix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SYNTHPATHY_FIXED_HPP_
+#define SYNTHPATHY_FIXED_HPP_
+
+#include <stdint.h>
+#include <type_traits>
+
+#include "fxpt.h"
+
+/**
+ * @brief How the bits lost by a conversion to fewer decimal bits are handled.
+ * 
+ */
+enum FixedRounding
+{
+    /**
+     * @brief The lost bits are dropped, rounding towards minus infinity, as fxpt_convert_n does.
+     * 
+     */
+    FIXED_TRUNCATE,
+
+    /**
+     * @brief The value is rounded to the nearest one, halves being rounded up, as fxpt_inc_step_round does.
+     * 
+     */
+    FIXED_ROUND_NEAREST
+};
+
+/**
+ * @brief How a value that does not fit in the destination format of a conversion is handled.
+ * 
+ */
+enum FixedOverflow
+{
+    /**
+     * @brief The most significant bits are dropped, as with the macros of fxpt.h.
+     * 
+     */
+    FIXED_WRAP,
+
+    /**
+     * @brief The value is clamped to the range of the destination format.
+     * 
+     */
+    FIXED_SATURATE
+};
+
+/**
+ * @brief The smallest integer type holding the given number of bits.
+ * 
+ * @tparam bits The number of bits, sign included.
+ * @tparam is_signed Whether the type is signed.
+ */
+template<unsigned int bits, bool is_signed = true>
+struct FixedStorage
+{
+    static_assert(bits <= 64, "A fixed-point value cannot be stored on more than 64 bits");
+
+    typedef typename std::conditional<(bits <= 8), int8_t,
+            typename std::conditional<(bits <= 16), int16_t,
+            typename std::conditional<(bits <= 32), int32_t, int64_t>::type>::type>::type signed_type;
+
+    typedef typename std::conditional<is_signed, signed_type, typename std::make_unsigned<signed_type>::type>::type type;
+};
+
+/**
+ * @brief A fixed-point value whose format is part of its type, so that conversions are checked and computed at compile time.
+ * It generates the same code as the macros of fxpt.h : it only holds its raw integer and every shift is a constant.
+ * Values of different formats cannot be mixed without an explicit fixed_cast, whereas products are exact and
+ * stored on 32 bits whenever they fit, on 64 bits otherwise.
+ * 
+ * @tparam int_bits The number of integer bits, sign excluded.
+ * @tparam frac_bits The number of decimal bits.
+ * @tparam Storage The integer type holding the raw value, the smallest signed one by default.
+ */
+template<unsigned int int_bits, unsigned int frac_bits, class Storage = typename FixedStorage<int_bits + frac_bits + 1>::type>
+class Fixed
+{
+public:
+
+    typedef Storage storage_type;
+
+    static constexpr unsigned int INT_BITS = int_bits;
+    static constexpr unsigned int FRAC_BITS = frac_bits;
+    static constexpr bool IS_SIGNED = std::is_signed<Storage>::value;
+
+    /**
+     * @brief The number of bits actually used by the format, sign included.
+     * 
+     */
+    static constexpr unsigned int BITS = int_bits + frac_bits + (IS_SIGNED ? 1 : 0);
+
+    static_assert(std::is_integral<Storage>::value, "The storage of a fixed-point value must be an integer type");
+    static_assert(BITS <= 8 * sizeof(Storage), "The format does not fit in its storage type");
+
+protected:
+
+    /**
+     * @brief The raw integer value, equal to the value multiplied by 2^frac_bits.
+     * 
+     */
+    Storage m_raw;
+
+    struct RawTag {};
+    constexpr Fixed(Storage raw, RawTag) : m_raw(raw) {}
+
+public:
+
+    /**
+     * @brief Fixed constructor, the value is 0.
+     * 
+     */
+    constexpr Fixed() : m_raw(0) {}
+
+    /**
+     * @brief Get the fixed-point value of given raw integer, such as a value of one of the fxpt.h types.
+     * 
+     * @param raw The value multiplied by 2^frac_bits.
+     */
+    static constexpr Fixed from_raw(Storage raw) { return Fixed(raw, RawTag()); }
+
+    /**
+     * @brief Get the fixed-point value of a floating-point number, truncated, meant for compile-time constants.
+     * 
+     * @param x A value within the range of the format.
+     */
+    static constexpr Fixed from_float(float x) { return from_raw((Storage)fxpt_from_float(x, frac_bits)); }
+
+    /**
+     * @brief The largest value of the format.
+     * 
+     */
+    static constexpr Fixed max() { return from_raw((Storage)(~(uint64_t)0 >> (64 - (BITS - (IS_SIGNED ? 1 : 0))))); }
+
+    /**
+     * @brief The lowest value of the format.
+     * 
+     */
+    static constexpr Fixed min() { return from_raw(IS_SIGNED ? (Storage)(-max().m_raw - 1) : 0); }
+
+    /**
+     * @brief The raw integer value, equal to the value multiplied by 2^frac_bits.
+     * 
+     * @return Storage 
+     */
+    constexpr Storage raw() const { return m_raw; }
+
+    /**
+     * @brief The value as a floating-point number.
+     * 
+     * @return float 
+     */
+    constexpr float to_float() const { return fxpt_to_float(m_raw, (int)frac_bits); }
+
+    /**
+     * @brief Arithmetic between values of the same format, wrapping around on overflow.
+     * @{
+     */
+    constexpr Fixed operator+(Fixed other) const { return from_raw((Storage)(m_raw + other.m_raw)); }
+    constexpr Fixed operator-(Fixed other) const { return from_raw((Storage)(m_raw - other.m_raw)); }
+    constexpr Fixed operator-() const { return from_raw((Storage)(-m_raw)); }
+    inline Fixed& operator+=(Fixed other) { m_raw = (Storage)(m_raw + other.m_raw); return *this; }
+    inline Fixed& operator-=(Fixed other) { m_raw = (Storage)(m_raw - other.m_raw); return *this; }
+    /**@}*/
+
+    /**
+     * @brief Comparisons between values of the same format.
+     * @{
+     */
+    constexpr bool operator==(Fixed other) const { return m_raw == other.m_raw; }
+    constexpr bool operator!=(Fixed other) const { return m_raw != other.m_raw; }
+    constexpr bool operator<(Fixed other) const { return m_raw < other.m_raw; }
+    constexpr bool operator<=(Fixed other) const { return m_raw <= other.m_raw; }
+    constexpr bool operator>(Fixed other) const { return m_raw > other.m_raw; }
+    constexpr bool operator>=(Fixed other) const { return m_raw >= other.m_raw; }
+    /**@}*/
+};
+
+/**
+ * @brief The exact format of the product of two fixed-point values.
+ * Its storage is on 32 bits whenever the product fits, so that the multiplication is a single instruction on the Cortex-M0+,
+ * and on 64 bits otherwise. The product of two signed values needs one more integer bit, the lowest value by itself being positive.
+ * 
+ * @tparam A The format of the first operand.
+ * @tparam B The format of the second operand.
+ */
+template<class A, class B>
+struct FixedProduct
+{
+    static constexpr bool IS_SIGNED = A::IS_SIGNED || B::IS_SIGNED;
+    static constexpr unsigned int INT_BITS = A::INT_BITS + B::INT_BITS + ((A::IS_SIGNED && B::IS_SIGNED) ? 1 : 0);
+    static constexpr unsigned int FRAC_BITS = A::FRAC_BITS + B::FRAC_BITS;
+
+    typedef Fixed<INT_BITS, FRAC_BITS,
+        typename FixedStorage<(INT_BITS + FRAC_BITS + (IS_SIGNED ? 1 : 0) <= 32) ? 32 : 64, IS_SIGNED>::type> type;
+};
+
+/**
+ * @brief The exact product of two fixed-point values, see FixedProduct for its format.
+ * 
+ */
+template<unsigned int ia, unsigned int fa, class Sa, unsigned int ib, unsigned int fb, class Sb>
+constexpr typename FixedProduct<Fixed<ia, fa, Sa>, Fixed<ib, fb, Sb>>::type
+operator*(Fixed<ia, fa, Sa> a, Fixed<ib, fb, Sb> b)
+{
+    typedef typename FixedProduct<Fixed<ia, fa, Sa>, Fixed<ib, fb, Sb>>::type Product;
+    return Product::from_raw(
+        (typename Product::storage_type)a.raw() * (typename Product::storage_type)b.raw()
+    );
+}
+
+/**
+ * @brief Shift of a raw value by a constant, to the right when shift is positive.
+ * 
+ * @tparam W The integer type in which the shift is computed.
+ * @tparam shift The number of bits to shift.
+ * @tparam rounding The handling of the bits lost by a right shift.
+ */
+template<class W, int shift, FixedRounding rounding, bool right = (shift > 0)>
+struct FixedShift
+{
+    static constexpr W apply(W x)
+    {
+        return (x + ((rounding == FIXED_ROUND_NEAREST) ? ((W)1 << (shift - 1)) : 0)) >> shift;
+    }
+};
+
+template<class W, int shift, FixedRounding rounding>
+struct FixedShift<W, shift, rounding, false>
+{
+    static constexpr W apply(W x)
+    {
+        // Shifted as unsigned, so that negative values are well defined
+        return (W)((typename std::make_unsigned<W>::type)x << (-shift));
+    }
+};
+
+/**
+ * @brief Convert a fixed-point value to another format, the shift being resolved at compile time.
+ * 
+ * @tparam To The destination format.
+ * @tparam rounding The handling of the decimal bits lost, if any.
+ * @tparam overflow The handling of values out of the range of the destination format.
+ * @param x The value to convert.
+ */
+template<class To, FixedRounding rounding = FIXED_TRUNCATE, FixedOverflow overflow = FIXED_WRAP,
+    unsigned int i, unsigned int f, class S>
+constexpr To fixed_cast(Fixed<i, f, S> x)
+{
+    // Wrapping only needs the widest of both storages, saturating compares the value on 64 bits
+    typedef typename std::conditional<(overflow == FIXED_SATURATE),
+        typename FixedStorage<64, Fixed<i, f, S>::IS_SIGNED || To::IS_SIGNED>::type,
+        typename std::conditional<(sizeof(S) > sizeof(typename To::storage_type)), S, typename To::storage_type>::type
+    >::type W;
+    typedef FixedShift<W, (int)f - (int)To::FRAC_BITS, rounding> Shift;
+
+    return (overflow == FIXED_SATURATE) ?
+        To::from_raw(
+            (Shift::apply((W)x.raw()) > (W)To::max().raw()) ? To::max().raw() :
+            ((Shift::apply((W)x.raw()) < (W)To::min().raw()) ? To::min().raw() :
+            (typename To::storage_type)Shift::apply((W)x.raw()))
+        ) :
+        To::from_raw((typename To::storage_type)Shift::apply((W)x.raw()));
+}
+
+/**
+ * @brief The signed formats of the audio path, named after their fxpt.h equivalents.
+ * @{
+ */
+typedef Fixed<0, 15> FixedQ0_15;
+typedef Fixed<0, 31> FixedQ0_31;
+typedef Fixed<1, 30> FixedQ1_30;
+typedef Fixed<2, 29> FixedQ2_29;
+typedef Fixed<3, 28> FixedQ3_28;
+typedef Fixed<15, 16> FixedQ15_16;
+/**@}*/
+
+#endif //SYNTHPATHY_FIXED_HPP_
\ No newline at end of file
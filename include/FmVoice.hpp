@@ -0,0 +1,375 @@
+/**
+ * Synthpathy is a small and versatile audio synthesizer on a microcontroler. 
+ * Copyright (C) 2022  Brice Croix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SYNTHPATHY_FMVOICE_HPP_
+#define SYNTHPATHY_FMVOICE_HPP_
+
+#include <type_traits>
+
+#include "global.h"
+#include "fxpt.h"
+
+/**
+ * @brief The largest number of operators of an FM voice, hence the number of operators of an FmPatch.
+ * 
+ */
+constexpr unsigned int FM_NB_OPERATORS_MAX = 4;
+
+/**
+ * @brief The shift from the output of a modulator to a phase offset of the operator it modulates.
+ * An output of 1 shifts the phase by 4 periods, hence a modulation index up to 8pi.
+ */
+constexpr unsigned int FM_MODULATION_SHIFT = 3;
+
+/**
+ * @brief How the operators of an FM voice modulate each other.
+ * Operator 1 is always a carrier, modulators always have a larger index than the operator they modulate.
+ * With only 2 operators, all algorithms but FM_ALGORITHM_ADDITIVE are 2 -> 1.
+ */
+enum FmAlgorithm
+{
+    /**
+     * @brief 4 -> 3 -> 2 -> 1, the brightest one.
+     * 
+     */
+    FM_ALGORITHM_STACK,
+
+    /**
+     * @brief 2 -> 1 and 4 -> 3, two simple FM pairs mixed together.
+     * 
+     */
+    FM_ALGORITHM_PAIRS,
+
+    /**
+     * @brief 2, 3 and 4 all modulate 1.
+     * 
+     */
+    FM_ALGORITHM_BRANCH,
+
+    /**
+     * @brief No modulation, all operators are mixed like an additive organ.
+     * 
+     */
+    FM_ALGORITHM_ADDITIVE,
+
+    NB_FM_ALGORITHMS
+};
+
+/**
+ * @brief The index of the operator modulated by an operator, or the number of operators if it is a carrier.
+ * 
+ * @param algorithm The algorithm of the voice.
+ * @param nb_operators The number of operators of the voice.
+ * @param op The index of the operator, 0 being operator 1.
+ */
+constexpr unsigned int fm_get_target(FmAlgorithm algorithm, unsigned int nb_operators, unsigned int op)
+{
+    return (op == 0 || algorithm == FM_ALGORITHM_ADDITIVE) ? nb_operators :
+        ((algorithm == FM_ALGORITHM_STACK) ? op - 1 :
+        ((algorithm == FM_ALGORITHM_PAIRS) ? ((op % 2 == 0) ? nb_operators : op - 1) : 0));
+}
+
+/**
+ * @brief The number of carriers of an algorithm.
+ * 
+ * @param algorithm The algorithm of the voice.
+ * @param nb_operators The number of operators of the voice.
+ * @param op The number of operators counted so far, used by the recursion.
+ */
+constexpr unsigned int fm_get_nb_carriers(FmAlgorithm algorithm, unsigned int nb_operators, unsigned int op = 0)
+{
+    return (op == nb_operators) ? 0 :
+        ((fm_get_target(algorithm, nb_operators, op) == nb_operators) ? 1 : 0) + fm_get_nb_carriers(algorithm, nb_operators, op + 1);
+}
+
+/**
+ * @brief The parameters of an operator of an FM voice.
+ * The envelope of an operator has no release, the note envelope is applied on the output of the voice.
+ */
+struct FmOperator
+{
+    /**
+     * @brief The frequency of the operator relatively to the note frequency.
+     * 
+     */
+    fxpt_UQ16_16 ratio;
+
+    /**
+     * @brief The output level of the operator between 0 and 1, its modulation depth for a modulator.
+     * 
+     */
+    fxpt_Q0_31 level;
+
+    /**
+     * @brief Attack duration, in number of periods of the audio sampling frequency.
+     * 
+     */
+    unsigned int attack_fs;
+
+    /**
+     * @brief Decay duration, in number of periods of the audio sampling frequency.
+     * 
+     */
+    unsigned int decay_fs;
+
+    /**
+     * @brief Sustain level between 0 and 1.
+     * 
+     */
+    fxpt_Q0_15 sustain;
+};
+
+/**
+ * @brief The parameters of an FM voice, shared by all notes.
+ * 
+ */
+struct FmPatch
+{
+    /**
+     * @brief How the operators modulate each other.
+     * 
+     */
+    FmAlgorithm algorithm;
+
+    /**
+     * @brief The parameters of each operator, a voice with fewer operators only uses the first ones.
+     * 
+     */
+    FmOperator operators[FM_NB_OPERATORS_MAX];
+
+    /**
+     * @brief FmPatch constructor, a bell-like stack whose modulation decays over a second.
+     * 
+     */
+    FmPatch() :
+        algorithm(FM_ALGORITHM_STACK),
+        operators{
+            {1<<16, 0x7FFFFFFF, 0, 0, 0x7FFF},
+            {2<<16, 1<<29, 0, AUDIO_SAMPLING_FREQUENCY, 0x2000},
+            {fxpt_convert_n(7, 0, 16) / 2, 1<<27, 0, AUDIO_SAMPLING_FREQUENCY / 2, 0},
+            {1<<16, 0, 0, 0, 0}
+        }
+    {}
+};
+
+/**
+ * @brief An FM voice made of sine operators modulating each other's phase, rendered by blocks.
+ * The operators loop is unrolled at compile time for each algorithm, so that the routing costs nothing per sample.
+ * The sine comes from the look-up table of fxpt_sin, so that the voice needs no wavetable.
+ * 
+ * @tparam nb_operators The number of operators, 2 or 4.
+ */
+template<unsigned int nb_operators>
+class FmVoice
+{
+protected:
+
+    static_assert(nb_operators == 2 || nb_operators == 4, "An FM voice has 2 or 4 operators");
+
+    /**
+     * @brief The phase of each operator, a full period being 2^32.
+     * 
+     */
+    fxpt_UQ0_32 m_phases[nb_operators];
+
+    /**
+     * @brief The increment of the phase of each operator at each sample.
+     * 
+     */
+    fxpt_UQ0_32 m_phase_increments[nb_operators];
+
+    /**
+     * @brief The level of each operator, its envelope included.
+     * 
+     */
+    fxpt_Q0_31 m_levels[nb_operators];
+
+    /**
+     * @brief The increment of the level of each operator at each sample, so that it reaches its target at the end of the block.
+     * 
+     */
+    fxpt_Q0_31 m_level_steps[nb_operators];
+
+    /**
+     * @brief The envelope of an operator.
+     * 
+     * @param op The parameters of the operator.
+     * @param elapsed_fs The time elapsed since the beginning of the note.
+     * @return fxpt_Q16_15 The level between 0 and 1 included.
+     */
+    static fxpt_Q16_15 get_envelope(const FmOperator& op, unsigned int elapsed_fs)
+    {
+        constexpr fxpt_Q16_15 l_one = 1<<15;
+        if(elapsed_fs >= op.attack_fs + op.decay_fs)
+        {
+            return op.sustain;
+        }
+        else if(elapsed_fs >= op.attack_fs)
+        {
+            return l_one + fxpt_convert_n((op.sustain - l_one) * (fxpt_Q16_15)fxpt_ratio_q15(elapsed_fs - op.attack_fs, op.decay_fs), 30, 15);
+        }
+        else
+        {
+            return fxpt_ratio_q15(elapsed_fs, op.attack_fs);
+        }
+    }
+
+    /**
+     * @brief Render a sample of one operator, and make its phase and level progress.
+     * 
+     * @param op The index of the operator.
+     * @param modulation The phase offset given by its modulators.
+     * @return fxpt_Q0_31 
+     */
+    inline fxpt_Q0_31 render_operator(unsigned int op, fxpt_UQ0_32 modulation)
+    {
+        // The 10 most significant bits of the phase index the sine period of fxpt_sin
+        const fxpt_Q0_31 l_sine = fxpt_sin((m_phases[op] + modulation) >> 22);
+        m_phases[op] += m_phase_increments[op];
+        // 16 bits product, a single multiplication
+        const fxpt_Q0_31 l_output = fxpt_convert_n(fxpt_convert_n(l_sine, 31, 15) * fxpt_convert_n(m_levels[op], 31, 15), 30, 31);
+        m_levels[op] += m_level_steps[op];
+        return l_output;
+    }
+
+    /**
+     * @brief Render a sample of the operators 1 to op, from the last one.
+     * 
+     * @tparam algorithm The algorithm of the voice.
+     * @tparam op The number of operators left to render.
+     * @param modulations The phase offset of each operator, accumulated by its modulators.
+     * @return fxpt_Q0_31 The mix of the carriers among the rendered operators.
+     */
+    template<FmAlgorithm algorithm, unsigned int op>
+    inline fxpt_Q0_31 render_operators(fxpt_UQ0_32* modulations, std::integral_constant<unsigned int, op>)
+    {
+        constexpr unsigned int l_target = fm_get_target(algorithm, nb_operators, op - 1);
+        const fxpt_Q0_31 l_output = render_operator(op - 1, modulations[op - 1]);
+        fxpt_Q0_31 l_carrier = 0;
+        // The target being known at compile time, only one branch remains
+        if(l_target == nb_operators)
+        {
+            // Carriers are scaled down so that their mix cannot overflow
+            l_carrier = l_output / (fxpt_Q0_31)fm_get_nb_carriers(algorithm, nb_operators);
+        }
+        else
+        {
+            // The phase wraps around, so that several modulators can be summed without overflow
+            modulations[l_target < nb_operators ? l_target : 0] += (fxpt_UQ0_32)l_output << FM_MODULATION_SHIFT;
+        }
+        return l_carrier + render_operators<algorithm>(modulations, std::integral_constant<unsigned int, op - 1>());
+    }
+
+    template<FmAlgorithm algorithm>
+    inline fxpt_Q0_31 render_operators(fxpt_UQ0_32* /*modulations*/, std::integral_constant<unsigned int, 0>)
+    {
+        return 0;
+    }
+
+    /**
+     * @brief Render a block of samples with a given algorithm.
+     * 
+     * @tparam algorithm The algorithm of the voice.
+     * @param samples The samples to write.
+     * @param nb_samples The number of samples to write.
+     */
+    template<FmAlgorithm algorithm>
+    void render_samples(fxpt_Q0_31* samples, unsigned int nb_samples)
+    {
+        for(unsigned int i = 0; i < nb_samples; ++i)
+        {
+            fxpt_UQ0_32 l_modulations[nb_operators] = {0};
+            samples[i] = render_operators<algorithm>(l_modulations, std::integral_constant<unsigned int, nb_operators>());
+        }
+    }
+
+public:
+
+    /**
+     * @brief The number of operators of the voice.
+     * 
+     */
+    static constexpr unsigned int NB_OPERATORS = nb_operators;
+
+    /**
+     * @brief FmVoice constructor, the voice is silent.
+     * 
+     */
+    FmVoice()
+    {
+        for(unsigned int i = 0; i < nb_operators; ++i)
+        {
+            m_phases[i] = 0;
+            m_phase_increments[i] = 0;
+            m_levels[i] = 0;
+            m_level_steps[i] = 0;
+        }
+    }
+
+    /**
+     * @brief Set the frequency of the operators, to be called once per block.
+     * 
+     * @param phase_increment The phase increment of the note, a full period being 2^32.
+     * @param patch The parameters of the voice.
+     */
+    void set_phase_increment(fxpt_UQ0_32 phase_increment, const FmPatch& patch)
+    {
+        for(unsigned int i = 0; i < nb_operators; ++i)
+        {
+            m_phase_increments[i] = fxpt_convert_n((uint64_t)phase_increment * patch.operators[i].ratio, 16, 0);
+        }
+    }
+
+    /**
+     * @brief Render the next block of samples.
+     * The envelope of each operator is evaluated once per block and interpolated along the block.
+     * @param patch The parameters of the voice.
+     * @param elapsed_fs The time elapsed since the beginning of the note, at the beginning of the block.
+     * @param samples The samples to write.
+     * @param nb_samples The number of samples to write.
+     */
+    void render_block(const FmPatch& patch, unsigned int elapsed_fs, fxpt_Q0_31* samples, unsigned int nb_samples)
+    {
+        for(unsigned int i = 0; i < nb_operators; ++i)
+        {
+            const FmOperator& l_op = patch.operators[i];
+            const fxpt_Q0_31 l_level_target = fxpt_convert_n(
+                fxpt_convert_n(l_op.level, 31, 15) * get_envelope(l_op, elapsed_fs + nb_samples), 30, 31
+            );
+            m_level_steps[i] = (l_level_target - m_levels[i]) / (fxpt_Q0_31)nb_samples;
+        }
+
+        switch(patch.algorithm)
+        {
+            case FM_ALGORITHM_STACK:
+                render_samples<FM_ALGORITHM_STACK>(samples, nb_samples);
+                break;
+            case FM_ALGORITHM_PAIRS:
+                render_samples<FM_ALGORITHM_PAIRS>(samples, nb_samples);
+                break;
+            case FM_ALGORITHM_BRANCH:
+                render_samples<FM_ALGORITHM_BRANCH>(samples, nb_samples);
+                break;
+            default:
+                render_samples<FM_ALGORITHM_ADDITIVE>(samples, nb_samples);
+                break;
+        }
+    }
+};
+
+#endif //SYNTHPATHY_FMVOICE_HPP_
\ No newline at end of file
@@ -0,0 +1,237 @@
+/**
+ * Synthpathy is a small and versatile audio synthesizer on a microcontroler. 
+ * Copyright (C) 2022  Brice Croix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SYNTHPATHY_HALFBANDDECIMATOR_HPP_
+#define SYNTHPATHY_HALFBANDDECIMATOR_HPP_
+
+#include "global.h"
+#include "fxpt.h"
+
+#include <limits>
+
+/**
+ * @brief The coefficients of the short half-band filter, in Q0.31, for the first stage of a decimation by 4.
+ * Its transition band is wide since the second stage removes what it lets through : 11 taps, -49dB above 0.41 of the input rate.
+ */
+constexpr fxpt_Q0_31 HALF_BAND_COEFFICIENTS_SHORT[3] = {626680948, -94845208, 5035172};
+
+/**
+ * @brief The coefficients of the long half-band filter, in Q0.31, for the last stage of any decimation.
+ * 31 taps : flat up to 0.18 of the input rate, -62dB above 0.32, designed with a Kaiser window (beta = 6).
+ */
+constexpr fxpt_Q0_31 HALF_BAND_COEFFICIENTS_LONG[8] = {675221661, -204000237, 100049234, -52078813, 25746314, -11185672, 3796148, -677723};
+
+/**
+ * @brief Decimation by 2 with a half-band FIR filter, in its polyphase form.
+ * Every other coefficient of a half-band filter is null except the center one, which is 0.5 :
+ * only the odd phase is filtered, symmetric samples being added before their multiplication,
+ * so that an output sample costs nb_coefficients multiplications for 4 * nb_coefficients - 1 taps.
+ * The coefficients on each side of the center are given from the nearest one, their sum being 0.25 so that the gain is 1.
+ * 
+ * @tparam nb_coefficients The number of distinct non-null coefficients, besides the center one.
+ */
+template<unsigned int nb_coefficients>
+class HalfBandDecimator
+{
+public:
+
+    /**
+     * @brief The number of taps of the filter, including the null ones.
+     * 
+     */
+    static constexpr unsigned int NB_TAPS = 4 * nb_coefficients - 1;
+
+protected:
+
+    /**
+     * @brief The number of past input samples needed by the next output sample.
+     * 
+     */
+    static constexpr unsigned int SIZE_HISTORY = NB_TAPS - 1;
+
+    /**
+     * @brief The coefficients of the odd phase, from the center outwards.
+     * 
+     */
+    const fxpt_Q0_31* m_coefficients;
+
+    /**
+     * @brief The past input samples, followed by the chunk of input being decimated.
+     * 
+     */
+    fxpt_Q0_31 m_buffer[SIZE_HISTORY + 2 * SIZE_AUDIO_BLOCK];
+
+public:
+
+    /**
+     * @brief HalfBandDecimator constructor, the past input is silence.
+     * 
+     * @param coefficients The nb_coefficients coefficients of the odd phase, from the center outwards.
+     */
+    HalfBandDecimator(const fxpt_Q0_31* coefficients) : m_coefficients(coefficients)
+    {
+        for(unsigned int i = 0; i < SIZE_HISTORY; ++i)
+        {
+            m_buffer[i] = 0;
+        }
+    }
+
+    /**
+     * @brief Filter and decimate a block of samples.
+     * 
+     * @param input The 2 * nb_output samples to decimate.
+     * @param output The nb_output decimated samples to write.
+     * @param nb_output The number of samples to output.
+     */
+    void process_block(const fxpt_Q0_31* input, fxpt_Q0_31* output, unsigned int nb_output)
+    {
+        constexpr fxpt64_t l_max = std::numeric_limits<fxpt_Q0_31>::max();
+        constexpr fxpt64_t l_min = std::numeric_limits<fxpt_Q0_31>::min();
+
+        // The input is processed by chunks of at most two audio blocks, after the history
+        while(nb_output > 0)
+        {
+            const unsigned int l_nb_output = (nb_output < SIZE_AUDIO_BLOCK) ? nb_output : SIZE_AUDIO_BLOCK;
+            for(unsigned int i = 0; i < 2 * l_nb_output; ++i)
+            {
+                m_buffer[SIZE_HISTORY + i] = input[i];
+            }
+
+            for(unsigned int i = 0; i < l_nb_output; ++i)
+            {
+                // The window of the output ends with the odd input sample, its center is an even one
+                const fxpt_Q0_31* l_center = &m_buffer[2 * i + 2 * nb_coefficients];
+                fxpt64_t l_sum = (fxpt64_t)l_center[0] << 30;
+                for(unsigned int k = 0; k < nb_coefficients; ++k)
+                {
+                    l_sum += (fxpt64_t)m_coefficients[k] * ((fxpt64_t)l_center[-(int)(2 * k + 1)] + (fxpt64_t)l_center[2 * k + 1]);
+                }
+                // The ripple of the filter may overshoot full scale
+                l_sum = fxpt_convert_n(l_sum, 31, 0);
+                output[i] = (l_sum > l_max) ? l_max : ((l_sum < l_min) ? l_min : l_sum);
+            }
+
+            // The end of the chunk becomes the history of the next one
+            for(unsigned int i = 0; i < SIZE_HISTORY; ++i)
+            {
+                m_buffer[i] = m_buffer[2 * l_nb_output + i];
+            }
+            input += 2 * l_nb_output;
+            output += l_nb_output;
+            nb_output -= l_nb_output;
+        }
+    }
+};
+
+/**
+ * @brief Decimation by a power of two, in cascaded half-band stages.
+ * 
+ * @tparam factor The decimation factor, 2 or 4.
+ */
+template<unsigned int factor>
+class Decimator;
+
+/**
+ * @brief Decimation by 2, with the long half-band filter.
+ * 
+ */
+template<>
+class Decimator<2>
+{
+protected:
+
+    /**
+     * @brief The single stage.
+     * 
+     */
+    HalfBandDecimator<8> m_stage;
+
+public:
+
+    /**
+     * @brief Decimator constructor.
+     * 
+     */
+    Decimator() : m_stage(HALF_BAND_COEFFICIENTS_LONG) {}
+
+    /**
+     * @brief Filter and decimate a block of samples.
+     * 
+     * @param input The 2 * nb_output samples to decimate.
+     * @param output The nb_output decimated samples to write.
+     * @param nb_output The number of samples to output.
+     */
+    inline void process_block(const fxpt_Q0_31* input, fxpt_Q0_31* output, unsigned int nb_output)
+    {
+        m_stage.process_block(input, output, nb_output);
+    }
+};
+
+/**
+ * @brief Decimation by 4, with the short half-band filter followed by the long one.
+ * The first stage runs at the highest rate, but only has to remove what would fold into the band of the second one.
+ */
+template<>
+class Decimator<4>
+{
+protected:
+
+    /**
+     * @brief The first stage, from 4 to 2 times the output rate.
+     * 
+     */
+    HalfBandDecimator<3> m_first_stage;
+
+    /**
+     * @brief The last stage, from 2 times the output rate.
+     * 
+     */
+    HalfBandDecimator<8> m_last_stage;
+
+public:
+
+    /**
+     * @brief Decimator constructor.
+     * 
+     */
+    Decimator() : m_first_stage(HALF_BAND_COEFFICIENTS_SHORT), m_last_stage(HALF_BAND_COEFFICIENTS_LONG) {}
+
+    /**
+     * @brief Filter and decimate a block of samples.
+     * 
+     * @param input The 4 * nb_output samples to decimate.
+     * @param output The nb_output decimated samples to write.
+     * @param nb_output The number of samples to output.
+     */
+    void process_block(const fxpt_Q0_31* input, fxpt_Q0_31* output, unsigned int nb_output)
+    {
+        // The intermediate rate is processed by chunks of one audio block
+        fxpt_Q0_31 l_half[2 * SIZE_AUDIO_BLOCK];
+        while(nb_output > 0)
+        {
+            const unsigned int l_nb_output = (nb_output < SIZE_AUDIO_BLOCK) ? nb_output : SIZE_AUDIO_BLOCK;
+            m_first_stage.process_block(input, l_half, 2 * l_nb_output);
+            m_last_stage.process_block(l_half, output, l_nb_output);
+            input += 4 * l_nb_output;
+            output += l_nb_output;
+            nb_output -= l_nb_output;
+        }
+    }
+};
+
+#endif //SYNTHPATHY_HALFBANDDECIMATOR_HPP_
\ No newline at end of file
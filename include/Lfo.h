@@ -0,0 +1,122 @@
+/**
+ * Synthpathy is a small and versatile audio synthesizer on a microcontroler. 
+ * Copyright (C) 2022  Brice Croix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SYNTHPATHY_LFO_H_
+#define SYNTHPATHY_LFO_H_
+
+#include "global.h"
+#include "fxpt.h"
+#include "NoiseGenerator.h"
+
+/**
+ * @brief The waveform of a Low Frequency Oscillator.
+ * 
+ */
+enum LfoShape
+{
+    LFO_SINE,
+    LFO_TRIANGLE,
+    LFO_SAW,
+    LFO_SAMPLE_AND_HOLD
+};
+
+/**
+ * @brief Fixed-point Low Frequency Oscillator, updated at control rate.
+ * Its phase is a 32 bits accumulator wrapping once per period.
+ */
+class Lfo
+{
+protected:
+
+    /**
+     * @brief The waveform of the oscillator.
+     * 
+     */
+    LfoShape m_shape;
+
+    /**
+     * @brief The phase of the oscillator, a full period being 2^32.
+     * 
+     */
+    fxpt_UQ0_32 m_phase;
+
+    /**
+     * @brief The phase increment at each update.
+     * 
+     */
+    fxpt_UQ0_32 m_phase_increment;
+
+    /**
+     * @brief The current output value of the oscillator between -1 and 1.
+     * 
+     */
+    fxpt_Q0_31 m_value;
+
+    /**
+     * @brief The pseudo-random generator used by the sample-and-hold waveform.
+     * 
+     */
+    NoiseGenerator m_noise;
+
+public:
+
+    /**
+     * @brief Lfo constructor.
+     * 
+     * @param shape The waveform of the oscillator.
+     * @param frequency The frequency of the oscillator in Hertz.
+     * @param seed The seed of the sample-and-hold random values.
+     */
+    Lfo(LfoShape shape = LFO_SINE, fxpt_UQ16_16 frequency = fxpt_from_float(1.f, 16), uint32_t seed = NOISE_DEFAULT_SEED);
+
+    /**
+     * @brief Set the waveform of the oscillator.
+     * 
+     * @param shape 
+     */
+    inline void set_shape(LfoShape shape) { m_shape = shape; }
+
+    /**
+     * @brief Set the frequency of the oscillator.
+     * 
+     * @param frequency The frequency in Hertz, lower than CONTROL_RATE_HZ / 2.
+     */
+    void set_frequency(fxpt_UQ16_16 frequency);
+
+    /**
+     * @brief Restart the oscillator at the beginning of its period.
+     * 
+     */
+    inline void reset() { m_phase = 0; }
+
+    /**
+     * @brief Make the oscillator progress of one control period.
+     * 
+     * @return fxpt_Q0_31 The new output value.
+     */
+    fxpt_Q0_31 update();
+
+    /**
+     * @brief Get the current output value, between -1 and 1.
+     * 
+     * @return fxpt_Q0_31 
+     */
+    inline fxpt_Q0_31 get_value() const { return m_value; }
+};
+
+#endif //SYNTHPATHY_LFO_H_
\ No newline at end of file
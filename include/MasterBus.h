@@ -0,0 +1,127 @@
+/**
+ * Synthpathy is a small and versatile audio synthesizer on a microcontroler. 
+ * Copyright (C) 2022  Brice Croix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SYNTHPATHY_MASTERBUS_H_
+#define SYNTHPATHY_MASTERBUS_H_
+
+#include "global.h"
+#include "fxpt.h"
+#include "limiter_curve.h"
+
+/**
+ * @brief The last stage of the mix of all notes, before the effects.
+ * It applies a master gain to the sum of the notes, then a peak limiter without look-ahead,
+ * so that a single note can reach full scale while chords are compressed instead of clipped.
+ * A peak follower with an instant attack reduces the gain as soon as the level exceeds full scale,
+ * the gain coming back within a few tens of milliseconds. The levels are then below full scale,
+ * the top of the signal above LIMITER_THRESHOLD being rounded by a soft knee.
+ */
+class MasterBus
+{
+public:
+
+    /**
+     * @brief The maximum master gain, 16 in UQ16.16.
+     * 
+     */
+    static constexpr fxpt_UQ16_16 GAIN_MAX = 16<<16;
+
+    /**
+     * @brief The number of calls to process for each frame, the channels and the sub-samples sharing the envelope.
+     * 
+     */
+    static constexpr unsigned int NB_CALLS_PER_FRAME = NB_AUDIO_CHANNELS * OVERSAMPLING_FACTOR;
+
+    /**
+     * @brief The shift of the release of the envelope, its time constant being 2^11 frames, about 44ms at 46875Hz.
+     * 
+     */
+    static constexpr unsigned int RELEASE_SHIFT = 11 +
+        ((NB_CALLS_PER_FRAME >= 8) ? 3 : ((NB_CALLS_PER_FRAME >= 4) ? 2 : ((NB_CALLS_PER_FRAME >= 2) ? 1 : 0)));
+
+protected:
+
+    /**
+     * @brief The gain applied to the mix, between 0 and GAIN_MAX.
+     * 
+     */
+    fxpt_UQ16_16 m_gain;
+
+    /**
+     * @brief The envelope of the absolute level after the master gain, with 31 bits of decimal part.
+     * 
+     */
+    fxpt64_t m_envelope;
+
+    /**
+     * @brief Reduce the gain if the envelope is above full scale, then round the top with the knee of the limiter.
+     * 
+     * @param level The level with 31 bits of decimal part, at most the envelope in absolute value.
+     * @return fxpt_Q0_31 
+     */
+    fxpt_Q0_31 limit(fxpt64_t level) const;
+
+public:
+
+    /**
+     * @brief MasterBus constructor.
+     * 
+     * @param gain The master gain, 1 by default.
+     */
+    MasterBus(fxpt_UQ16_16 gain = 1<<16);
+
+    /**
+     * @brief Set the master gain, to be called between two audio blocks.
+     * 
+     * @param gain The gain, saturated to GAIN_MAX.
+     */
+    inline void set_gain(fxpt_UQ16_16 gain) { m_gain = (gain > GAIN_MAX) ? GAIN_MAX : gain; }
+
+    /**
+     * @brief Get the master gain.
+     * 
+     * @return fxpt_UQ16_16 
+     */
+    inline fxpt_UQ16_16 get_gain() const { return m_gain; }
+
+    /**
+     * @brief Apply the master gain and the limiter to the mix of the notes.
+     * 
+     * @param mix The sum of the Q0.31 outputs of the notes, hence with 31 bits of decimal part.
+     * @return fxpt_Q0_31 
+     */
+    inline fxpt_Q0_31 process(fxpt64_t mix)
+    {
+        const fxpt64_t l_level = fxpt_convert_n(mix * m_gain, 16, 0);
+        const fxpt64_t l_abs_level = (l_level < 0) ? -l_level : l_level;
+        // Instant attack, exponential release
+        m_envelope -= m_envelope >> RELEASE_SHIFT;
+        if(l_abs_level > m_envelope)
+        {
+            m_envelope = l_abs_level;
+        }
+        // Most samples are below the threshold without gain reduction, and left untouched
+        if(l_abs_level <= LIMITER_THRESHOLD && m_envelope <= (fxpt64_t(1) << 31))
+        {
+            return l_level;
+        }
+        return limit(l_level);
+    }
+};
+
+#endif //SYNTHPATHY_MASTERBUS_H_
\ No newline at end of file
@@ -0,0 +1,159 @@
+/**
+ * Synthpathy is a small and versatile audio synthesizer on a microcontroler. 
+ * Copyright (C) 2022  Brice Croix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SYNTHPATHY_MODULATIONMATRIX_H_
+#define SYNTHPATHY_MODULATIONMATRIX_H_
+
+#include "fxpt.h"
+
+/**
+ * @brief The signals that can modulate a parameter, all between -1 and 1.
+ * 
+ */
+enum ModulationSource
+{
+    MODULATION_SOURCE_LFO1,
+    MODULATION_SOURCE_LFO2,
+    MODULATION_SOURCE_ENVELOPE,
+    MODULATION_SOURCE_VELOCITY,
+    MODULATION_SOURCE_AFTERTOUCH,
+    NB_MODULATION_SOURCES
+};
+
+/**
+ * @brief The parameters that can be modulated.
+ * Each modulation is between -1 and 1, its effect depends on the parameter :
+ * - pitch : +/- MODULATION_PITCH_RANGE_SEMITONES semitones.
+ * - filter cutoff : +/- MODULATION_FILTER_CUTOFF_RANGE_OCTAVES octaves.
+ * - texture : added to the texture parameter.
+ * - amplitude : added to the unit gain, a positive modulation having no effect.
+ */
+enum ModulationDestination
+{
+    MODULATION_DESTINATION_PITCH,
+    MODULATION_DESTINATION_FILTER_CUTOFF,
+    MODULATION_DESTINATION_TEXTURE,
+    MODULATION_DESTINATION_AMPLITUDE,
+    NB_MODULATION_DESTINATIONS
+};
+
+/**
+ * @brief The pitch shift obtained with a full modulation, in semitones.
+ * 
+ */
+constexpr unsigned int MODULATION_PITCH_RANGE_SEMITONES = 12;
+
+/**
+ * @brief The cutoff frequency shift obtained with a full modulation, in octaves.
+ * 
+ */
+constexpr unsigned int MODULATION_FILTER_CUTOFF_RANGE_OCTAVES = 4;
+
+/**
+ * @brief A connection between a modulation source and a modulated parameter.
+ * 
+ */
+struct ModulationRoute
+{
+    ModulationSource source;
+    ModulationDestination destination;
+    /**
+     * @brief The amount of modulation between -2 and 2.
+     * 
+     */
+    fxpt_Q1_30 amount;
+};
+
+/**
+ * @brief Routes modulation sources to modulated parameters.
+ * It is meant to be evaluated once per audio block, so that modulation has a fixed cost
+ * of one multiplication per route and per block.
+ */
+class ModulationMatrix
+{
+protected:
+
+    /**
+     * @brief The maximum number of routes.
+     * 
+     */
+    static constexpr unsigned int NB_MODULATION_ROUTES_MAX = 8;
+
+    /**
+     * @brief The routes of the matrix.
+     * 
+     */
+    ModulationRoute m_routes[NB_MODULATION_ROUTES_MAX];
+
+    /**
+     * @brief The number of routes in use.
+     * 
+     */
+    unsigned int m_nb_routes;
+
+public:
+
+    /**
+     * @brief ModulationMatrix constructor, without any route.
+     * 
+     */
+    ModulationMatrix();
+
+    /**
+     * @brief Add a route to the matrix.
+     * 
+     * @param source The modulation source.
+     * @param destination The modulated parameter.
+     * @param amount The amount of modulation between -2 and 2.
+     * @return true if the route was added.
+     * @return false if the matrix is full.
+     */
+    bool add_route(ModulationSource source, ModulationDestination destination, fxpt_Q1_30 amount);
+
+    /**
+     * @brief Remove all routes.
+     * 
+     */
+    inline void clear() { m_nb_routes = 0; }
+
+    /**
+     * @brief Get the number of routes in use.
+     * 
+     * @return unsigned int 
+     */
+    inline unsigned int get_nb_routes() const { return m_nb_routes; }
+
+    /**
+     * @brief Indicates whether at least one route modulates the given parameter.
+     * 
+     * @param destination 
+     * @return true 
+     * @return false 
+     */
+    bool is_modulated(ModulationDestination destination) const;
+
+    /**
+     * @brief Compute the modulation of each parameter.
+     * 
+     * @param sources The value of each source, between -1 and 1.
+     * @param destinations Output, the modulation of each parameter, saturated between -1 and 1.
+     */
+    void evaluate(const fxpt_Q0_31 sources[NB_MODULATION_SOURCES], fxpt_Q0_31 destinations[NB_MODULATION_DESTINATIONS]) const;
+};
+
+#endif //SYNTHPATHY_MODULATIONMATRIX_H_
\ No newline at end of file
@@ -0,0 +1,140 @@
+/**
+ * Synthpathy is a small and versatile audio synthesizer on a microcontroler. 
+ * Copyright (C) 2022  Brice Croix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SYNTHPATHY_NOISEGENERATOR_H_
+#define SYNTHPATHY_NOISEGENERATOR_H_
+
+#include "fxpt.h"
+
+/**
+ * @brief The spectrum of the noise produced by a NoiseGenerator.
+ * 
+ */
+enum NoiseColor
+{
+    /**
+     * @brief Flat spectrum, one xorshift per sample.
+     * 
+     */
+    NOISE_WHITE,
+
+    /**
+     * @brief -3dB per octave, white noise filtered by three one-pole filters (Paul Kellet's economy filter).
+     * 
+     */
+    NOISE_PINK,
+
+    /**
+     * @brief -6dB per octave above about 100Hz, white noise filtered by a leaky integrator.
+     * 
+     */
+    NOISE_BROWN
+};
+
+/**
+ * @brief The seed used when none is given, or when the given one is null.
+ * 
+ */
+constexpr uint32_t NOISE_DEFAULT_SEED = 0x12345678;
+
+/**
+ * @brief Pseudo-random noise generator based on a 32 bits xorshift, filling whole blocks of samples.
+ * The sequence only depends on the seed, so that renders are reproducible.
+ */
+class NoiseGenerator
+{
+protected:
+
+    /**
+     * @brief The state of the xorshift generator, never null.
+     * 
+     */
+    uint32_t m_state;
+
+    /**
+     * @brief The spectrum of the generated noise.
+     * 
+     */
+    NoiseColor m_color;
+
+    /**
+     * @brief The states of the pink noise filters, in Q3.28.
+     * 
+     */
+    fxpt_Q3_28 m_pink_states[3];
+
+    /**
+     * @brief The state of the brown noise leaky integrator.
+     * 
+     */
+    fxpt_Q0_31 m_brown_state;
+
+public:
+
+    /**
+     * @brief NoiseGenerator constructor.
+     * 
+     * @param color The spectrum of the generated noise.
+     * @param seed The initial state of the generator, a null seed being replaced by NOISE_DEFAULT_SEED.
+     */
+    NoiseGenerator(NoiseColor color = NOISE_WHITE, uint32_t seed = NOISE_DEFAULT_SEED);
+
+    /**
+     * @brief Restart the sequence from the given seed, and reset the filters.
+     * 
+     * @param seed A null seed is replaced by NOISE_DEFAULT_SEED.
+     */
+    void seed(uint32_t seed);
+
+    /**
+     * @brief Set the spectrum of the generated noise.
+     * 
+     * @param color 
+     */
+    inline void set_color(NoiseColor color) { m_color = color; }
+
+    /**
+     * @brief Get the spectrum of the generated noise.
+     * 
+     * @return NoiseColor 
+     */
+    inline NoiseColor get_color() const { return m_color; }
+
+    /**
+     * @brief Draw the next white noise value, whatever the color of the generator.
+     * 
+     * @return fxpt_Q0_31 A value uniformly distributed between -1 and 1.
+     */
+    inline fxpt_Q0_31 next_white()
+    {
+        m_state ^= m_state << 13;
+        m_state ^= m_state >> 17;
+        m_state ^= m_state << 5;
+        return m_state;
+    }
+
+    /**
+     * @brief Fill a block of samples with noise of the generator color.
+     * 
+     * @param samples The samples to write.
+     * @param nb_samples The number of samples in the block.
+     */
+    void fill_block(fxpt_Q0_31* samples, unsigned int nb_samples);
+};
+
+#endif //SYNTHPATHY_NOISEGENERATOR_H_
\ No newline at end of file
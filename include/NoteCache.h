@@ -0,0 +1,162 @@
+/**
+ * Synthpathy is a small and versatile audio synthesizer on a microcontroler. 
+ * Copyright (C) 2022  Brice Croix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SYNTHPATHY_NOTECACHE_H_
+#define SYNTHPATHY_NOTECACHE_H_
+
+#include "global.h"
+#include "fxpt.h"
+#include "midi.h"
+
+/**
+ * @brief The entry returned by NoteCache when a note can neither be streamed nor recorded.
+ * 
+ */
+constexpr int NOTE_CACHE_NO_ENTRY = -1;
+
+/**
+ * @brief A cache of the beginning of the notes of a static patch : the first note of each midi note records its
+ * attack and decay while it is synthesized, the following ones stream them back instead of synthesizing them again.
+ * The frames are stored enveloped but without velocity, so that any velocity shares the same entry.
+ * An entry is only valid for the patch it was recorded with, see Controls::get_patch_version,
+ * the notes switching to live synthesis as soon as they are modulated or released.
+ */
+class NoteCache
+{
+public:
+
+    /**
+     * @brief The number of frames of each entry, a multiple of SIZE_AUDIO_BLOCK.
+     * 
+     */
+    static constexpr unsigned int ENTRY_SIZE = (NOTE_CACHE_MEMORY_BUDGET_BYTES / NOTE_CACHE_NB_ENTRIES / sizeof(fxpt_Q0_15))
+        & ~(SIZE_AUDIO_BLOCK - 1);
+
+protected:
+
+    static_assert(ENTRY_SIZE > 0, "Each entry of the note cache must hold at least one audio block");
+
+    /**
+     * @brief The enveloped frames of each entry.
+     * 
+     */
+    fxpt_Q0_15 m_frames[NOTE_CACHE_NB_ENTRIES][ENTRY_SIZE];
+
+    /**
+     * @brief The midi note of each entry.
+     * 
+     */
+    MidiByte m_midi_notes[NOTE_CACHE_NB_ENTRIES];
+
+    /**
+     * @brief The number of frames of each entry, 0 while it is being recorded or if it is empty.
+     * 
+     */
+    unsigned int m_lengths[NOTE_CACHE_NB_ENTRIES];
+
+    /**
+     * @brief The patch version each entry was recorded with.
+     * 
+     */
+    unsigned int m_patch_versions[NOTE_CACHE_NB_ENTRIES];
+
+    /**
+     * @brief The number of notes streaming or recording each entry, which cannot be replaced until it is 0.
+     * 
+     */
+    unsigned int m_nb_users[NOTE_CACHE_NB_ENTRIES];
+
+    /**
+     * @brief The last time each entry was lent, in number of periods of the audio sampling frequency.
+     * 
+     */
+    unsigned int m_times_used_fs[NOTE_CACHE_NB_ENTRIES];
+
+    /**
+     * @brief The current patch version, the entries recorded with another one being stale.
+     * 
+     */
+    unsigned int m_patch_version;
+
+public:
+
+    /**
+     * @brief NoteCache constructor, all entries are empty.
+     * 
+     */
+    NoteCache();
+
+    /**
+     * @brief Set the current patch version, the entries recorded with another version are not streamed anymore.
+     * 
+     * @param patch_version See Controls::get_patch_version.
+     */
+    inline void set_patch_version(unsigned int patch_version) { m_patch_version = patch_version; }
+
+    /**
+     * @brief Indicates whether an entry was recorded with the current patch version.
+     * 
+     * @param entry The index given by find or record.
+     */
+    inline bool is_current(int entry) const { return m_patch_versions[entry] == m_patch_version; }
+
+    /**
+     * @brief Lend the entry recorded for a midi note with the current patch, in order to stream it.
+     * 
+     * @param midi_note The midi note to play.
+     * @param time_fs The time in number of periods of the audio sampling frequency.
+     * @return int The index of the entry, or NOTE_CACHE_NO_ENTRY if it was not recorded.
+     */
+    int find(MidiByte midi_note, unsigned int time_fs);
+
+    /**
+     * @brief Lend an entry to be recorded for a midi note, replacing a stale or the least recently used entry.
+     * Only one note records a given midi note at once.
+     * @param midi_note The midi note to record.
+     * @param time_fs The time in number of periods of the audio sampling frequency.
+     * @return int The index of the entry, or NOTE_CACHE_NO_ENTRY if all entries are in use.
+     */
+    int record(MidiByte midi_note, unsigned int time_fs);
+
+    /**
+     * @brief Give an entry back to the cache.
+     * 
+     * @param entry The index given by find or record, NOTE_CACHE_NO_ENTRY being ignored.
+     * @param nb_recorded_frames The number of frames recorded in the entry, 0 if it was streamed or if
+     * the recording was interrupted.
+     */
+    void release(int entry, unsigned int nb_recorded_frames);
+
+    /**
+     * @brief The frames of an entry.
+     * 
+     * @param entry The index given by find or record.
+     * @return fxpt_Q0_15* 
+     */
+    inline fxpt_Q0_15* get_frames(int entry) { return m_frames[entry]; }
+
+    /**
+     * @brief The number of frames of an entry.
+     * 
+     * @param entry The index given by find.
+     * @return unsigned int 0 if the entry was not recorded.
+     */
+    inline unsigned int get_length(int entry) const { return m_lengths[entry]; }
+};
+
+#endif //SYNTHPATHY_NOTECACHE_H_
\ No newline at end of file
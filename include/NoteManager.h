@@ -20,6 +20,10 @@
 #define SYNTHPATHY_NOTEMANAGER_H_
 
 #include "ActiveNote.h"
+#include "MasterBus.h"
+#include "SampleBank.h"
+#include "NoteCache.h"
+#include "HalfBandDecimator.hpp"
 
 /**
  * @brief This classes manages the notes that are currently active.
@@ -40,16 +44,114 @@ protected:
     // Private constants
 
     /**
-     * @brief The maximum number of notes that can be active at the same time.
+     * @brief The maximum number of notes that can be active at the same time, see EngineConfig.
      * 
      */
-    static constexpr unsigned int NB_ACTIVE_NOTES = 4;
+    static constexpr unsigned int NB_ACTIVE_NOTES = ENGINE_CONFIG.nb_active_notes;
+
+    /**
+     * @brief The pitch shift obtained with the pitch bend wheel at its end, in semitones.
+     * 
+     */
+    static constexpr unsigned int PITCH_BEND_RANGE_SEMITONES = 2;
 
 
     // Private members -----------------------------------------------------------------------------
 
     ActiveNote m_active_notes_pool[NB_ACTIVE_NOTES];
 
+    /**
+     * @brief The pitch bend in semitones.
+     * 
+     */
+    fxpt_Q15_16 m_pitch_bend;
+
+    /**
+     * @brief The channel aftertouch between 0 and 1.
+     * 
+     */
+    fxpt_Q0_31 m_aftertouch;
+
+    /**
+     * @brief The modulation of the parameters shared by all notes, such as the filter cutoff.
+     * These follow the most recent note.
+     */
+    fxpt_Q0_31 m_global_modulations[NB_MODULATION_DESTINATIONS];
+
+    /**
+     * @brief The gain and limiter applied to the sum of the notes.
+     * 
+     */
+    MasterBus m_master_bus;
+
+    #ifdef AUDIO_OVERSAMPLING
+    /**
+     * @brief The mix of the notes of the current block at the oversampled rate, for each channel, before decimation.
+     * 
+     */
+    fxpt_Q0_31 m_oversampled_mix[NB_AUDIO_CHANNELS][SIZE_AUDIO_BLOCK * OVERSAMPLING_FACTOR];
+
+    /**
+     * @brief The decimation of the mix of each channel back to the audio sampling frequency.
+     * 
+     */
+    Decimator<OVERSAMPLING_FACTOR> m_decimators[NB_AUDIO_CHANNELS];
+    #endif
+
+    /**
+     * @brief The delay lines of the plucked strings, one per note at most, lent on note on and given back when the note dies.
+     */
+    DelayArena<NB_ACTIVE_NOTES, PLUCK_DELAY_LINE_SIZE> m_pluck_arena;
+
+    /**
+     * @brief The samples played by the notes, read in place in flash at SAMPLE_BANK_FLASH_OFFSET.
+     */
+    SampleBank m_sample_bank;
+
+    /**
+     * @brief The attacks and decays of the notes of a static patch, recorded by the first note of each midi note.
+     */
+    NoteCache m_note_cache;
+
+    /**
+     * @brief Indicates whether the attacks and decays of the current patch can be cached : the notes must only play
+     * the waveform, without pitch bend, and in stereo without unison since its stereo side is not cached.
+     * The cache is never used when the voice bus is oversampled, since it only keeps the samples at the audio sampling frequency.
+     */
+    bool is_patch_cacheable() const;
+
+    /**
+     * @brief Make a note stop streaming or recording the cache, and give its entry back.
+     * 
+     * @param note The note, which may have no entry.
+     * @param time_fs The time of the beginning of the block, in number of periods of the audio sampling frequency.
+     */
+    void detach_cache(ActiveNote& note, unsigned int time_fs);
+
+    /**
+     * @brief Add a sample of a note to the left and right mixes, spread by its stereo side then panned by the gains of the note.
+     * The side is subtracted from the left channel and added to the right one before the panning, so that a note
+     * panned to one side is only heard there.
+     * @param note The note.
+     * @param value The sample of the note.
+     * @param side The stereo side of the note, see ActiveNote::get_unison_side.
+     * @param left The left mix.
+     * @param right The right mix.
+     */
+    inline void mix_panned(const ActiveNote& note, fxpt_Q0_31 value, fxpt_Q0_31 side, fxpt64_t& left, fxpt64_t& right) const
+    {
+        // Panning costs two multiplications per note
+        #ifdef AUDIO_Q15
+        // The differences need 17 bits, their products with the positive 16 bits gains still fit in 32 bits
+        const fxpt_Q16_15 l_value_q15 = (fxpt_Q16_15)fxpt_convert_n(value, 31, 15);
+        const fxpt_Q16_15 l_side_q15 = (fxpt_Q16_15)fxpt_convert_n(side, 31, 15);
+        left += fxpt_convert_n((l_value_q15 - l_side_q15) * fxpt_convert_n(note.get_pan_gain(0), 31, 15), 30, 31);
+        right += fxpt_convert_n((l_value_q15 + l_side_q15) * fxpt_convert_n(note.get_pan_gain(1), 31, 15), 30, 31);
+        #else
+        left += fxpt_convert_n(((fxpt64_t)value - (fxpt64_t)side) * note.get_pan_gain(0), 31, 0);
+        right += fxpt_convert_n(((fxpt64_t)value + (fxpt64_t)side) * note.get_pan_gain(1), 31, 0);
+        #endif
+    }
 
 public:
 
@@ -71,12 +173,58 @@ public:
     void update_active_notes(unsigned int time_fs);
 
     /**
-     * @brief Returns the sum of all active note audio output.
-     *
+     * @brief Evaluate the modulation matrix for each note and for the shared parameters, and update the notes pitch.
+     * Must be called once per audio block, at control rate, after Controls::update_parameters.
+     * @param time_fs The time in number of periods of the audio sampling frequency.
+     */
+    void update_modulation(unsigned int time_fs);
+
+    /**
+     * @brief Get the modulation of a parameter shared by all notes.
+     * 
+     * @param destination The modulated parameter.
+     * @return fxpt_Q0_31 The modulation between -1 and 1.
+     */
+    inline fxpt_Q0_31 get_global_modulation(ModulationDestination destination) const { return m_global_modulations[destination]; }
+
+    /**
+     * @brief Get the master bus in order to configure it.
+     * 
+     * @return MasterBus& 
+     */
+    inline MasterBus& get_master_bus() { return m_master_bus; }
+
+    /**
+     * @brief Returns the sum of all active note audio output, amplified and limited by the master bus.
+     * 
      * @param time_fs The time in number of periods of the audio sampling frequency.
      * @return fxpt_Q0_31 
      */
     fxpt_Q0_31 get_audio(unsigned int time_fs);
+
+    /**
+     * @brief Compute a stereo frame, each note being panned by its own gains, see ActiveNote::set_pan.
+     * 
+     * @param time_fs The time in number of periods of the audio sampling frequency.
+     * @param frame The left and right samples to write, in that order.
+     */
+    void get_audio_stereo(unsigned int time_fs, fxpt_Q0_31* frame);
+
+    /**
+     * @brief Compute the SIZE_AUDIO_BLOCK frames of the next audio block, channels being interleaved.
+     * When compiled with AUDIO_OVERSAMPLING the notes are mixed at OVERSAMPLING_FACTOR times the sampling frequency,
+     * and the mix of each channel is decimated once the whole block is rendered.
+     * @param time_fs The time of the beginning of the block, in number of periods of the audio sampling frequency.
+     * @param block The SIZE_AUDIO_BLOCK * NB_AUDIO_CHANNELS samples to write.
+     */
+    void get_audio_block(unsigned int time_fs, fxpt_Q0_31* block);
+
+    /**
+     * @brief The number of notes streaming their attack and decay from the note cache, the ones recording it excluded.
+     * 
+     * @return unsigned int 
+     */
+    unsigned int get_nb_cached_notes() const;
 };
 
 
@@ -0,0 +1,131 @@
+/**
+ * Synthpathy is a small and versatile audio synthesizer on a microcontroler. 
+ * Copyright (C) 2022  Brice Croix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SYNTHPATHY_PLUCKEDSTRING_H_
+#define SYNTHPATHY_PLUCKEDSTRING_H_
+
+#include "global.h"
+#include "fxpt.h"
+#include "NoiseGenerator.h"
+
+/**
+ * @brief A plucked string physical model (Karplus-Strong) : a noise burst circulates in a tuned delay line
+ * through a loss filter. The loop delay is the delay line, half a sample for the two-point loss filter
+ * and a first-order all-pass filter for the fractional part, so that high strings stay in tune.
+ * The delay line is not owned by the string, see DelayArena.
+ */
+class PluckedString
+{
+protected:
+
+    /**
+     * @brief The mask applied on indices to wrap around the delay line.
+     * 
+     */
+    static constexpr unsigned int IDX_MSK = PLUCK_DELAY_LINE_SIZE - 1;
+
+    /**
+     * @brief The delay line, nullptr when the string has none.
+     * 
+     */
+    fxpt_Q0_15* m_line;
+
+    /**
+     * @brief The index of the next sample to be written in the delay line.
+     * 
+     */
+    unsigned int m_write_idx;
+
+    /**
+     * @brief The integer part of the loop delay, in number of samples.
+     * 
+     */
+    unsigned int m_length;
+
+    /**
+     * @brief The phase increment the string is tuned to, so that it is only tuned again when it changes.
+     * 
+     */
+    fxpt_UQ0_32 m_phase_increment;
+
+    /**
+     * @brief The coefficient of the all-pass filter, (1-d)/(1+d) for a fractional delay d.
+     * 
+     */
+    fxpt_Q16_15 m_allpass_coeff;
+
+    /**
+     * @brief The last input and output of the all-pass filter.
+     * @{
+     */
+    fxpt_Q16_15 m_allpass_x1;
+    fxpt_Q16_15 m_allpass_y1;
+    /**@}*/
+
+    /**
+     * @brief The last sample read from the delay line, averaged by the loss filter.
+     * 
+     */
+    fxpt_Q16_15 m_last_output;
+
+public:
+
+    /**
+     * @brief PluckedString constructor, the string has no delay line and is silent.
+     * 
+     */
+    PluckedString();
+
+    /**
+     * @brief Fill a delay line with a noise burst and start the string on it.
+     * 
+     * @param line The delay line of PLUCK_DELAY_LINE_SIZE samples, which must outlive the string or be detached.
+     * @param noise The generator of the burst.
+     */
+    void pluck(fxpt_Q0_15* line, NoiseGenerator& noise);
+
+    /**
+     * @brief Stop using the delay line, the string is then silent.
+     * 
+     */
+    inline void detach() { m_line = nullptr; }
+
+    /**
+     * @brief Whether the string has a delay line.
+     * 
+     */
+    inline bool is_plucked() const { return m_line != nullptr; }
+
+    /**
+     * @brief Tune the string, to be called once per block, only a new pitch costs a division.
+     * Pitches whose period exceeds PLUCK_DELAY_LINE_SIZE samples are played at the lowest possible pitch.
+     * @param phase_increment The phase increment of the note, a full period being 2^32.
+     */
+    void tune(fxpt_UQ0_32 phase_increment);
+
+    /**
+     * @brief Render the next block of samples, silence if the string has no delay line.
+     * 
+     * @param samples The samples to write.
+     * @param nb_samples The number of samples to write.
+     * @param damping The gain of the loss filter at low frequencies, the string sustains longer when it is close to 1.
+     */
+    void render_block(fxpt_Q0_31* samples, unsigned int nb_samples, fxpt_Q0_15 damping);
+};
+
+#endif //SYNTHPATHY_PLUCKEDSTRING_H_
\ No newline at end of file
@@ -0,0 +1,393 @@
+/**
+ * Synthpathy is a small and versatile audio synthesizer on a microcontroler. 
+ * Copyright (C) 2022  Brice Croix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SYNTHPATHY_REVERB_HPP_
+#define SYNTHPATHY_REVERB_HPP_
+
+#include "global.h"
+#include "fxpt.h"
+
+#include <limits>
+
+/**
+ * @brief The quality of a reverberation, that is its number of delay lines.
+ * 
+ */
+enum ReverbQuality
+{
+    /**
+     * @brief 4 comb filters and 2 all-pass filters.
+     * 
+     */
+    REVERB_QUALITY_LOW,
+
+    /**
+     * @brief 6 comb filters and 3 all-pass filters.
+     * 
+     */
+    REVERB_QUALITY_MEDIUM,
+
+    /**
+     * @brief 8 comb filters and 4 all-pass filters, as the original Freeverb.
+     * 
+     */
+    REVERB_QUALITY_HIGH
+};
+
+/**
+ * @brief The sampling frequency for which the reverberation delay lengths are given.
+ * 
+ */
+constexpr unsigned int REVERB_REFERENCE_SAMPLING_FREQUENCY = 44100;
+
+/**
+ * @brief The lengths of the comb filters, in number of samples at REVERB_REFERENCE_SAMPLING_FREQUENCY.
+ * These are Freeverb's tunings, mutually prime so that echoes do not pile up.
+ */
+constexpr unsigned int REVERB_COMB_LENGTHS[8] = {1116, 1188, 1277, 1356, 1422, 1491, 1557, 1617};
+
+/**
+ * @brief The lengths of the all-pass filters, in number of samples at REVERB_REFERENCE_SAMPLING_FREQUENCY.
+ * 
+ */
+constexpr unsigned int REVERB_ALLPASS_LENGTHS[4] = {556, 441, 341, 225};
+
+/**
+ * @brief The number of comb filters of a reverberation of given quality.
+ * 
+ */
+constexpr unsigned int reverb_nb_combs(ReverbQuality quality)
+{
+    return (quality == REVERB_QUALITY_LOW) ? 4 : ((quality == REVERB_QUALITY_MEDIUM) ? 6 : 8);
+}
+
+/**
+ * @brief The number of all-pass filters of a reverberation of given quality.
+ * 
+ */
+constexpr unsigned int reverb_nb_allpasses(ReverbQuality quality)
+{
+    return (quality == REVERB_QUALITY_LOW) ? 2 : ((quality == REVERB_QUALITY_MEDIUM) ? 3 : 4);
+}
+
+/**
+ * @brief Convert a delay length given at REVERB_REFERENCE_SAMPLING_FREQUENCY to AUDIO_SAMPLING_FREQUENCY.
+ * 
+ */
+constexpr unsigned int reverb_scaled_length(unsigned int length)
+{
+    return (uint64_t)length * AUDIO_SAMPLING_FREQUENCY / REVERB_REFERENCE_SAMPLING_FREQUENCY;
+}
+
+/**
+ * @brief The sum of the first n lengths of given table, converted to AUDIO_SAMPLING_FREQUENCY.
+ * 
+ */
+constexpr unsigned int reverb_sum_lengths(const unsigned int* lengths, unsigned int n)
+{
+    return (n == 0) ? 0 : reverb_scaled_length(lengths[n-1]) + reverb_sum_lengths(lengths, n-1);
+}
+
+/**
+ * @brief Schroeder reverberation as tuned by Freeverb : parallel damped comb filters followed by series all-pass filters.
+ * All delay lines are stored as Q0.15 in a single statically allocated array, whose size depends on the quality.
+ * Processing only involves 32 bits multiplications.
+ * 
+ * @tparam quality The number of delay lines, see ReverbQuality.
+ */
+template<ReverbQuality quality>
+class Reverb
+{
+public:
+
+    /**
+     * @brief The number of comb and all-pass filters.
+     * @{
+     */
+    static constexpr unsigned int NB_COMBS = reverb_nb_combs(quality);
+    static constexpr unsigned int NB_ALLPASSES = reverb_nb_allpasses(quality);
+    /**@}*/
+
+    /**
+     * @brief The total number of stored samples.
+     * 
+     */
+    static constexpr unsigned int SIZE_LINES = reverb_sum_lengths(REVERB_COMB_LENGTHS, NB_COMBS) + reverb_sum_lengths(REVERB_ALLPASS_LENGTHS, NB_ALLPASSES);
+
+    /**
+     * @brief The memory footprint of the stored samples, in bytes.
+     * 
+     */
+    static constexpr unsigned int SIZE_BYTES = SIZE_LINES * sizeof(fxpt_Q0_15);
+
+    static_assert(SIZE_BYTES <= REVERB_MEMORY_BUDGET_BYTES, "The reverberation does not fit in REVERB_MEMORY_BUDGET_BYTES, lower its quality");
+
+protected:
+
+    /**
+     * @brief The feedback of all-pass filters, 0.5 in Q0.15.
+     * 
+     */
+    static constexpr fxpt_Q15_16 ALLPASS_FEEDBACK = 1<<14;
+
+    /**
+     * @brief The gain applied on the input before the comb filters, in Q0.15.
+     * This leaves headroom for the resonance of the combs in the 16 bits lines.
+     */
+    static constexpr fxpt_Q15_16 INPUT_GAIN = 1<<12;
+
+    /**
+     * @brief The gain applied on the sum of the combs, in Q0.15.
+     * This compensates INPUT_GAIN and the number of combs, so that all qualities have the same level.
+     */
+    static constexpr fxpt_Q15_16 COMBS_SUM_GAIN = (8<<15) / NB_COMBS;
+
+    /**
+     * @brief A delay line inside the samples array.
+     * 
+     */
+    struct Line
+    {
+        /**
+         * @brief The index of the first sample of the line in m_samples.
+         * 
+         */
+        unsigned int offset;
+
+        /**
+         * @brief The number of samples of the line.
+         * 
+         */
+        unsigned int length;
+
+        /**
+         * @brief The index of the oldest sample, which is read then overwritten by the next one.
+         * 
+         */
+        unsigned int idx;
+    };
+
+    /**
+     * @brief The samples of all delay lines, one after the other.
+     * 
+     */
+    fxpt_Q0_15 m_samples[SIZE_LINES];
+
+    /**
+     * @brief The delay lines of the comb filters.
+     * 
+     */
+    Line m_combs[NB_COMBS];
+
+    /**
+     * @brief The state of the low-pass filter inside each comb filter.
+     * 
+     */
+    fxpt_Q15_16 m_combs_damped[NB_COMBS];
+
+    /**
+     * @brief The delay lines of the all-pass filters.
+     * 
+     */
+    Line m_allpasses[NB_ALLPASSES];
+
+    /**
+     * @brief The feedback of the comb filters in Q0.15, depending on the room size.
+     * 
+     */
+    fxpt_Q15_16 m_feedback;
+
+    /**
+     * @brief The damping of the comb filters in Q0.15.
+     * 
+     */
+    fxpt_Q15_16 m_damping;
+
+    /**
+     * @brief The amount of reverberated signal in the output, in Q0.15.
+     * 
+     */
+    fxpt_Q15_16 m_mix;
+
+    /**
+     * @brief Saturate a value to the Q0.15 range.
+     * 
+     */
+    static inline fxpt_Q0_15 saturate_Q0_15(fxpt_Q15_16 x)
+    {
+        return (x > std::numeric_limits<fxpt_Q0_15>::max()) ? std::numeric_limits<fxpt_Q0_15>::max() :
+            ((x < -std::numeric_limits<fxpt_Q0_15>::max()) ? -std::numeric_limits<fxpt_Q0_15>::max() : x);
+    }
+
+    /**
+     * @brief Multiply two Q0.15 values, truncating the result towards zero.
+     * Truncating towards zero rather than towards minus infinity makes sure the
+     * recirculated signal always decays to silence, instead of cycling on the last bits.
+     */
+    static inline fxpt_Q15_16 multiply_Q0_15(fxpt_Q15_16 x, fxpt_Q15_16 y)
+    {
+        const fxpt_Q15_16 l_product = x * y;
+        return (l_product >= 0) ? fxpt_convert_n(l_product, 15, 0) : -fxpt_convert_n(-l_product, 15, 0);
+    }
+
+    /**
+     * @brief Read the oldest sample of a line, replace it by given sample and move to the next one.
+     * 
+     * @param line The delay line.
+     * @param sample The sample to write.
+     * @return fxpt_Q15_16 The oldest sample, delayed by the line length.
+     */
+    inline fxpt_Q15_16 read_write(Line& line, fxpt_Q0_15 sample)
+    {
+        fxpt_Q0_15* l_sample = &m_samples[line.offset + line.idx];
+        const fxpt_Q15_16 l_delayed = *l_sample;
+        *l_sample = sample;
+        if(++line.idx == line.length) line.idx = 0;
+        return l_delayed;
+    }
+
+    /**
+     * @brief Read the oldest sample of a line without moving.
+     * 
+     */
+    inline fxpt_Q15_16 read(const Line& line) const
+    {
+        return m_samples[line.offset + line.idx];
+    }
+
+public:
+
+    /**
+     * @brief Reverb constructor.
+     * 
+     * @param room_size The room size between 0 and 1, the larger the longer the reverberation.
+     * @param damping The damping of high frequencies between 0 and 1.
+     * @param mix The amount of reverberated signal in the output, between 0 and 1.
+     */
+    Reverb(fxpt_Q0_31 room_size = (1<<30), fxpt_Q0_31 damping = (1<<30), fxpt_Q0_31 mix = (1<<28))
+    {
+        unsigned int l_offset = 0;
+        for(unsigned int i = 0; i < NB_COMBS; ++i)
+        {
+            m_combs[i].offset = l_offset;
+            m_combs[i].length = reverb_scaled_length(REVERB_COMB_LENGTHS[i]);
+            l_offset += m_combs[i].length;
+        }
+        for(unsigned int i = 0; i < NB_ALLPASSES; ++i)
+        {
+            m_allpasses[i].offset = l_offset;
+            m_allpasses[i].length = reverb_scaled_length(REVERB_ALLPASS_LENGTHS[i]);
+            l_offset += m_allpasses[i].length;
+        }
+        clear();
+        set_room_size(room_size);
+        set_damping(damping);
+        set_mix(mix);
+    }
+
+    /**
+     * @brief Silence all delay lines.
+     * 
+     */
+    void clear()
+    {
+        for(unsigned int i = 0; i < SIZE_LINES; ++i)
+        {
+            m_samples[i] = 0;
+        }
+        for(unsigned int i = 0; i < NB_COMBS; ++i)
+        {
+            m_combs[i].idx = 0;
+            m_combs_damped[i] = 0;
+        }
+        for(unsigned int i = 0; i < NB_ALLPASSES; ++i)
+        {
+            m_allpasses[i].idx = 0;
+        }
+    }
+
+    /**
+     * @brief Set the room size.
+     * 
+     * @param room_size Between 0 and 1, the feedback of the combs then goes from 0.7 to 0.98.
+     */
+    inline void set_room_size(fxpt_Q0_31 room_size)
+    {
+        // feedback = 0.7 + 0.28 * room_size
+        constexpr fxpt_Q15_16 l_offset = fxpt_from_float(0.7f, 15);
+        constexpr fxpt_Q15_16 l_scale = fxpt_from_float(0.28f, 15);
+        m_feedback = l_offset + fxpt_convert_n(l_scale * fxpt_convert_n(room_size, 31, 15), 15, 0);
+    }
+
+    /**
+     * @brief Set the damping of high frequencies.
+     * 
+     * @param damping Between 0 and 1.
+     */
+    inline void set_damping(fxpt_Q0_31 damping) { m_damping = fxpt_convert_n(damping, 31, 15); }
+
+    /**
+     * @brief Set the amount of reverberated signal in the output.
+     * 
+     * @param mix Between 0 and 1.
+     */
+    inline void set_mix(fxpt_Q0_31 mix) { m_mix = fxpt_convert_n(mix, 31, 15); }
+
+    /**
+     * @brief Process given block of samples in place.
+     * 
+     * @param samples The samples to process.
+     * @param nb_samples The number of samples in the block.
+     */
+    void process_block(fxpt_Q0_31* samples, unsigned int nb_samples)
+    {
+        // The low-pass filter of each comb is y = x * (1 - damping) + y * damping
+        const fxpt_Q15_16 l_damping_gain = (1<<15) - m_damping;
+
+        for(unsigned int i = 0; i < nb_samples; ++i)
+        {
+            const fxpt_Q15_16 l_input = fxpt_convert_n(fxpt_convert_n(samples[i], 31, 15) * INPUT_GAIN, 15, 0);
+
+            // Parallel comb filters
+            fxpt_Q15_16 l_sum = 0;
+            for(unsigned int j = 0; j < NB_COMBS; ++j)
+            {
+                const fxpt_Q15_16 l_delayed = read(m_combs[j]);
+                m_combs_damped[j] = multiply_Q0_15(l_delayed, l_damping_gain) + multiply_Q0_15(m_combs_damped[j], m_damping);
+                read_write(m_combs[j], saturate_Q0_15(l_input + multiply_Q0_15(m_combs_damped[j], m_feedback)));
+                l_sum += l_delayed;
+            }
+            fxpt_Q15_16 l_wet = fxpt_convert_n((fxpt64_t)l_sum * COMBS_SUM_GAIN, 15, 0);
+
+            // Series all-pass filters
+            for(unsigned int j = 0; j < NB_ALLPASSES; ++j)
+            {
+                const fxpt_Q15_16 l_delayed = read(m_allpasses[j]);
+                read_write(m_allpasses[j], saturate_Q0_15(l_wet + multiply_Q0_15(l_delayed, ALLPASS_FEEDBACK)));
+                l_wet = l_delayed - l_wet;
+            }
+
+            // Add the reverberation to the dry signal, with saturation
+            const fxpt64_t l_output = (fxpt64_t)samples[i] + fxpt_convert_n((fxpt64_t)l_wet * m_mix, 30, 31);
+            samples[i] = (l_output > std::numeric_limits<fxpt_Q0_31>::max()) ? std::numeric_limits<fxpt_Q0_31>::max() :
+                ((l_output < -std::numeric_limits<fxpt_Q0_31>::max()) ? -std::numeric_limits<fxpt_Q0_31>::max() : l_output);
+        }
+    }
+};
+
+#endif //SYNTHPATHY_REVERB_HPP_
\ No newline at end of file
@@ -0,0 +1,252 @@
+/**
+ * Synthpathy is a small and versatile audio synthesizer on a microcontroler. 
+ * Copyright (C) 2022  Brice Croix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SYNTHPATHY_SAMPLEBANK_H_
+#define SYNTHPATHY_SAMPLEBANK_H_
+
+#include "fxpt.h"
+
+#include <stdint.h>
+
+/**
+ * @brief The encoding of the frames of a sample, all samples being mono.
+ * 
+ */
+enum SampleFormat
+{
+    SAMPLE_FORMAT_PCM16 = 0,
+    SAMPLE_FORMAT_PCM8 = 1,
+    SAMPLE_FORMAT_ADPCM = 2,
+    NB_SAMPLE_FORMATS
+};
+
+/**
+ * @brief The first word of a sample bank, "SYSB" in little endian.
+ * 
+ */
+constexpr uint32_t SAMPLE_BANK_MAGIC = 0x42535953;
+
+/**
+ * @brief The version of the layout of the sample bank, see python_scripts/sample_bank.py.
+ * 
+ */
+constexpr uint16_t SAMPLE_BANK_VERSION = 1;
+
+/**
+ * @brief The maximum number of samples in a bank, so that erased or foreign flash is not taken for a bank.
+ * 
+ */
+constexpr unsigned int SAMPLE_BANK_NB_SAMPLES_MAX = 256;
+
+/**
+ * @brief The number of frames stored before the first frame of each PCM sample, for the cubic interpolation.
+ * 
+ */
+constexpr unsigned int SAMPLE_GUARD_BEFORE = 1;
+
+/**
+ * @brief The number of frames stored after the end of each PCM sample, for the interpolations.
+ * These are the frames following the loop start when the sample loops, silence otherwise,
+ * so that the interpolation never has to wrap around.
+ */
+constexpr unsigned int SAMPLE_GUARD_AFTER = 3;
+
+/**
+ * @brief The number of frames of each block of an ADPCM sample.
+ * Each block begins with the AdpcmState before its first frame, so that the decoding can start at any block.
+ */
+constexpr unsigned int SAMPLE_ADPCM_BLOCK_FRAMES = 256;
+
+/**
+ * @brief The size in bytes of each block of an ADPCM sample, its state then one nibble per frame, low nibble first.
+ * The compression ratio is about 3.9 compared to 16 bits frames.
+ */
+constexpr unsigned int SAMPLE_ADPCM_BLOCK_SIZE = 4 + SAMPLE_ADPCM_BLOCK_FRAMES / 2;
+
+/**
+ * @brief The header at the beginning of a sample bank, followed by nb_samples SampleBankEntry.
+ * All fields are little endian, as the RP2040.
+ */
+struct SampleBankHeader
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t nb_samples;
+};
+
+/**
+ * @brief The description of a sample in the bank.
+ * 
+ */
+struct SampleBankEntry
+{
+    /**
+     * @brief The offset of the first frame, or of the first ADPCM block, from the beginning of the bank, in bytes,
+     * aligned on 4 bytes. The guard frames of PCM samples are stored around.
+     */
+    uint32_t offset;
+
+    /**
+     * @brief The number of frames of the sample, without the guard frames.
+     * A looped sample ends with its loop.
+     */
+    uint32_t length;
+
+    /**
+     * @brief The first frame of the loop.
+     * 
+     */
+    uint32_t loop_start;
+
+    /**
+     * @brief The frame after the last one of the loop, the sample is played once if it is not after loop_start.
+     * 
+     */
+    uint32_t loop_end;
+
+    /**
+     * @brief The sampling frequency of the sample in Hz.
+     * 
+     */
+    uint32_t sample_rate;
+
+    /**
+     * @brief The encoding of the frames, see SampleFormat.
+     * 
+     */
+    uint8_t format;
+
+    /**
+     * @brief The midi note at which the sample sounds when played at its own sampling frequency.
+     * 
+     */
+    uint8_t root_note;
+
+    /**
+     * @brief The tuning of the root note in cents, between -50 and 50.
+     * 
+     */
+    int8_t fine_tune;
+
+    uint8_t reserved;
+};
+
+static_assert(sizeof(SampleBankHeader) == 8, "The sample bank header must match python_scripts/sample_bank.py");
+static_assert(sizeof(SampleBankEntry) == 24, "The sample bank entries must match python_scripts/sample_bank.py");
+
+/**
+ * @brief A sample ready to be played, see SamplePlayer.
+ * 
+ */
+struct Sample
+{
+    /**
+     * @brief The first frame, either int16_t or int8_t depending on the format, or the first ADPCM block, usually in flash.
+     * 
+     */
+    const void* data;
+
+    /**
+     * @brief The number of frames which can be played.
+     * 
+     */
+    unsigned int length;
+
+    /**
+     * @brief The first frame of the loop.
+     * 
+     */
+    unsigned int loop_start;
+
+    /**
+     * @brief The frame after the last one of the loop, the sample is played once if it is not after loop_start.
+     * 
+     */
+    unsigned int loop_end;
+
+    /**
+     * @brief The encoding of the frames.
+     * 
+     */
+    SampleFormat format;
+
+    /**
+     * @brief The phase increment at which the sample is played at its own sampling frequency,
+     * the root frequency divided by the sampling frequency of the sample.
+     */
+    fxpt_UQ0_32 unity_increment;
+};
+
+/**
+ * @brief A bank of samples stored in flash by python_scripts/sample_bank.py, and read in place through
+ * the XIP window, the samples are never copied in RAM. Its layout is a SampleBankHeader followed by
+ * the SampleBankEntry of each sample, then the frames of each sample surrounded by their guard frames,
+ * or its blocks for ADPCM samples.
+ */
+class SampleBank
+{
+protected:
+
+    /**
+     * @brief The beginning of the bank, nullptr if no valid bank was found.
+     * 
+     */
+    const uint8_t* m_base;
+
+    /**
+     * @brief The number of samples in the bank.
+     * 
+     */
+    unsigned int m_nb_samples;
+
+public:
+
+    /**
+     * @brief SampleBank constructor, the bank is checked once.
+     * 
+     * @param base The beginning of the bank, aligned on 4 bytes.
+     */
+    SampleBank(const void* base);
+
+    /**
+     * @brief Indicates whether a valid bank was found.
+     * 
+     * @return true The bank can be read.
+     * @return false The bank is empty.
+     */
+    inline bool is_valid() const { return m_base != nullptr; }
+
+    /**
+     * @brief Get the number of samples in the bank.
+     * 
+     * @return unsigned int 
+     */
+    inline unsigned int get_nb_samples() const { return m_nb_samples; }
+
+    /**
+     * @brief Get a sample ready to be played.
+     * 
+     * @param index The index of the sample in the bank.
+     * @param sample The sample to fill.
+     * @return true The sample exists and is consistent.
+     * @return false The sample does not exist, it is left unchanged.
+     */
+    bool get_sample(unsigned int index, Sample& sample) const;
+};
+
+#endif //SYNTHPATHY_SAMPLEBANK_H_
\ No newline at end of file
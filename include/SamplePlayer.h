@@ -0,0 +1,166 @@
+/**
+ * Synthpathy is a small and versatile audio synthesizer on a microcontroler. 
+ * Copyright (C) 2022  Brice Croix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SYNTHPATHY_SAMPLEPLAYER_H_
+#define SYNTHPATHY_SAMPLEPLAYER_H_
+
+#include "global.h"
+#include "fxpt.h"
+#include "SampleBank.h"
+#include "AdpcmStream.h"
+
+/**
+ * @brief The interpolation between the frames of a sample played at another pitch than its own.
+ * 
+ */
+enum SampleInterpolation
+{
+    /**
+     * @brief Linear interpolation between the two surrounding frames, a single 32 bits product.
+     * 
+     */
+    SAMPLE_INTERPOLATION_LINEAR,
+
+    /**
+     * @brief Cubic (Catmull-Rom) interpolation between the four surrounding frames, less aliasing and dulling.
+     * 
+     */
+    SAMPLE_INTERPOLATION_CUBIC
+};
+
+/**
+ * @brief Plays a sample at any pitch, reading its frames in place, in flash for samples of a SampleBank.
+ * The position in the sample is a Q32.32 number of frames, incremented by a fractional step each sample.
+ * Samples with a loop play it until the note dies, the others stop at their end.
+ * ADPCM samples are decoded a block ahead by an AdpcmStream, their position being its virtual index.
+ */
+class SamplePlayer
+{
+protected:
+
+    /**
+     * @brief The sample being played.
+     * 
+     */
+    Sample m_sample;
+
+    /**
+     * @brief Whether a sample is being played.
+     * 
+     */
+    bool m_is_playing;
+
+    /**
+     * @brief The position in the sample, in number of frames in Q32.32.
+     * 
+     */
+    uint64_t m_position;
+
+    /**
+     * @brief The increment of the position at each sample, in number of frames in Q32.32.
+     * 
+     */
+    uint64_t m_step;
+
+    /**
+     * @brief The phase increment the step was computed from, so that it is only computed again when it changes.
+     * 
+     */
+    fxpt_UQ0_32 m_phase_increment;
+
+    /**
+     * @brief The decoder of ADPCM samples.
+     * 
+     */
+    AdpcmStream m_stream;
+
+    /**
+     * @brief The longest step of an ADPCM sample, so that the frames of a block fit in the ring of decoded frames.
+     * 
+     */
+    static constexpr uint64_t ADPCM_STEP_MAX = ((uint64_t)(SAMPLE_ADPCM_RING_SIZE - 5) << 32) / SIZE_AUDIO_BLOCK;
+
+    /**
+     * @brief Render a block of samples, the loop being specialized for each kind of frames and interpolation.
+     * 
+     * @tparam Frames The frames of the sample, indexed by position.
+     * @tparam interpolation The interpolation between the frames.
+     * @param frames The frames of the sample.
+     * @param samples The samples to write.
+     * @param nb_samples The number of samples to write.
+     * @param end The position of the end of the sample or of its loop, in Q32.32.
+     * @param loop_length The length of the loop in Q32.32, 0 if the sample stops at its end.
+     */
+    template<class Frames, SampleInterpolation interpolation>
+    void render(const Frames& frames, fxpt_Q0_31* samples, unsigned int nb_samples, uint64_t end, uint64_t loop_length);
+
+    /**
+     * @brief Render a block of samples with the given interpolation, see render.
+     * 
+     */
+    template<class Frames>
+    void render(const Frames& frames, fxpt_Q0_31* samples, unsigned int nb_samples, SampleInterpolation interpolation, uint64_t end, uint64_t loop_length);
+
+public:
+
+    /**
+     * @brief SamplePlayer constructor, nothing is played.
+     * 
+     */
+    SamplePlayer();
+
+    /**
+     * @brief Play a sample from its beginning.
+     * 
+     * @param sample The sample to play, which frames must stay available while it is played.
+     */
+    void start(const Sample& sample);
+
+    /**
+     * @brief Stop playing, the player then renders silence.
+     * 
+     */
+    inline void stop() { m_is_playing = false; }
+
+    /**
+     * @brief Indicates whether a sample is being played.
+     * 
+     * @return true Until the end of a sample without loop.
+     * @return false The player renders silence.
+     */
+    inline bool is_playing() const { return m_is_playing; }
+
+    /**
+     * @brief Set the pitch of the sample.
+     * 
+     * @param phase_increment The phase increment of the note, the sample being played at its own
+     * sampling frequency when it equals the unity increment of the sample.
+     */
+    void tune(fxpt_UQ0_32 phase_increment);
+
+    /**
+     * @brief Render a block of samples, and progress in the sample.
+     * 
+     * @param samples The samples to write, the 16 bits frames in the higher bits.
+     * @param nb_samples The number of samples to write, SIZE_AUDIO_BLOCK at most for ADPCM samples.
+     * @param interpolation The interpolation between the frames.
+     */
+    void render_block(fxpt_Q0_31* samples, unsigned int nb_samples, SampleInterpolation interpolation);
+};
+
+#endif //SYNTHPATHY_SAMPLEPLAYER_H_
\ No newline at end of file
@@ -0,0 +1,215 @@
+/**
+ * Synthpathy is a small and versatile audio synthesizer on a microcontroler. 
+ * Copyright (C) 2022  Brice Croix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SYNTHPATHY_SMOOTHEDPARAMETER_HPP_
+#define SYNTHPATHY_SMOOTHEDPARAMETER_HPP_
+
+#include "fxpt.h"
+
+/**
+ * @brief The kind of ramp used by a SmoothedParameter to reach its target.
+ * 
+ */
+enum SmoothingMode
+{
+    /**
+     * @brief The value reaches its target linearly, in exactly the smoothing duration.
+     * 
+     */
+    SMOOTHING_LINEAR,
+
+    /**
+     * @brief The value tends exponentially to its target (one-pole low-pass filter).
+     * The smoothing duration is the time constant, rounded down to a power of two.
+     */
+    SMOOTHING_ONE_POLE
+};
+
+/**
+ * @brief A parameter which smoothly tends to its target value.
+ * The target can be written at any rate (for instance by an interrupt), only the last
+ * written target is taken into account when the parameter is updated at control rate,
+ * so that the DSP only ever sees the smoothed value.
+ * 
+ * @tparam T The fixed-point datatype of the parameter, on 32 bits at most.
+ */
+template<class T>
+class SmoothedParameter
+{
+public:
+
+    /**
+     * @brief SmoothedParameter constructor.
+     * 
+     * @param value The initial value, also used as initial target.
+     * @param duration The smoothing duration in number of updates, at least 1.
+     * @param mode The kind of ramp used to reach the target.
+     */
+    SmoothedParameter(T value = 0, unsigned int duration = 1, SmoothingMode mode = SMOOTHING_LINEAR)
+    {
+        m_mode = mode;
+        set_duration(duration);
+        set_value(value);
+    }
+
+    /**
+     * @brief Set the target value the parameter must tend to.
+     * Consecutive calls between two updates are coalesced, only the last one matters.
+     * @param target
+     */
+    inline void set_target(T target)
+    {
+        m_target = target;
+    }
+
+    /**
+     * @brief Set the value of the parameter immediately, without smoothing.
+     * 
+     * @param value
+     */
+    void set_value(T value)
+    {
+        m_target = value;
+        m_ramp_target = value;
+        m_value = value;
+        m_step = 0;
+        m_steps_left = 0;
+    }
+
+    /**
+     * @brief Set the smoothing duration.
+     * 
+     * @param duration The smoothing duration in number of updates, at least 1.
+     */
+    void set_duration(unsigned int duration)
+    {
+        m_duration = (duration > 0) ? duration : 1;
+        m_shift = fxpt_log2(m_duration);
+    }
+
+    /**
+     * @brief Get the smoothed value of the parameter.
+     * 
+     * @return T
+     */
+    inline T get() const { return m_value; }
+
+    /**
+     * @brief Get the target value of the parameter.
+     * 
+     * @return T
+     */
+    inline T get_target() const { return m_target; }
+
+    /**
+     * @brief Make the parameter progress towards its target, to be called at control rate.
+     * 
+     * @return true if the smoothed value has changed.
+     * @return false if the smoothed value is stable.
+     */
+    bool update()
+    {
+        // Read the target once, since it may be written by an interrupt
+        const T l_target = m_target;
+        const T l_value_old = m_value;
+
+        if(m_mode == SMOOTHING_ONE_POLE)
+        {
+            // value += (target - value) / 2^shift, 64 bits since T may be unsigned
+            const fxpt64_t l_delta = ((fxpt64_t)l_target - (fxpt64_t)m_value) >> m_shift;
+            // Make sure the target is eventually reached
+            m_value = (l_delta == 0) ? l_target : (T)(m_value + l_delta);
+        }
+        else
+        {
+            // A new ramp is started only when the target has changed
+            if(l_target != m_ramp_target)
+            {
+                m_ramp_target = l_target;
+                m_step = ((fxpt64_t)l_target - (fxpt64_t)m_value) / (fxpt64_t)m_duration;
+                m_steps_left = m_duration;
+            }
+
+            if(m_steps_left > 1)
+            {
+                m_value = (T)(m_value + m_step);
+                m_steps_left--;
+            }
+            else
+            {
+                // Last step lands exactly on target, regardless of rounding errors
+                m_value = m_ramp_target;
+                m_steps_left = 0;
+            }
+        }
+
+        return m_value != l_value_old;
+    }
+
+protected:
+
+    /**
+     * @brief The current smoothed value.
+     * 
+     */
+    T m_value;
+
+    /**
+     * @brief The target value, possibly written by an interrupt.
+     * 
+     */
+    volatile T m_target;
+
+    /**
+     * @brief The target of the linear ramp in progress.
+     * 
+     */
+    T m_ramp_target;
+
+    /**
+     * @brief The increment of the linear ramp at each update.
+     * 
+     */
+    fxpt64_t m_step;
+
+    /**
+     * @brief The number of updates left before the linear ramp reaches its target.
+     * 
+     */
+    unsigned int m_steps_left;
+
+    /**
+     * @brief The smoothing duration in number of updates.
+     * 
+     */
+    unsigned int m_duration;
+
+    /**
+     * @brief The base two logarithm of the smoothing duration, used by the one-pole mode.
+     * 
+     */
+    unsigned int m_shift;
+
+    /**
+     * @brief The kind of ramp used to reach the target.
+     * 
+     */
+    SmoothingMode m_mode;
+};
+
+#endif //SYNTHPATHY_SMOOTHEDPARAMETER_HPP_
\ No newline at end of file
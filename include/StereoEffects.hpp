@@ -0,0 +1,140 @@
+/**
+ * Synthpathy is a small and versatile audio synthesizer on a microcontroler. 
+ * Copyright (C) 2022  Brice Croix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SYNTHPATHY_STEREOEFFECTS_HPP_
+#define SYNTHPATHY_STEREOEFFECTS_HPP_
+
+#include "global.h"
+#include "fxpt.h"
+
+#include <limits>
+
+/*
+ * Adapters making mono effects process interleaved stereo blocks, in an EffectsChain.
+ * Samples are interleaved, left channel first, and nb_samples counts the samples of both channels.
+ */
+
+/**
+ * @brief A mono effect duplicated on each channel, for effects whose state is small such as filters.
+ * Both instances must be configured identically, see get_channel.
+ * 
+ * @tparam Effect Any class implementing process_block(fxpt_Q0_31*, unsigned int).
+ */
+template<class Effect>
+class DualMono
+{
+protected:
+
+    /**
+     * @brief The effect of each channel.
+     * 
+     */
+    Effect m_channels[2];
+
+public:
+
+    /**
+     * @brief Get the effect of the given channel in order to configure it.
+     * 
+     * @param channel 0 for left, 1 for right.
+     * @return Effect& 
+     */
+    inline Effect& get_channel(unsigned int channel) { return m_channels[channel]; }
+
+    /**
+     * @brief Process an interleaved stereo block of samples in place, each channel by its own effect.
+     * 
+     * @param samples The interleaved samples to process.
+     * @param nb_samples The number of samples of both channels, a multiple of 2.
+     */
+    void process_block(fxpt_Q0_31* samples, unsigned int nb_samples)
+    {
+        // The channels are processed by chunks of at most one audio block each
+        fxpt_Q0_31 l_left[SIZE_AUDIO_BLOCK];
+        fxpt_Q0_31 l_right[SIZE_AUDIO_BLOCK];
+        while(nb_samples > 0)
+        {
+            const unsigned int l_nb_frames = (nb_samples/2 < SIZE_AUDIO_BLOCK) ? nb_samples/2 : SIZE_AUDIO_BLOCK;
+            for(unsigned int i = 0; i < l_nb_frames; ++i)
+            {
+                l_left[i] = samples[2*i];
+                l_right[i] = samples[2*i+1];
+            }
+            m_channels[0].process_block(l_left, l_nb_frames);
+            m_channels[1].process_block(l_right, l_nb_frames);
+            for(unsigned int i = 0; i < l_nb_frames; ++i)
+            {
+                samples[2*i] = l_left[i];
+                samples[2*i+1] = l_right[i];
+            }
+            samples += 2*l_nb_frames;
+            nb_samples -= 2*l_nb_frames;
+        }
+    }
+};
+
+/**
+ * @brief A single mono effect shared by both channels, for effects whose memory cannot be duplicated such as delays.
+ * The effect processes the mid signal (L+R)/2, and the change it applies to it is added to both channels :
+ * the difference between the channels goes through dry.
+ * The effect is configured directly, as the base class.
+ * 
+ * @tparam Effect Any class implementing process_block(fxpt_Q0_31*, unsigned int).
+ */
+template<class Effect>
+class SharedMono : public Effect
+{
+public:
+
+    /**
+     * @brief Process an interleaved stereo block of samples in place, through the mid signal.
+     * 
+     * @param samples The interleaved samples to process.
+     * @param nb_samples The number of samples of both channels, a multiple of 2.
+     */
+    void process_block(fxpt_Q0_31* samples, unsigned int nb_samples)
+    {
+        constexpr fxpt64_t l_max = std::numeric_limits<fxpt_Q0_31>::max();
+        constexpr fxpt64_t l_min = std::numeric_limits<fxpt_Q0_31>::min();
+
+        fxpt_Q0_31 l_mid[SIZE_AUDIO_BLOCK];
+        fxpt_Q0_31 l_mid_processed[SIZE_AUDIO_BLOCK];
+        while(nb_samples > 0)
+        {
+            const unsigned int l_nb_frames = (nb_samples/2 < SIZE_AUDIO_BLOCK) ? nb_samples/2 : SIZE_AUDIO_BLOCK;
+            for(unsigned int i = 0; i < l_nb_frames; ++i)
+            {
+                l_mid[i] = (samples[2*i] >> 1) + (samples[2*i+1] >> 1);
+                l_mid_processed[i] = l_mid[i];
+            }
+            Effect::process_block(l_mid_processed, l_nb_frames);
+            for(unsigned int i = 0; i < l_nb_frames; ++i)
+            {
+                const fxpt64_t l_change = (fxpt64_t)l_mid_processed[i] - (fxpt64_t)l_mid[i];
+                const fxpt64_t l_left = samples[2*i] + l_change;
+                const fxpt64_t l_right = samples[2*i+1] + l_change;
+                samples[2*i] = (l_left > l_max) ? l_max : ((l_left < l_min) ? l_min : l_left);
+                samples[2*i+1] = (l_right > l_max) ? l_max : ((l_right < l_min) ? l_min : l_right);
+            }
+            samples += 2*l_nb_frames;
+            nb_samples -= 2*l_nb_frames;
+        }
+    }
+};
+
+#endif //SYNTHPATHY_STEREOEFFECTS_HPP_
\ No newline at end of file
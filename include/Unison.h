@@ -0,0 +1,147 @@
+/**
+ * Synthpathy is a small and versatile audio synthesizer on a microcontroler. 
+ * Copyright (C) 2022  Brice Croix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SYNTHPATHY_UNISON_H_
+#define SYNTHPATHY_UNISON_H_
+
+#include "global.h"
+#include "fxpt.h"
+
+#include <limits>
+
+/**
+ * @brief The maximum number of oscillators of a note in unison mode.
+ * 
+ */
+constexpr unsigned int UNISON_NB_OSCILLATORS_MAX = 8;
+
+/**
+ * @brief The maximum detune of the outer oscillators, in semitones.
+ * 
+ */
+constexpr unsigned int UNISON_DETUNE_MAX_SEMITONES = 7;
+
+/**
+ * @brief The settings of the unison mode, shared by all notes : each note renders several detuned
+ * oscillators of the selected waveform, sharing its envelope, see ActiveNote::render_unison.
+ * The detune ratios and the gain only change with the settings, they are computed once here.
+ */
+class Unison
+{
+protected:
+
+    /**
+     * @brief The number of oscillators of each note, 1 disabling the unison mode.
+     * 
+     */
+    unsigned int m_nb_oscillators;
+
+    /**
+     * @brief The detune of the outer oscillators in semitones, the others being evenly spread in between.
+     * 
+     */
+    fxpt_Q15_16 m_detune;
+
+    /**
+     * @brief The width of the oscillators in the stereo field between 0 and 1, only used in stereo.
+     * 
+     */
+    fxpt_Q0_31 m_stereo_spread;
+
+    /**
+     * @brief The ratio of the phase increment of each oscillator to the one of the note.
+     * 
+     */
+    fxpt_UQ1_31 m_ratios[UNISON_NB_OSCILLATORS_MAX];
+
+    /**
+     * @brief Compute the ratios of the oscillators from the detune.
+     * 
+     */
+    void update_ratios();
+
+public:
+
+    /**
+     * @brief Unison constructor.
+     * 
+     * @param nb_oscillators The number of oscillators of each note, 1 disabling the unison mode.
+     * @param detune The detune of the outer oscillators in semitones.
+     * @param stereo_spread The width of the oscillators in the stereo field between 0 and 1.
+     */
+    Unison(unsigned int nb_oscillators = 1, fxpt_Q15_16 detune = 1<<14, fxpt_Q0_31 stereo_spread = std::numeric_limits<fxpt_Q0_31>::max());
+
+    /**
+     * @brief Get the number of oscillators of each note.
+     * 
+     * @return unsigned int Between 1 and UNISON_NB_OSCILLATORS_MAX.
+     */
+    inline unsigned int get_nb_oscillators() const { return m_nb_oscillators; }
+
+    /**
+     * @brief Set the number of oscillators of each note.
+     * 
+     * @param nb_oscillators Clamped between 1 (no unison) and UNISON_NB_OSCILLATORS_MAX.
+     */
+    void set_nb_oscillators(unsigned int nb_oscillators);
+
+    /**
+     * @brief Get the detune of the outer oscillators.
+     * 
+     * @return fxpt_Q15_16 In semitones.
+     */
+    inline fxpt_Q15_16 get_detune() const { return m_detune; }
+
+    /**
+     * @brief Set the detune of the outer oscillators, the others being evenly spread in between.
+     * 
+     * @param detune In semitones, from 0 to UNISON_DETUNE_MAX_SEMITONES.
+     */
+    void set_detune(fxpt_Q15_16 detune);
+
+    /**
+     * @brief Get the width of the oscillators in the stereo field.
+     * 
+     * @return fxpt_Q0_31 
+     */
+    inline fxpt_Q0_31 get_stereo_spread() const { return m_stereo_spread; }
+
+    /**
+     * @brief Set the width of the oscillators in the stereo field, odd oscillators being on the right.
+     * 
+     * @param stereo_spread Between 0 (mono) and 1.
+     */
+    inline void set_stereo_spread(fxpt_Q0_31 stereo_spread) { m_stereo_spread = (stereo_spread < 0) ? 0 : stereo_spread; }
+
+    /**
+     * @brief Get the ratio of the phase increment of an oscillator to the one of the note.
+     * 
+     * @param oscillator The index of the oscillator, below get_nb_oscillators.
+     * @return fxpt_UQ1_31 
+     */
+    inline fxpt_UQ1_31 get_ratio(unsigned int oscillator) const { return m_ratios[oscillator]; }
+
+    /**
+     * @brief Get the gain applied to the sum of the oscillators, 1/sqrt(n) so that the loudness does not
+     * depend on the number of oscillators, the oscillators being uncorrelated.
+     * @return fxpt_Q0_31 
+     */
+    fxpt_Q0_31 get_gain() const;
+};
+
+#endif //SYNTHPATHY_UNISON_H_
\ No newline at end of file
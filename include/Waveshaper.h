@@ -0,0 +1,158 @@
+/**
+ * Synthpathy is a small and versatile audio synthesizer on a microcontroler. 
+ * Copyright (C) 2022  Brice Croix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SYNTHPATHY_WAVESHAPER_H_
+#define SYNTHPATHY_WAVESHAPER_H_
+
+#include "fxpt.h"
+
+/**
+ * @brief The transfer curves of the waveshaper.
+ * 
+ */
+enum WaveshaperCurve
+{
+    /**
+     * @brief Soft saturation, overdrive.
+     * 
+     */
+    WAVESHAPER_CURVE_TANH,
+
+    /**
+     * @brief Hard clipping, distortion.
+     * 
+     */
+    WAVESHAPER_CURVE_HARD_CLIP,
+
+    /**
+     * @brief Asymmetric saturation, fuzz.
+     * 
+     */
+    WAVESHAPER_CURVE_FUZZ
+};
+
+/**
+ * @brief Waveshaper distortion, mapping each sample through a transfer curve stored in a look-up table.
+ * The distortion can be oversampled twice, so that most of the harmonics above the Nyquist frequency
+ * are filtered out instead of being folded back (aliasing).
+ */
+class Waveshaper
+{
+protected:
+
+    /**
+     * @brief The look-up table of the selected transfer curve.
+     * 
+     */
+    const fxpt_Q0_15* m_curve;
+
+    /**
+     * @brief The selected transfer curve.
+     * 
+     */
+    WaveshaperCurve m_curve_type;
+
+    /**
+     * @brief The gain applied before the transfer curve, up to 16.
+     * 
+     */
+    fxpt_UQ4_28 m_drive;
+
+    /**
+     * @brief Whether the transfer curve is applied at twice the audio sampling frequency.
+     * 
+     */
+    bool m_oversampling;
+
+    /**
+     * @brief The number of past samples needed by the half-band resampling filters.
+     * @{
+     */
+    static constexpr unsigned int SIZE_UPSAMPLER_HISTORY = 5;
+    static constexpr unsigned int SIZE_DOWNSAMPLER_HISTORY = 9;
+    /**@}*/
+
+    /**
+     * @brief The last input samples, the oldest first, used by the upsampling filter.
+     * 
+     */
+    fxpt_Q0_31 m_upsampler_history[SIZE_UPSAMPLER_HISTORY];
+
+    /**
+     * @brief The last shaped samples at twice the audio sampling frequency, the oldest first,
+     * used by the downsampling filter.
+     */
+    fxpt_Q15_16 m_downsampler_history[SIZE_DOWNSAMPLER_HISTORY];
+
+    /**
+     * @brief Apply the drive and the transfer curve on a sample.
+     * The curve is linearly interpolated between the values of its look-up table.
+     * @param x 
+     * @return fxpt_Q0_15 
+     */
+    fxpt_Q0_15 shape(fxpt_Q0_31 x) const;
+
+public:
+
+    /**
+     * @brief Waveshaper constructor.
+     * 
+     * @param curve The transfer curve.
+     * @param drive The gain applied before the transfer curve, up to 16.
+     * @param oversampling Whether the transfer curve is applied at twice the audio sampling frequency.
+     */
+    Waveshaper(WaveshaperCurve curve = WAVESHAPER_CURVE_TANH, fxpt_UQ4_28 drive = fxpt_convert_n(2U, 0, 28), bool oversampling = true);
+
+    /**
+     * @brief Select the transfer curve.
+     * 
+     * @param curve 
+     */
+    void set_curve(WaveshaperCurve curve);
+
+    /**
+     * @brief Get the selected transfer curve.
+     * 
+     * @return WaveshaperCurve 
+     */
+    inline WaveshaperCurve get_curve() const { return m_curve_type; }
+
+    /**
+     * @brief Set the gain applied before the transfer curve.
+     * 
+     * @param drive Up to 16.
+     */
+    inline void set_drive(fxpt_UQ4_28 drive) { m_drive = drive; }
+
+    /**
+     * @brief Enable or disable the oversampling of the transfer curve.
+     * 
+     * @param oversampling 
+     */
+    void set_oversampling(bool oversampling);
+
+    /**
+     * @brief Process given block of samples in place.
+     * 
+     * @param samples The samples to process.
+     * @param nb_samples The number of samples in the block.
+     */
+    void process_block(fxpt_Q0_31* samples, unsigned int nb_samples);
+};
+
+#endif //SYNTHPATHY_WAVESHAPER_H_
\ No newline at end of file
@@ -0,0 +1,100 @@
+/**
+ * Synthpathy is a small and versatile audio synthesizer on a microcontroler. 
+ * Copyright (C) 2022  Brice Croix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SYNTHPATHY_ADPCM_H_
+#define SYNTHPATHY_ADPCM_H_
+
+#include <stdint.h>
+
+/*
+ * IMA-ADPCM, 4 bits per frame, see python_scripts/sample_bank.py for the encoder.
+ * These tables are const so that they stay in flash.
+ */
+
+/**
+ * @brief The number of quantizer steps.
+ * 
+ */
+constexpr unsigned int ADPCM_NB_STEPS = 89;
+
+/**
+ * @brief The quantizer step for each step index.
+ * 
+ */
+const int16_t ADPCM_STEPS[ADPCM_NB_STEPS] =
+{
+        7,     8,     9,    10,    11,    12,    13,    14,    16,    17,    19,    21,
+       23,    25,    28,    31,    34,    37,    41,    45,    50,    55,    60,    66,
+       73,    80,    88,    97,   107,   118,   130,   143,   157,   173,   190,   209,
+      230,   253,   279,   307,   337,   371,   408,   449,   494,   544,   598,   658,
+      724,   796,   876,   963,  1060,  1166,  1282,  1411,  1552,  1707,  1878,  2066,
+     2272,  2499,  2749,  3024,  3327,  3660,  4026,  4428,  4871,  5358,  5894,  6484,
+     7132,  7845,  8630,  9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350,
+    22385, 24623, 27086, 29794, 32767,
+};
+
+/**
+ * @brief The change of step index for each code, its sign bit being ignored.
+ * 
+ */
+const int8_t ADPCM_INDEX_CHANGES[8] = {-1, -1, -1, -1, 2, 4, 6, 8};
+
+/**
+ * @brief The state of an IMA-ADPCM decoder, also stored at the beginning of each block of a sample.
+ * 
+ */
+struct AdpcmState
+{
+    /**
+     * @brief The last decoded frame.
+     * 
+     */
+    int32_t predictor;
+
+    /**
+     * @brief The index of the current quantizer step, between 0 and ADPCM_NB_STEPS-1.
+     * 
+     */
+    int32_t step_index;
+};
+
+/**
+ * @brief Decode a frame.
+ * 
+ * @param state The state of the decoder, updated.
+ * @param code The 4 bits code of the frame.
+ * @return int16_t The decoded frame.
+ */
+inline int16_t adpcm_decode(AdpcmState& state, uint32_t code)
+{
+    const int32_t l_step = ADPCM_STEPS[state.step_index];
+    // (code + 1/2) * step / 4, with shifts only
+    int32_t l_difference = l_step >> 3;
+    l_difference += (code & 1) ? (l_step >> 2) : 0;
+    l_difference += (code & 2) ? (l_step >> 1) : 0;
+    l_difference += (code & 4) ? l_step : 0;
+    int32_t l_predictor = (code & 8) ? state.predictor - l_difference : state.predictor + l_difference;
+    l_predictor = (l_predictor > INT16_MAX) ? INT16_MAX : ((l_predictor < INT16_MIN) ? INT16_MIN : l_predictor);
+    state.predictor = l_predictor;
+
+    const int32_t l_step_index = state.step_index + ADPCM_INDEX_CHANGES[code & 7];
+    state.step_index = (l_step_index < 0) ? 0 : ((l_step_index > (int32_t)ADPCM_NB_STEPS - 1) ? ADPCM_NB_STEPS - 1 : l_step_index);
+    return l_predictor;
+}
+
+#endif //SYNTHPATHY_ADPCM_H_
\ No newline at end of file
@@ -0,0 +1,176 @@
+/**
+ * Synthpathy is a small and versatile audio synthesizer on a microcontroler. 
+ * Copyright (C) 2022  Brice Croix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef SYNTHPATHY_ADPCM_TEST_VECTORS_H_
+#define SYNTHPATHY_ADPCM_TEST_VECTORS_H_
+
+#include "SampleBank.h"
+
+/*
+ * A test signal encoded and decoded by python_scripts/sample_bank.py, generated by python_scripts/adpcm_test_vectors.py,
+ * so that the tests check that the decoder of the device gets the same frames.
+ * These tables are const so that they stay in flash.
+ */
+
+/**
+ * @brief The number of frames of the test signal, which ends with its loop.
+ * 
+ */
+constexpr unsigned int ADPCM_TEST_LENGTH = 1000;
+
+/**
+ * @brief The first frame of the loop of the test signal, in the middle of a block.
+ * 
+ */
+constexpr unsigned int ADPCM_TEST_LOOP_START = 300;
+
+/**
+ * @brief The ADPCM blocks of the test signal, encoded by python_scripts/sample_bank.py.
+ * They are aligned as in a sample bank.
+ */
+alignas(4) const uint8_t ADPCM_TEST_BLOCKS[4 * SAMPLE_ADPCM_BLOCK_SIZE] =
+{
+      0,   0,   0,   0, 112, 119, 119, 119, 119,   4, 136, 144, 152, 169, 170, 187,
+    188, 203, 186, 186, 154, 137,  16,  66,  68,  52,  68,  51,  52,  67,  34,  35,
+     17, 129, 168, 203, 205, 203, 219, 186, 172, 187, 187, 170, 154,  24,  49,  84,
+     83,  52,  83,  50,  36,  51,  50,  18,   2, 136, 202, 204, 219, 203, 203, 203,
+    186, 171, 171, 155, 137,  17,  83,  52,  69,  51,  37,  36,  50,  35,  35,  17,
+      0, 169, 204, 188, 189, 204, 186, 172, 187, 171, 170, 138,   8,  50,  84,  68,
+     67,  67,  51,  52,  50,  51,  34,   1, 152, 218, 219, 188, 189, 203, 187, 172,
+    187, 170, 170, 136,  17,  52,  69,  52,  52,  52,  67,  51,  50,  35,  17,   0,
+    170, 205, 219, 188, 206,  27,  61,   0, 203, 172, 203, 170, 171, 154, 153,   0,
+     50,  84,  52,  52,  37,  36,  35,  51,  50,  34,   0, 152, 203, 205, 255, 191,
+    128,   8, 136, 128,   8, 136, 128,   8, 136, 128, 120, 119,   4,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0, 255, 143,   8, 136, 128,   8, 136, 128,   8,
+    136, 128,   8, 120, 119,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+    255, 143,   8, 136, 128,   8, 136, 128,   8, 136, 128,   8, 120, 119,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0, 255, 143,   8, 136, 128,   8, 136,
+    128,   8, 136, 128,   8, 120, 119,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0, 255, 137, 128,   8,   8, 128,   9,   0,  72,   0,   8, 128, 128,   8,
+      8, 128, 128,   8,   8, 128, 128,   8,   8, 128, 128,   8, 128,   8,   8, 128,
+      8, 128,   8, 128,   8, 128,   8, 128,   8, 128, 128, 128, 128,   8,   8,   8,
+      9,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0, 247, 127, 247, 247, 241,  63,
+     26, 151, 163,   2, 240, 177, 112, 139,  33, 129, 184, 161, 140, 122,   9, 229,
+     96, 169, 131, 242,  56,  44, 124, 173,  83, 187, 164, 161,  14, 178,  85,   0,
+    130, 182, 136,  27,  36,  47, 211, 128,   0, 230, 148,  17, 241,  20, 185,  18,
+     15, 121, 201,  24, 196,  18,  92,  29,  18,   0,  15,  42, 121,  10,  44, 226,
+    162, 112,  58,  44, 184,   0,  77, 169, 134,  42, 110,  26,   9, 241,   0, 195,
+    146,  24, 145, 161,  29, 123,  43, 162, 162, 146,  93,  59,  90, 128, 176, 200,
+      5, 156, 198, 129, 212, 145, 147,   1,  42,  62,  17, 186, 151,  75,  41,   0,
+     79, 144,  29,  25, 165,  28,  57, 146, 208, 230,  32, 226,  21,  44,  90, 202,
+     80, 144,  94, 138, 137, 136, 113, 109, 153, 138, 165,  50, 158, 161, 144,  55,
+     59, 235, 162,  24,   3,   8, 136, 128,   0, 136,   0,   8, 136, 128,   0,   8,
+};
+
+/**
+ * @brief The frames of the test signal decoded by python_scripts/sample_bank.py.
+ * 
+ */
+const int16_t ADPCM_TEST_FRAMES[ADPCM_TEST_LENGTH] =
+{
+         0,     11,     41,    104,    240,    533,   1164,   2521,   5431,  11667,  19690,  20768,
+     19788,  18897,  19707,  17498,  16829,  15004,  13344,  10828,   8541,   6463,   3817,   1413,
+     -1398,  -4044,  -6448,  -9259, -11149, -13553, -15114, -17102, -18393, -19096, -19735, -19929,
+    -19753, -19273, -18545, -17353, -15911, -14165, -12053, -10065,  -7741,  -4930,  -2284,    120,
+      2931,   5577,   7981,  10792,  12682,  14399,  16584,  18004,  18778,  19481,  20120,  19926,
+     19750,  18949,  17930,  16738,  14976,  12864,  10876,   8552,   6367,   3243,   1165,  -1481,
+     -4573,  -6651,  -9297, -11701, -13886, -15874, -17165, -18338, -19404, -19986, -20162, -19682,
+    -19246, -18319, -17236, -15634, -14142, -12008,  -9452,  -7048,  -4863,  -1739,    339,   2985,
+      6077,   8155,  10801,  13205,  14766,  16754,  18045,  18748,  19814,  20008,  19832,  19672,
+     18944,  17752,  16310,  14564,  12922,  10576,   8391,   5835,   3431,    620,  -2026,  -5118,
+     -7196,  -9842, -12246, -13807, -15795, -17086, -18728, -19367, -19949, -20125, -19645, -19209,
+    -18282, -16959, -15372, -13880, -11746,  -9190,  -6786,  -4601,  -1477,    601,   4003,   6290,
+      8368,  11014,  13418,  14979,  16967,  18258,  18961,  19600,  19794,  19970,  19490,  18762,
+     17570,  16128,  14382,  12740,  10394,   8209,   5653,   2561,    483,  -2163,  -5255,  -7333,
+     -9979, -12383, -14568, -15988, -17279, -18452, -19518, -19712, -19888, -19728, -19000, -18073,
+    -16990, -15388, -13468, -11144,  -8959,  -6403,  -3999,  -1188,   1458,   3862,   6673,   9319,
+     11036,  13221,  15209,  17016,  18189,  19255,  19837,  20013,  19853,  19417,  18755,  17432,
+     16199,  14437,  12325,  10337,   7497,   4851,   2447,   -364,  -3010,  -5414,  -8225, -10115,
+    -12519, -14704, -16124, -17415, -18588, -19654, -19848, -20024, -19544, -19108, -17916, -16795,
+    -15193, -13273, -10949,  -8764,  -6208,  -3804,   -993,   1653,   4057,   6868,   9514,  11918,
+     13479,  15467,  17274,  18447,  19086,  19668,  19844,  20004,  19276,  18614,  17291,  15704,
+     14212,  12078,   9522,   7118,   4933,   2377,   -715,  -2793,  -5439,  -8531, -10609, -12499,
+    -14903, -16464, -17884, -18658, -19361, -20000, -19806, -19630, -18829, -17810, -16618, -14856,
+    -12744, -10756,  -8432,  -6247,  -3123,  -1045,   2357,   4644,   7553,   9443,  11847,  14032,
+     15452,  17259,  18432,  19498,  19692,  19868,  19708,  19272,  18345,  17262,  15660,  13740,
+      9867,   1565, -16233, -32768, -30456, -32558, -32768, -31031, -32610, -32768, -31463, -32649,
+    -32768, -31788, -32679, -32768, -32032, -32701, -32768, -32215, -32718, -32768, -32353, -32731,
+    -32768, -28084, -18039,   3497,  31197,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+     32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+     32767,  32767,  25219,   9039, -25648, -29743, -32768, -29383, -32460, -32768, -30225, -32537,
+    -32768, -30857, -32594, -32768, -31333, -32638, -32768, -31690, -32670, -32768, -31958, -32694,
+    -32768, -32160, -32713, -25165,  -8985,  25702,  29797,  32767,  32767,  32767,  32767,  32767,
+     32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+     32767,  32767,  32767,  32767,  25219,   9039, -25648, -29743, -32768, -29383, -32460, -32768,
+    -30225, -32537, -32768, -30857, -32594, -32768, -31333, -32638, -32768, -31690, -32670, -32768,
+    -31958, -32694, -32768, -32160, -32713, -25165,  -8985,  25702,  29797,  32767,  32767,  32767,
+     32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+     32767,  32767,  32767,  32767,  32767,  32767,  25219,   9039, -25648, -29743, -32768, -29383,
+    -32460, -32768, -30225, -32537, -32768, -30857, -32594, -32768, -31333, -32638, -32768, -31690,
+    -32670, -32768, -31958, -32694, -32768, -32160, -32713, -25165,  -8985,  25702,  29797,  32767,
+     32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+     32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,  25219,   9039,   2102,      0,
+      1911,    174,  -1405,     30,  -1275,    -89,    989,      9,   -882,    -72,    664,     -5,
+       603,     50,   -453,      4,   -411,    -33,    310,     -2,    282,     24,   -210,      3,
+      -191,    -15,    145,      0,    132,     12,    -97,      2,    -88,     -6,     68,      0,
+        61,      5,    -46,      0,     42,      4,    -30,      1,    -27,     -1,     22,      1,
+       -18,     -1,     15,      1,    -12,      0,     11,      1,     -8,      0,      7,      1,
+        -5,      0,      5,      1,     -3,      0,      3,      0,      2,      0,      2,      0,
+         2,      1,      0,      1,      0,      1,      0,      1,      0,      0,      0,      0,
+         0,      0,      0,      0,      0,      0,      0,      0,      0,      0,      0,      0,
+         0,      0,      0,      0,      0,      0,      0,      0,      0,      0,      0,      0,
+         0,      0,      0,      0,      0,      0,      0,      0,      0,      0,      0,      0,
+         0,      0,      0,      0,      0,      0,      0,      0,      0,      0,      0,      0,
+         0,      0,      0,      0,      0,      0,      0,      0,      0,      0,      0,      0,
+         0,      0,      0,      0,      0,      0,      0,      0,      0,      0,      0,      0,
+         0,      0,      0,      0,      0,      0,      0,      0,      0,      0,      0,      0,
+         0,      0,      0,      0,      0,      0,      0,      0,      0,      0,      0,      0,
+         0,      0,      0,      0,      0,      0,      0,      0,      0,      0,      0,      0,
+         0,      0,      0,      0,     11,    -19,    -82,     54,    347,   -284,   1073,  -1837,
+      -591,  -6261, -18418,  -6258, -14154,  -9848,   9730,   1336,  19141,   7579,  18090,  20001,
+     21738,  -1951,   8205, -13338, -10540,  27615,  -1054,  -4778,   5378,  20766,  29160,  26617,
+     24305,   9590,  15323,   6637,  -7577,  -9488, -18174,   5515,  -4641,  -1564,  29215, -24030,
+    -19935,  28480,  16194,  -2427,  21272,  18195,  32185,  -5970, -10065,  16004, -14467,   6011,
+    -27507,  32767, -12286, -32764,  -6695,  30547,   1878, -24191,   6280, -14198,  -3026, -19954,
+     -4566,  -7364,  25704,  -2965,  -6689, -10074, -31617, -23223,   -330,  15058, -26913,  -6435,
+     19634, -17608, -13513, -17237, -13852, -10775,  25600, -27645,   9217,  -3069,   8103,  18259,
+     27491, -14480,  22382,  32767,  21595,  -2104,  13284,  21678, -16477, -12382, -23554,  27231,
+     14945, -18573, -22668, -11496,  18975, -17887,   2591,  13763, -16708,  28345, -16708,  -4422,
+     14199,  24355,  27432,  30230,  -7925,  -3830, -22451,  -5523, -14755,  27216,   6738,  10462,
+    -20009,    469,  19090, -24924,  -4446, -23067, -19682,  26484,   6006,  32075,   1604,  22082,
+     18358,  -5341,  -2264,    534, -27446,   6072,  -6214, -24835,  19179,  15084,  -3537,  13391,
+    -26620,  26625,   6147,  17319,   7163,  10240,  18634, -19521, -15426, -11702,  11997, -15703,
+      2918,  -7238, -10315,  -1921,   5709,  -1228,   5078,  -4477, -23587, -15957, -32144,   -611,
+    -29280, -10659,   6269,  -9119,   4871,  -7847,   3715,  -2591, -23613,   7166, -21503,   4566,
+    -12362,  21493,  25588,  21864,  25249,   3706,    908, -21985,  11870,  15965, -17553, -29839,
+     18576, -18286,  -6000,  -9724,  20747, -24306, -12020, -23192,    507,  -8725,   -331,   2212,
+     -9350,   1161, -23683,     16,   9248,  17642,   4924, -11263,  20270,   7984, -18085,  12386,
+       100,  18721,  22106,  25183, -16788,  20074,  24169,  12997, -24245, -11959, -23131, -12975,
+     20880,    402, -32768, -20482, -31654,  -7955,   7433,   -961,   1582, -23855,  20159, -32768,
+    -28673, -10052,   6876, -32768,  12285,  24571,  -8947,  11531,  -7090,  30152,   9674, -23844,
+    -19749,  21217,  25312,  14140, -29874,  15179,  -5299,  -9023, -19179, -22256, -25054, -27597,
+    -20660,  10873, -32768,  20477,   8191,  -2981, -19909, -22986,   7793, -12685,   5936,  29635,
+    -10376, -22662, -11490, -28418, -25341, -32768,   5387,  32767,   6698,  30397,   8854, -27521,
+     -7043, -25664, -29049, -19817,
+};
+
+#endif //SYNTHPATHY_ADPCM_TEST_VECTORS_H_
\ No newline at end of file
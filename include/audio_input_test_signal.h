@@ -0,0 +1,173 @@
+/**
+ * Synthpathy is a small and versatile audio synthesizer on a microcontroler. 
+ * Copyright (C) 2022  Brice Croix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef SYNTHPATHY_AUDIO_INPUT_TEST_SIGNAL_H_
+#define SYNTHPATHY_AUDIO_INPUT_TEST_SIGNAL_H_
+
+#include <stdint.h>
+
+/*
+ * The signal fed to the audio input by the tests, generated by python_scripts/audio_input.py from a wav file
+ * or, as here, from two sines at 440Hz and 3520Hz with a bias error of 100 codes.
+ * This table is const so that it stays in flash.
+ */
+
+/**
+ * @brief The number of frames of the test signal, a whole number of audio blocks.
+ * 
+ */
+constexpr unsigned int AUDIO_INPUT_TEST_SIGNAL_LENGTH = 2048;
+
+/**
+ * @brief Raw ADC samples of the audio input, generated by python_scripts/audio_input.py.
+ * 
+ */
+const uint16_t AUDIO_INPUT_TEST_SIGNAL[AUDIO_INPUT_TEST_SIGNAL_LENGTH] =
+{
+    2148, 2441, 2683, 2834, 2874, 2807, 2659, 2477, 2311, 2209, 2206, 2312, 2516, 2782, 3063, 3305,
+    3466, 3516, 3453, 3297, 3089, 2878, 2716, 2642, 2675, 2811, 3021, 3260, 3476, 3622, 3664, 3590,
+    3414, 3171, 2909, 2680, 2530, 2483, 2543, 2690, 2882, 3069, 3201, 3238, 3163, 2980, 2719, 2424,
+    2149, 1940, 1832, 1835, 1936, 2100, 2277, 2417, 2476, 2427, 2270, 2025, 1734, 1448, 1219, 1084,
+    1062, 1147, 1310, 1506, 1683, 1794, 1805, 1708, 1516, 1266, 1006,  789,  657,  637,  730,  914,
+    1148, 1380, 1560, 1650, 1632, 1514, 1323, 1107,  917,  800,  789,  893, 1096, 1362, 1643, 1886,
+    2047, 2102, 2050, 1913, 1733, 1561, 1446, 1426, 1519, 1716, 1988, 2288, 2563, 2767, 2867, 2855,
+    2746, 2576, 2394, 2253, 2194, 2242, 2396, 2635, 2914, 3184, 3392, 3503, 3500, 3390, 3204, 2987,
+    2794, 2669, 2644, 2727, 2902, 3132, 3367, 3556, 3656, 3644, 3519, 3307, 3048, 2795, 2598, 2494,
+    2498, 2603, 2776, 2973, 3140, 3232, 3218, 3090, 2866, 2582, 2290, 2041, 1876, 1820, 1872, 2007,
+    2184, 2350, 2456, 2467, 2366, 2164, 1892, 1597, 1332, 1142, 1059, 1089, 1215, 1401, 1594, 1745,
+    1813, 1773, 1629, 1404, 1143,  897,  715,  634,  667,  807, 1020, 1260, 1473, 1615, 1655, 1588,
+    1431, 1222, 1012,  851,  781,  823,  977, 1215, 1495, 1764, 1973, 2087, 2091, 1995, 1832, 1649,
+    1497, 1423, 1456, 1599, 1836, 2127, 2422, 2669, 2827, 2875, 2814, 2671, 2489, 2320, 2213, 2202,
+    2301, 2499, 2763, 3044, 3291, 3458, 3516, 3461, 3310, 3104, 2891, 2725, 2644, 2669, 2799, 3005,
+    3244, 3463, 3615, 3665, 3599, 3429, 3189, 2926, 2694, 2537, 2482, 2536, 2678, 2868, 3058, 3195,
+    3239, 3172, 2995, 2738, 2444, 2166, 1952, 1836, 1832, 1927, 2088, 2266, 2410, 2475, 2434, 2283,
+    2044, 1754, 1467, 1232, 1089, 1059, 1138, 1297, 1493, 1673, 1789, 1808, 1718, 1532, 1284, 1023,
+     801,  663,  635,  721,  900, 1132, 1365, 1550, 1647, 1637, 1524, 1337, 1121,  928,  805,  786,
+     882, 1079, 1343, 1624, 1871, 2039, 2102, 2057, 1925, 1746, 1571, 1451, 1424, 1509, 1700, 1968,
+    2268, 2546, 2756, 2864, 2859, 2755, 2588, 2406, 2260, 2195, 2235, 2383, 2617, 2895, 3167, 3381,
+    3499, 3504, 3400, 3218, 3002, 2805, 2674, 2642, 2718, 2887, 3115, 3352, 3545, 3652, 3648, 3531,
+    3323, 3066, 2811, 2609, 2498, 2494, 2593, 2763, 2960, 3131, 3229, 3222, 3102, 2883, 2602, 2309,
+    2055, 1884, 1820, 1865, 1996, 2172, 2340, 2452, 2470, 2377, 2181, 1912, 1617, 1348, 1152, 1061,
+    1084, 1204, 1387, 1582, 1737, 1811, 1779, 1642, 1421, 1161,  912,  724,  635,  662,  795, 1004,
+    1243, 1460, 1608, 1656, 1596, 1444, 1237, 1025,  859,  782,  817,  963, 1197, 1475, 1747, 1961,
+    2082, 2094, 2004, 1844, 1661, 1506, 1425, 1450, 1586, 1818, 2107, 2403, 2655, 2820, 2875, 2821,
+    2683, 2502, 2330, 2218, 2200, 2291, 2483, 2744, 3026, 3276, 3450, 3516, 3468, 3323, 3118, 2905,
+    2734, 2646, 2664, 2787, 2989, 3227, 3450, 3608, 3665, 3607, 3443, 3206, 2944, 2708, 2544, 2483,
+    2529, 2666, 2855, 3046, 3188, 3240, 3180, 3011, 2757, 2464, 2183, 1963, 1840, 1829, 1918, 2075,
+    2254, 2402, 2474, 2440, 2297, 2062, 1775, 1485, 1245, 1096, 1058, 1130, 1285, 1479, 1662, 1784,
+    1810, 1727, 1547, 1302, 1040,  814,  669,  633,  712,  885, 1115, 1350, 1540, 1644, 1641, 1535,
+    1352, 1136,  939,  810,  784,  872, 1063, 1324, 1606, 1856, 2031, 2101, 2063, 1936, 1758, 1582,
+    1457, 1423, 1500, 1684, 1948, 2247, 2529, 2744, 2860, 2863, 2765, 2601, 2418, 2268, 2196, 2229,
+    2370, 2599, 2876, 3149, 3369, 3495, 3507, 3410, 3232, 3017, 2817, 2680, 2641, 2709, 2873, 3099,
+    3336, 3534, 3648, 3652, 3542, 3339, 3084, 2828, 2620, 2502, 2491, 2583, 2750, 2947, 3121, 3225,
+    3226, 3114, 2901, 2623, 2328, 2070, 1893, 1821, 1859, 1985, 2159, 2330, 2447, 2472, 2387, 2197,
+    1932, 1637, 1364, 1162, 1064, 1079, 1194, 1374, 1569, 1729, 1809, 1785, 1654, 1438, 1179,  927,
+     734,  638,  656,  783,  988, 1227, 1447, 1601, 1656, 1603, 1457, 1252, 1039,  868,  784,  811,
+     950, 1179, 1456, 1729, 1949, 2078, 2096, 2013, 1856, 1673, 1514, 1428, 1445, 1574, 1800, 2086,
+    2384, 2640, 2812, 2875, 2828, 2694, 2514, 2341, 2223, 2197, 2282, 2468, 2725, 3007, 3261, 3441,
+    3515, 3475, 3335, 3133, 2919, 2743, 2649, 2659, 2776, 2974, 3211, 3436, 3600, 3665, 3614, 3457,
+    3224, 2961, 2722, 2552, 2483, 2523, 2654, 2841, 3034, 3181, 3240, 3188, 3025, 2776, 2484, 2201,
+    1976, 1845, 1826, 1909, 2063, 2242, 2394, 2472, 2446, 2310, 2080, 1795, 1504, 1259, 1102, 1057,
+    1122, 1272, 1466, 1651, 1778, 1812, 1736, 1562, 1320, 1058,  828,  676,  632,  703,  871, 1099,
+    1335, 1530, 1640, 1645, 1545, 1366, 1150,  951,  816,  782,  862, 1048, 1305, 1587, 1841, 2022,
+    2100, 2069, 1947, 1771, 1593, 1463, 1422, 1491, 1669, 1929, 2227, 2511, 2733, 2855, 2866, 2774,
+    2613, 2430, 2276, 2198, 2223, 2357, 2581, 2856, 3132, 3357, 3490, 3510, 3420, 3246, 3032, 2829,
+    2687, 2640, 2701, 2860, 3082, 3321, 3523, 3644, 3656, 3553, 3355, 3102, 2844, 2632, 2507, 2489,
+    2574, 2737, 2934, 3111, 3221, 3230, 3125, 2918, 2643, 2348, 2086, 1902, 1823, 1853, 1975, 2147,
+    2319, 2442, 2474, 2396, 2213, 1951, 1657, 1381, 1173, 1067, 1074, 1183, 1360, 1556, 1720, 1807,
+    1790, 1666, 1455, 1197,  943,  745,  641,  651,  771,  973, 1211, 1434, 1593, 1656, 1610, 1469,
+    1267, 1052,  878,  786,  805,  937, 1161, 1436, 1712, 1937, 2072, 2099, 2021, 1868, 1685, 1523,
+    1431, 1440, 1561, 1782, 2066, 2364, 2625, 2803, 2874, 2834, 2705, 2527, 2351, 2228, 2196, 2272,
+    2452, 2706, 2988, 3246, 3432, 3514, 3481, 3347, 3148, 2933, 2753, 2652, 2655, 2765, 2958, 3195,
+    3423, 3592, 3664, 3621, 3471, 3241, 2979, 2737, 2561, 2484, 2517, 2643, 2828, 3022, 3173, 3239,
+    3195, 3039, 2795, 2505, 2219, 1988, 1851, 1824, 1901, 2052, 2231, 2385, 2470, 2451, 2323, 2098,
+    1815, 1523, 1273, 1110, 1056, 1114, 1260, 1452, 1640, 1772, 1813, 1745, 1576, 1337, 1075,  841,
+     683,  631,  695,  857, 1082, 1320, 1519, 1636, 1648, 1555, 1380, 1165,  963,  823,  781,  853,
+    1032, 1286, 1568, 1826, 2013, 2098, 2074, 1957, 1784, 1604, 1469, 1421, 1483, 1654, 1909, 2206,
+    2493, 2720, 2851, 2869, 2783, 2625, 2442, 2285, 2200, 2218, 2345, 2564, 2837, 3114, 3344, 3484,
+    3512, 3429, 3260, 3046, 2841, 2694, 2640, 2694, 2847, 3066, 3305, 3511, 3639, 3658, 3563, 3371,
+    3120, 2861, 2644, 2512, 2486, 2566, 2725, 2920, 3100, 3216, 3233, 3135, 2934, 2663, 2368, 2102,
+    1911, 1824, 1848, 1964, 2135, 2309, 2436, 2475, 2405, 2228, 1971, 1677, 1398, 1184, 1070, 1070,
+    1173, 1347, 1544, 1711, 1804, 1795, 1677, 1471, 1215,  959,  756,  645,  647,  760,  957, 1195,
+    1420, 1585, 1655, 1617, 1481, 1282, 1066,  887,  789,  800,  925, 1144, 1417, 1694, 1924, 2066,
+    2100, 2029, 1880, 1698, 1533, 1434, 1436, 1550, 1764, 2045, 2344, 2609, 2795, 2873, 2840, 2716,
+    2540, 2362, 2234, 2194, 2264, 2437, 2687, 2969, 3230, 3422, 3512, 3486, 3359, 3163, 2947, 2763,
+    2656, 2651, 2754, 2943, 3178, 3408, 3583, 3662, 3628, 3484, 3259, 2997, 2752, 2570, 2486, 2511,
+    2632, 2814, 3009, 3165, 3238, 3202, 3053, 2814, 2525, 2237, 2001, 1857, 1822, 1893, 2040, 2218,
+    2377, 2467, 2456, 2335, 2116, 1835, 1542, 1288, 1117, 1056, 1107, 1248, 1439, 1628, 1766, 1814,
+    1753, 1590, 1355, 1093,  855,  691,  631,  687,  844, 1066, 1304, 1507, 1631, 1651, 1564, 1393,
+    1180,  975,  829,  780,  845, 1017, 1267, 1549, 1810, 2003, 2096, 2079, 1967, 1796, 1615, 1476,
+    1421, 1475, 1639, 1890, 2186, 2475, 2708, 2845, 2871, 2792, 2637, 2454, 2293, 2203, 2213, 2333,
+    2546, 2818, 3096, 3331, 3478, 3514, 3438, 3273, 3061, 2854, 2701, 2640, 2687, 2834, 3050, 3289,
+    3499, 3633, 3661, 3573, 3387, 3138, 2878, 2657, 2518, 2485, 2557, 2712, 2907, 3090, 3211, 3235,
+    3146, 2951, 2683, 2387, 2118, 1921, 1827, 1843, 1954, 2122, 2298, 2430, 2476, 2413, 2243, 1990,
+    1697, 1416, 1196, 1075, 1067, 1164, 1334, 1531, 1702, 1801, 1799, 1689, 1487, 1233,  976,  767,
+     649,  643,  749,  942, 1178, 1406, 1577, 1654, 1623, 1493, 1296, 1080,  897,  793,  796,  913,
+    1126, 1398, 1676, 1911, 2060, 2102, 2037, 1892, 1710, 1542, 1438, 1432, 1538, 1747, 2025, 2325,
+    2593, 2785, 2871, 2846, 2727, 2552, 2373, 2240, 2194, 2255, 2422, 2668, 2950, 3214, 3412, 3509,
+    3492, 3370, 3177, 2961, 2773, 2660, 2648, 2744, 2928, 3162, 3394, 3574, 3661, 3634, 3497, 3276,
+    3015, 2767, 2580, 2488, 2506, 2621, 2801, 2997, 3157, 3236, 3208, 3066, 2832, 2545, 2256, 2015,
+    1863, 1821, 1885, 2028, 2206, 2368, 2464, 2461, 2346, 2133, 1855, 1561, 1303, 1126, 1057, 1100,
+    1236, 1425, 1616, 1759, 1814, 1761, 1604, 1373, 1110,  870,  699,  631,  680,  830, 1050, 1289,
+    1495, 1626, 1653, 1573, 1407, 1195,  988,  837,  780,  837, 1002, 1249, 1530, 1794, 1993, 2093,
+    2084, 1977, 1809, 1627, 1483, 1421, 1468, 1625, 1871, 2165, 2457, 2694, 2839, 2873, 2800, 2649,
+    2466, 2303, 2206, 2209, 2321, 2530, 2798, 3078, 3317, 3471, 3515, 3446, 3286, 3076, 2867, 2709,
+    2641, 2680, 2821, 3034, 3273, 3487, 3627, 3663, 3583, 3402, 3156, 2895, 2669, 2524, 2483, 2549,
+    2700, 2893, 3079, 3206, 3237, 3155, 2967, 2702, 2407, 2134, 1931, 1830, 1839, 1944, 2110, 2287,
+    2423, 2476, 2421, 2258, 2009, 1717, 1433, 1208, 1079, 1064, 1154, 1321, 1517, 1692, 1797, 1803,
+    1699, 1503, 1251,  992,  779,  653,  640,  739,  927, 1162, 1392, 1568, 1652, 1628, 1504, 1311,
+    1095,  908,  797,  792,  902, 1110, 1378, 1658, 1897, 2053, 2102, 2045, 1904, 1723, 1552, 1442,
+    1429, 1528, 1730, 2005, 2305, 2577, 2775, 2869, 2851, 2737, 2565, 2385, 2247, 2194, 2248, 2408,
+    2650, 2930, 3198, 3402, 3506, 3497, 3381, 3192, 2975, 2784, 2664, 2646, 2734, 2914, 3145, 3379,
+    3564, 3658, 3639, 3509, 3293, 3033, 2782, 2590, 2491, 2502, 2611, 2788, 2984, 3148, 3234, 3213,
+    3079, 2851, 2565, 2274, 2029, 1870, 1820, 1878, 2017, 2194, 2358, 2460, 2464, 2358, 2150, 1875,
+    1581, 1319, 1135, 1058, 1094, 1225, 1412, 1604, 1752, 1813, 1768, 1618, 1390, 1128,  884,  707,
+     632,  673,  817, 1033, 1273, 1483, 1620, 1654, 1581, 1420, 1210, 1001,  844,  780,  829,  988,
+    1230, 1511, 1778, 1982, 2090, 2088, 1987, 1821, 1639, 1491, 1422, 1461, 1611, 1852, 2145, 2438,
+    2681, 2833, 2874, 2808, 2661, 2479, 2312, 2210, 2205, 2310, 2513, 2779, 3060, 3303, 3464, 3516,
+    3454, 3299, 3091, 2880, 2717, 2642, 2674, 2809, 3018, 3257, 3474, 3621, 3664, 3592, 3417, 3174,
+    2912, 2683, 2531, 2483, 2542, 2688, 2880, 3067, 3200, 3239, 3164, 2983, 2722, 2427, 2151, 1942,
+    1833, 1835, 1935, 2098, 2275, 2416, 2475, 2428, 2272, 2028, 1737, 1451, 1221, 1085, 1061, 1145,
+    1308, 1504, 1682, 1793, 1806, 1710, 1519, 1269, 1009,  791,  658,  637,  729,  912, 1145, 1378,
+    1558, 1650, 1633, 1515, 1325, 1109,  919,  801,  789,  891, 1093, 1359, 1640, 1883, 2046, 2102,
+    2051, 1915, 1735, 1562, 1447, 1426, 1517, 1714, 1985, 2284, 2560, 2765, 2866, 2855, 2747, 2578,
+    2396, 2254, 2194, 2241, 2394, 2632, 2911, 3181, 3391, 3503, 3501, 3392, 3206, 2990, 2796, 2670,
+    2643, 2725, 2899, 3129, 3364, 3554, 3655, 3644, 3521, 3309, 3051, 2798, 2600, 2495, 2498, 2601,
+    2774, 2971, 3139, 3231, 3218, 3092, 2869, 2586, 2293, 2043, 1878, 1820, 1871, 2006, 2182, 2348,
+    2456, 2467, 2368, 2167, 1895, 1600, 1334, 1144, 1059, 1088, 1214, 1398, 1592, 1744, 1812, 1774,
+    1631, 1407, 1146,  899,  716,  634,  666,  805, 1017, 1257, 1471, 1614, 1656, 1590, 1433, 1225,
+    1014,  852,  781,  822,  974, 1212, 1491, 1761, 1971, 2086, 2091, 1996, 1834, 1651, 1499, 1424,
+    1455, 1597, 1833, 2124, 2419, 2667, 2826, 2875, 2815, 2673, 2491, 2322, 2214, 2202, 2300, 2497,
+    2760, 3041, 3289, 3457, 3516, 3462, 3312, 3106, 2894, 2726, 2644, 2668, 2797, 3002, 3241, 3461,
+    3614, 3665, 3600, 3431, 3192, 2929, 2696, 2538, 2482, 2535, 2676, 2866, 3056, 3194, 3239, 3173,
+    2998, 2741, 2447, 2169, 1954, 1837, 1831, 1925, 2086, 2264, 2408, 2475, 2435, 2286, 2047, 1758,
+    1470, 1234, 1090, 1059, 1136, 1295, 1491, 1671, 1788, 1808, 1720, 1534, 1287, 1026,  803,  664,
+     635,  719,  897, 1129, 1363, 1549, 1647, 1638, 1526, 1340, 1124,  930,  806,  786,  880, 1077,
+    1340, 1621, 1869, 2038, 2102, 2058, 1927, 1748, 1573, 1452, 1424, 1508, 1697, 1965, 2264, 2543,
+    2754, 2863, 2860, 2757, 2590, 2408, 2261, 2195, 2234, 2381, 2614, 2892, 3164, 3379, 3499, 3505,
+    3402, 3220, 3005, 2807, 2675, 2642, 2716, 2885, 3112, 3349, 3543, 3652, 3649, 3533, 3326, 3069,
+    2814, 2611, 2498, 2494, 2591, 2761, 2958, 3129, 3228, 3223, 3104, 2886, 2606, 2312, 2058, 1886,
+    1821, 1864, 1994, 2170, 2338, 2451, 2470, 2378, 2183, 1915, 1620, 1351, 1154, 1061, 1083, 1203,
+    1385, 1580, 1736, 1811, 1780, 1644, 1424, 1164,  915,  726,  636,  661,  793, 1001, 1241, 1458,
+    1607, 1656, 1597, 1446, 1240, 1027,  861,  782,  816,  961, 1194, 1472, 1744, 1959, 2082, 2094,
+    2006, 1846, 1663, 1507, 1426, 1449, 1584, 1815, 2103, 2400, 2652, 2819, 2875, 2822, 2685, 2504,
+    2332, 2218, 2199, 2290, 2481, 2741, 3023, 3274, 3448, 3516, 3469, 3325, 3121, 2907, 2735, 2646,
+};
+
+#endif //SYNTHPATHY_AUDIO_INPUT_TEST_SIGNAL_H_
\ No newline at end of file
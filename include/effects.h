@@ -0,0 +1,84 @@
+/**
+ * Synthpathy is a small and versatile audio synthesizer on a microcontroler. 
+ * Copyright (C) 2022  Brice Croix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SYNTHPATHY_EFFECTS_H_
+#define SYNTHPATHY_EFFECTS_H_
+
+#include "EffectsChain.hpp"
+#include "Biquad.h"
+#include "Waveshaper.h"
+#include "Delay.h"
+#include "Reverb.hpp"
+#include "StereoEffects.hpp"
+
+/**
+ * @brief The effects applied on the sum of all notes, in processing order.
+ * In stereo, the filter and the waveshaper are duplicated on each channel,
+ * while the delay and the reverberation are shared so that their memory budget is unchanged.
+ */
+#ifdef AUDIO_STEREO
+typedef EffectsChain<DualMono<DynamicBiquad>, DualMono<Waveshaper>, SharedMono<Delay>, SharedMono<Reverb<REVERB_QUALITY_MEDIUM>>> MasterEffectsChain;
+#else
+typedef EffectsChain<DynamicBiquad, Waveshaper, Delay, Reverb<REVERB_QUALITY_MEDIUM>> MasterEffectsChain;
+#endif
+
+/**
+ * @brief The position of each effect in MasterEffectsChain.
+ * @{
+ */
+constexpr unsigned int EFFECT_LOW_PASS_IDX = 0;
+constexpr unsigned int EFFECT_WAVESHAPER_IDX = 1;
+constexpr unsigned int EFFECT_DELAY_IDX = 2;
+constexpr unsigned int EFFECT_REVERB_IDX = 3;
+/**@}*/
+
+/**
+ * @brief Get the low-pass filter of the master effects chain for a given channel.
+ * 
+ * @param effects The master effects chain.
+ * @param channel The channel, lower than NB_AUDIO_CHANNELS.
+ * @return DynamicBiquad& 
+ */
+inline DynamicBiquad& get_master_low_pass(MasterEffectsChain& effects, unsigned int channel)
+{
+    #ifdef AUDIO_STEREO
+    return effects.get_effect<EFFECT_LOW_PASS_IDX>().get_channel(channel);
+    #else
+    (void)channel;
+    return effects.get_effect<EFFECT_LOW_PASS_IDX>();
+    #endif
+}
+
+/**
+ * @brief Get the waveshaper of the master effects chain for a given channel.
+ * 
+ * @param effects The master effects chain.
+ * @param channel The channel, lower than NB_AUDIO_CHANNELS.
+ * @return Waveshaper& 
+ */
+inline Waveshaper& get_master_waveshaper(MasterEffectsChain& effects, unsigned int channel)
+{
+    #ifdef AUDIO_STEREO
+    return effects.get_effect<EFFECT_WAVESHAPER_IDX>().get_channel(channel);
+    #else
+    (void)channel;
+    return effects.get_effect<EFFECT_WAVESHAPER_IDX>();
+    #endif
+}
+
+#endif //SYNTHPATHY_EFFECTS_H_
\ No newline at end of file
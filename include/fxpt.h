@@ -332,6 +332,26 @@ inline fxpt_Q0_31 fxpt_sin(fxpt_Q21_10 x)
  */
 #define fxpt_cos(x) fxpt_sin((x) + (FXPT_SINE_PERIOD/4))
 
+/**
+ * @brief Fixed-point sine function of period 2^32, linearly interpolated between the entries of the look-up table.
+ * Unlike fxpt_sin the whole phase is used, the error being lower than 2^-17.
+ * @param phase The phase in the period, a full period being 2^32.
+ * @return fxpt_Q0_31 
+ */
+inline fxpt_Q0_31 fxpt_sin_interp(fxpt_UQ0_32 phase)
+{
+    // Entry k of the period of fxpt_sin is the sine of (k+0.5)/FXPT_SINE_PERIOD, hence the shift of half a step
+    constexpr unsigned int l_shift = 32 - 10;
+    static_assert((1UL << (32 - l_shift)) == FXPT_SINE_PERIOD, "The phase index must cover the period of fxpt_sin");
+    const fxpt_UQ0_32 l_phase = phase - (1U << (l_shift - 1));
+    const fxpt_Q21_10 l_idx = l_phase >> l_shift;
+    const fxpt_Q0_31 l_a = fxpt_sin(l_idx);
+    const fxpt_Q0_31 l_b = fxpt_sin(l_idx + 1);
+    // The difference of two entries is below 2^24, the product of its 16 most significant bits with a Q0.15 fraction fits in 32 bits
+    const fxpt_Q0_15 l_frac = (l_phase >> (l_shift - 15)) & 0x7FFF;
+    return l_a + fxpt_convert_n(fxpt_convert_n(l_b - l_a, 8, 0) * l_frac, 7, 0);
+}
+
 /**
  * @brief Base two logarithm on integers.
  * This actually returns the position of the mostly significant 1 bit.
@@ -352,6 +372,32 @@ inline unsigned int fxpt_log2(unsigned int x)
     return res;
 }
 
+/**
+ * @brief The ratio of two unsigned integers in UQ17.15, using only a 32 bits division.
+ * Unlike 64 bits divisions, it is computed by the hardware divider of the RP2040.
+ * The operands are truncated when den needs more than 17 bits, which keeps at least 16 significant bits.
+ * @param num The numerator, lower or equal to den.
+ * @param den The denominator, strictly positive.
+ * @return fxpt_UQ17_15 The ratio between 0 and 1 included.
+ */
+inline fxpt_UQ17_15 fxpt_ratio_q15(unsigned int num, unsigned int den)
+{
+    // 31 - clz is the position of the most significant bit, like fxpt_log2 but in a single instruction
+    const unsigned int l_shift = (den >> 17) ? (31 - __builtin_clz(den)) - 16 : 0;
+    return fxpt_dec_step(num >> l_shift, 15) / (den >> l_shift);
+}
+
+/**
+ * @brief The largest power of two lower or equal to x.
+ * 
+ * @param x A strictly positive integer.
+ * @return unsigned int 
+ */
+constexpr unsigned int fxpt_floor_pow2(unsigned int x)
+{
+    return (x <= 1) ? 1 : 2 * fxpt_floor_pow2(x / 2);
+}
+
 /**
  * @brief Decimal precision of base two logarithm on 8 bits integers.
  * log2int is written on 3 bits (log2(8) = 3), it remains 5 bits for more precision.
@@ -25,6 +25,7 @@
 #include "CircularBuffer.hpp"
 #include "midi.h"
 #include "fxpt.h"
+#include "EngineConfig.h"
 
 // Global constants ------------------------------------------------------------
 
@@ -32,7 +33,7 @@
  * @brief The System clock frequency in kHz, required for overclocking.
  * 
  */
-constexpr unsigned int SYSTEM_CLOCK_FREQUENCY_KHZ = 192000U;
+constexpr unsigned int SYSTEM_CLOCK_FREQUENCY_KHZ = ENGINE_CONFIG.system_clock_frequency_khz;
 
 /**
  * @brief The number of midi events that can be stored in the midi buffer.
@@ -44,20 +45,19 @@ constexpr unsigned int SIZE_MIDI_BUFFER = 4;
  * @brief The number of bits used by one channel the pwm audio output slice.
  * 
  */
-constexpr unsigned int PWM_AUDIO_BIT_DEPTH_PER_CHANNEL = 8;
+constexpr unsigned int PWM_AUDIO_BIT_DEPTH_PER_CHANNEL = ENGINE_CONFIG.pwm_audio_bit_depth_per_channel;
 
 /**
  * @brief The clock divider used by the pwm audio output.
- * NB : 192MHz / (16*256) = 46875 Hz of sampling frequency. 
+ * NB : 192MHz / (16*256) = 46875 Hz of sampling frequency with the default configuration, see EngineConfig.
  */
-constexpr unsigned int PWM_AUDIO_CLK_DIVIDER = 16;
+constexpr unsigned int PWM_AUDIO_CLK_DIVIDER = ENGINE_CONFIG.pwm_audio_clk_divider;
 
 /**
  * @brief The actual sampling frequency used for sample-based computation.
  * Variables given in sampling ticks refer to a number of periods of this frequency.
  */
-constexpr unsigned int AUDIO_SAMPLING_FREQUENCY = (SYSTEM_CLOCK_FREQUENCY_KHZ*1000)
-    / (PWM_AUDIO_CLK_DIVIDER * (1<<PWM_AUDIO_BIT_DEPTH_PER_CHANNEL));
+constexpr unsigned int AUDIO_SAMPLING_FREQUENCY = ENGINE_CONFIG.get_sampling_frequency();
 
 /**
  * @brief The size of the audio buffer in milliseconds.
@@ -71,6 +71,47 @@ constexpr unsigned int SIZE_AUDIO_BUFFER_MS = 8;
  */
 constexpr unsigned int SIZE_AUDIO_BUFFER = AUDIO_SAMPLING_FREQUENCY * SIZE_AUDIO_BUFFER_MS / 1000;
 
+/**
+ * @brief The number of audio output channels, 2 when compiled with AUDIO_STEREO.
+ * Stereo samples are interleaved, left channel first.
+ */
+constexpr unsigned int NB_AUDIO_CHANNELS =
+#ifdef AUDIO_STEREO
+    2;
+#else
+    1;
+#endif
+
+/**
+ * @brief The number of samples computed at once, between two updates at control rate.
+ * Must be a power of two, and smaller than SIZE_AUDIO_BUFFER.
+ */
+constexpr unsigned int SIZE_AUDIO_BLOCK = ENGINE_CONFIG.size_audio_block;
+
+static_assert(SIZE_AUDIO_BLOCK < SIZE_AUDIO_BUFFER, "An audio block must fit in the audio buffer");
+
+/**
+ * @brief The oversampling factor of the voice bus, 2 or 4 when compiled with AUDIO_OVERSAMPLING, 1 otherwise.
+ * The oscillators of the notes are then rendered at OVERSAMPLING_FACTOR * AUDIO_SAMPLING_FREQUENCY,
+ * and the mix is decimated back to AUDIO_SAMPLING_FREQUENCY before the effects.
+ */
+constexpr unsigned int OVERSAMPLING_FACTOR =
+#ifdef AUDIO_OVERSAMPLING
+    AUDIO_OVERSAMPLING;
+#else
+    1;
+#endif
+
+#if defined(AUDIO_OVERSAMPLING) && AUDIO_OVERSAMPLING != 2 && AUDIO_OVERSAMPLING != 4
+#error "AUDIO_OVERSAMPLING must be 2 or 4"
+#endif
+
+/**
+ * @brief The rate in Hertz at which parameters are updated, once per audio block.
+ * 
+ */
+constexpr unsigned int CONTROL_RATE_HZ = ENGINE_CONFIG.get_control_rate();
+
 /**
  * @brief The ADC base clock in Hertz according to pico documentation.
  * A complete conversion takes 96 cycles, so at maximum speed,
@@ -79,22 +120,109 @@ constexpr unsigned int SIZE_AUDIO_BUFFER = AUDIO_SAMPLING_FREQUENCY * SIZE_AUDIO
 constexpr unsigned int ADC_BASE_CLOCK_HZ = 48e6;
 
 /**
- * @brief The refresh rate of the Controls potentiometers in Hertz.
- * Note that each potentiometer is refreshed at a time, and refresh rate for
- * each potentiometer is then POTENTIOMETERS_REFRESH_RATE_HZ / NB_PIN_POTENTIOMETERS.
+ * @brief The number of ADC channels converted in round-robin.
+ * All four external channels are converted so that the DMA ring buffer holds a whole number
+ * of rounds, ADC3 being only used by the audio input when compiled with AUDIO_INPUT.
+ */
+constexpr unsigned int NB_ADC_CHANNELS = 4;
+
+/**
+ * @brief The ADC channel sampling the audio input, when compiled with AUDIO_INPUT.
+ * 
+ */
+constexpr unsigned int ADC_AUDIO_INPUT_IDX = 3;
+
+/**
+ * @brief The conversion rate of the ADC in Hertz.
+ * Note that channels are converted one at a time, and refresh rate for
+ * each channel is then POTENTIOMETERS_REFRESH_RATE_HZ / NB_ADC_CHANNELS.
+ * With the audio input, each channel is converted at AUDIO_SAMPLING_FREQUENCY (48MHz / 256 = 187.5kHz in total at 46875Hz).
  */
 constexpr unsigned int POTENTIOMETERS_REFRESH_RATE_HZ =
 #if (DEBUG == 3)
     1;
+#elif defined(AUDIO_INPUT)
+    NB_ADC_CHANNELS * AUDIO_SAMPLING_FREQUENCY;
 #else
     5000;
 #endif
 
+static_assert(POTENTIOMETERS_REFRESH_RATE_HZ <= ADC_BASE_CLOCK_HZ / 96, "The ADC cannot convert faster than 500kHz");
+
+/**
+ * @brief The number of ADC samples averaged for each channel.
+ * Must be a power of two.
+ * With the audio input, the ring buffer holds two audio blocks, one being read while the other is written by the DMA.
+ */
+constexpr unsigned int ADC_OVERSAMPLING =
+#ifdef AUDIO_INPUT
+    2 * SIZE_AUDIO_BLOCK;
+#else
+    16;
+#endif
+
+/**
+ * @brief The number of audio blocks pushed in the output buffer before starting, when compiled with AUDIO_INPUT.
+ * The output starts with the first input block, the rendering is then paced by the input : this is the latency
+ * added by the output buffer, a block being rendered in less than a block of time.
+ */
+constexpr unsigned int AUDIO_INPUT_OUTPUT_BLOCKS = 1;
+
+/**
+ * @brief The size of the ADC ring buffer filled by the DMA, in number of samples.
+ * 
+ */
+constexpr unsigned int SIZE_ADC_RING_BUFFER = NB_ADC_CHANNELS * ADC_OVERSAMPLING;
+
 /**
  * @brief The transition duration used by the dynamic filter, in number of samples.
- * The longer the smoother.
+ * Filter parameters are already smoothed at control rate, a transition only has to span one audio block.
+ */
+constexpr unsigned int DYNAMIC_FILTER_TRANSITION_FS = SIZE_AUDIO_BLOCK;
+
+/**
+ * @brief The memory allocated to the delay effect in bytes.
+ * The delay line actually uses the largest power of two of samples fitting in this budget.
  */
-constexpr unsigned int DYNAMIC_FILTER_TRANSITION_FS = AUDIO_SAMPLING_FREQUENCY * 0.01;
+constexpr unsigned int DELAY_MEMORY_BUDGET_BYTES = 64 * 1024;
+
+/**
+ * @brief The memory allocated to the reverberation effect in bytes.
+ * The number of delay lines of the reverberation depends on its quality, which must fit in this budget.
+ * The lines being tuned in seconds, it is 32kB at 46875Hz and follows the sampling frequency.
+ */
+constexpr unsigned int REVERB_MEMORY_BUDGET_BYTES = (unsigned int)((uint64_t)32 * 1024 * AUDIO_SAMPLING_FREQUENCY / 46875);
+
+/**
+ * @brief The number of samples of the delay line of each plucked string, a power of two.
+ * It sets the lowest pitch of a string, about 46Hz (F#1) at 46875Hz, lower notes being played at that pitch.
+ */
+constexpr unsigned int PLUCK_DELAY_LINE_SIZE = 1024;
+
+/**
+ * @brief The offset in flash of the bank of samples, written by python_scripts/sample_bank.py.
+ * The program must stay below it, the samples being read in place through the XIP window : src/sample_bank.ld
+ * repeats this offset, so that the link fails otherwise.
+ */
+constexpr unsigned int SAMPLE_BANK_FLASH_OFFSET = 1024 * 1024;
+
+/**
+ * @brief The number of decoded frames buffered by each voice playing an ADPCM sample, a power of two.
+ * A block of audio cannot read more frames, which limits the pitch to about 3 octaves above the root of the sample.
+ */
+constexpr unsigned int SAMPLE_ADPCM_RING_SIZE = 8 * SIZE_AUDIO_BLOCK;
+
+/**
+ * @brief The memory allocated to the cache of the attacks and decays of the notes in bytes, see NoteCache.
+ * It is shared by NOTE_CACHE_NB_ENTRIES notes, the end of the longer envelopes being synthesized live.
+ */
+constexpr unsigned int NOTE_CACHE_MEMORY_BUDGET_BYTES = 32 * 1024;
+
+/**
+ * @brief The number of notes whose attack and decay can be cached at the same time.
+ * 
+ */
+constexpr unsigned int NOTE_CACHE_NB_ENTRIES = 8;
 
 
 // Global variables ------------------------------------------------------------
@@ -112,16 +240,16 @@ extern volatile unsigned int g_time_fs;
 extern CircularBuffer<MidiEvent, SIZE_MIDI_BUFFER> g_midi_internal_buffer;
 
 /**
- * @brief The analog value of the audio output.
+ * @brief The analog value of the audio output, the channels being interleaved.
  * 
  */
-extern CircularBuffer<fxpt_Q0_31, SIZE_AUDIO_BUFFER> g_output_audio_buffer;
+extern CircularBuffer<fxpt_Q0_31, SIZE_AUDIO_BUFFER * NB_AUDIO_CHANNELS> g_output_audio_buffer;
 
 
 // GPIO pins assignation -------------------------------------------------------
 
 /**
- * @brief The GPIO pins used for the audio PWM output.
+ * @brief The GPIO pins used for the audio PWM output, or for the left channel when compiled with AUDIO_STEREO.
  * These pins are connected to PWM Channel 1 (slice 1, channel 0 and 1).
  * PIN_PWM_AUDIO_OUTPUT_L takes bits 0 to 7 of the audio value (Low byte).
  * PIN_PWM_AUDIO_OUTPUT_H takes bits 8 to 15 of the audio value (High byte).
@@ -137,6 +265,21 @@ constexpr unsigned int PIN_PWM_AUDIO_OUTPUT_H = 3;
  */
 constexpr unsigned int SLICE_PWM_AUDIO_OUTPUT = 1;
 
+/**
+ * @brief The GPIO pins used for the right channel of the audio PWM output, only when compiled with AUDIO_STEREO.
+ * These pins are connected to PWM Channel 0 (slice 0, channel 0 and 1), and share the bytes as the left channel does.
+ * @{
+ */
+constexpr unsigned int PIN_PWM_AUDIO_OUTPUT_RIGHT_L = 0;
+constexpr unsigned int PIN_PWM_AUDIO_OUTPUT_RIGHT_H = 1;
+/**@}*/
+
+/**
+ * @brief The slice associated with the right channel audio PWM pins.
+ * NB : equivalent to pwm_gpio_to_slice_num(PIN_PWM_AUDIO_OUTPUT_RIGHT_L).
+ */
+constexpr unsigned int SLICE_PWM_AUDIO_OUTPUT_RIGHT = 0;
+
 /**
  * @brief The GPIO pin associated with the midi output.
  * This pin is connected to UART1_TX.
@@ -203,5 +346,11 @@ constexpr unsigned int NB_PIN_POTENTIOMETERS = 3;
  */
 constexpr unsigned int PIN_POTENTIOMETERS[NB_PIN_POTENTIOMETERS] = {26,27,28};
 
+/**
+ * @brief The GPIO pin used by the audio input, when compiled with AUDIO_INPUT.
+ * This pin is connected to ADC3. NB : on the Pico board it measures VSYS/3, it must be rewired to be used as an input.
+ */
+constexpr unsigned int PIN_AUDIO_INPUT = 29;
+
 
 #endif //SYNTHPATHY_GLOBAL_H_
\ No newline at end of file
@@ -0,0 +1,88 @@
+/**
+ * Synthpathy is a small and versatile audio synthesizer on a microcontroler. 
+ * Copyright (C) 2022  Brice Croix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SYNTHPATHY_LIMITER_CURVE_H_
+#define SYNTHPATHY_LIMITER_CURVE_H_
+
+#include "fxpt.h"
+
+/*
+ * The soft knee of the master bus limiter, generated by python_scripts/limiter_curve.py.
+ * This table is const so that it stays in flash.
+ */
+
+/**
+ * @brief The number of segments of the knee, must be a power of two.
+ * 
+ */
+constexpr unsigned int LIMITER_LUT_SIZE = 256;
+
+/**
+ * @brief The level above which the knee rounds the top of the signal, 127/128 in Q0.31 : the peak of a single
+ * note at full velocity, which is left untouched.
+ */
+constexpr fxpt_Q0_31 LIMITER_THRESHOLD = 0x7F << 24;
+
+/**
+ * @brief The span of the input levels covered by the knee, from LIMITER_THRESHOLD to full scale, in Q0.31.
+ * The gain reduction of the limiter keeps the levels below full scale.
+ */
+constexpr fxpt_Q0_31 LIMITER_KNEE_SPAN = (1U << 31) - LIMITER_THRESHOLD;
+
+/**
+ * @brief Soft knee of the limiter, t + (1-t) * tanh((x-t) / (1-t)), t being LIMITER_THRESHOLD.
+ * Value i is the image of LIMITER_THRESHOLD + LIMITER_KNEE_SPAN*i/LIMITER_LUT_SIZE.
+ */
+const fxpt_Q0_31 LIMITER_KNEE_LUT[LIMITER_LUT_SIZE + 1] =
+{
+     2130706432,  2130771968,  2130837501,  2130903031,  2130968555,  2131034070,  2131099576,  2131165070,
+     2131230549,  2131296013,  2131361459,  2131426885,  2131492289,  2131557668,  2131623022,  2131688349,
+     2131753645,  2131818909,  2131884140,  2131949335,  2132014492,  2132079609,  2132144685,  2132209717,
+     2132274704,  2132339643,  2132404533,  2132469372,  2132534158,  2132598888,  2132663561,  2132728176,
+     2132792729,  2132857220,  2132921646,  2132986006,  2133050298,  2133114520,  2133178669,  2133242745,
+     2133306745,  2133370668,  2133434511,  2133498273,  2133561953,  2133625548,  2133689056,  2133752477,
+     2133815807,  2133879046,  2133942191,  2134005242,  2134068195,  2134131051,  2134193806,  2134256459,
+     2134319009,  2134381453,  2134443791,  2134506020,  2134568140,  2134630147,  2134692042,  2134753822,
+     2134815485,  2134877031,  2134938457,  2134999762,  2135060945,  2135122004,  2135182938,  2135243744,
+     2135304422,  2135364971,  2135425388,  2135485673,  2135545824,  2135605839,  2135665717,  2135725458,
+     2135785059,  2135844519,  2135903837,  2135963011,  2136022041,  2136080925,  2136139662,  2136198251,
+     2136256689,  2136314977,  2136373113,  2136431096,  2136488924,  2136546597,  2136604113,  2136661472,
+     2136718671,  2136775711,  2136832590,  2136889307,  2136945860,  2137002250,  2137058474,  2137114533,
+     2137170424,  2137226148,  2137281702,  2137337087,  2137392301,  2137447343,  2137502213,  2137556909,
+     2137611432,  2137665779,  2137719950,  2137773945,  2137827762,  2137881402,  2137934862,  2137988142,
+     2138041243,  2138094162,  2138146899,  2138199454,  2138251826,  2138304015,  2138356019,  2138407838,
+     2138459471,  2138510919,  2138562180,  2138613253,  2138664139,  2138714837,  2138765346,  2138815666,
+     2138865796,  2138915737,  2138965486,  2139015045,  2139064412,  2139113587,  2139162571,  2139211362,
+     2139259960,  2139308364,  2139356576,  2139404593,  2139452417,  2139500046,  2139547480,  2139594720,
+     2139641764,  2139688613,  2139735267,  2139781724,  2139827986,  2139874052,  2139919921,  2139965595,
+     2140011071,  2140056351,  2140101435,  2140146321,  2140191011,  2140235504,  2140279799,  2140323898,
+     2140367800,  2140411504,  2140455012,  2140498322,  2140541436,  2140584352,  2140627072,  2140669594,
+     2140711920,  2140754049,  2140795981,  2140837717,  2140879257,  2140920600,  2140961747,  2141002697,
+     2141043452,  2141084012,  2141124375,  2141164544,  2141204517,  2141244295,  2141283879,  2141323268,
+     2141362463,  2141401464,  2141440271,  2141478885,  2141517305,  2141555533,  2141593568,  2141631410,
+     2141669061,  2141706519,  2141743787,  2141780863,  2141817749,  2141854444,  2141890949,  2141927265,
+     2141963392,  2141999329,  2142035078,  2142070639,  2142106012,  2142141198,  2142176197,  2142211010,
+     2142245637,  2142280078,  2142314334,  2142348405,  2142382292,  2142415996,  2142449516,  2142482853,
+     2142516008,  2142548982,  2142581773,  2142614384,  2142646815,  2142679066,  2142711138,  2142743030,
+     2142774745,  2142806282,  2142837641,  2142868824,  2142899831,  2142930662,  2142961319,  2142991800,
+     2143022108,  2143052243,  2143082205,  2143111995,  2143141613,  2143171060,  2143200337,  2143229444,
+     2143258381,  2143287150,  2143315751,  2143344185,  2143372451,  2143400552,  2143428486,  2143456256,
+     2143483862,
+};
+
+#endif //SYNTHPATHY_LIMITER_CURVE_H_
\ No newline at end of file
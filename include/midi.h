@@ -73,7 +73,10 @@ constexpr MidiByte MIDI_NOTE_OFF = 0x90;
  */
 constexpr MidiByte MIDI_AFTERTOUCH_NOTE = 0xA0;
 
-
+/**
+ * @brief A midi status byte for a controller change, on channel 0;
+ * Data byte 0 is the controller number and data byte 1 is its value.
+ */
 constexpr MidiByte MIDI_CONTROLLER_CHANGE = 0xB0;
 
 
@@ -85,9 +88,19 @@ constexpr MidiByte MIDI_PROGRAM_CHANGE = 0xC0;
  */
 constexpr MidiByte MIDI_AFTERTOUCH_CHANNEL = 0xD0;
 
-
+/**
+ * @brief A midi status byte for pitch bend on a whole channel, on channel 0;
+ * Data byte 0 is the 7 least significant bits and data byte 1 the 7 most significant bits
+ * of the bend, centered on MIDI_PITCH_BEND_CENTER.
+ */
 constexpr MidiByte MIDI_PITCH_BEND = 0xE0;
 
+/**
+ * @brief The 14 bits value of a pitch bend event when the wheel is at rest.
+ * 
+ */
+constexpr unsigned int MIDI_PITCH_BEND_CENTER = 0x2000;
+
 // constexpr uint8_t MIDI_NOTES[] = {
 //     0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, //C-1 to B-1
 //     0x0c, 0x0d, 0x0e, 0x0f, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, //C0 to B0
@@ -30,31 +30,40 @@
 /**
  * @brief Value of a square wave of given parameters.
  * 
- * @param time The time in number of samples.
- * @param period The period in number of samples.
+ * @param phase The phase in the period, a full period being 2^32.
  * @param duty_cycle The duty cycle between 0 and 1.
  * @return fxpt_Q0_31 
  */
-inline fxpt_Q0_31 square_wave(unsigned int time, unsigned int period, fxpt_Q0_31 duty_cycle = (1<<30))
+inline fxpt_Q0_31 square_wave(fxpt_UQ0_32 phase, fxpt_Q0_31 duty_cycle = (1<<30))
 {
     constexpr fxpt_Q0_31 l_one = std::numeric_limits<fxpt_Q0_31>::max();
-    return ((time % period) < fxpt_convert_n((fxpt64_t)period * (fxpt64_t)duty_cycle, 31, 0)) ? l_one : -l_one;
+    // The duty cycle in Q0.31 is positive, it can be converted to UQ0.32 without loss
+    return (phase < fxpt_convert_n((fxpt_UQ0_32)duty_cycle, 31, 32)) ? l_one : -l_one;
 }
 
 /**
  * @brief Value of a rising wave of given parameters.
  * 
- * @param time The time in number of samples.
- * @param period The period in number of samples.
+ * @param phase The phase in the period, a full period being 2^32.
  * @param reserved Unused parameter.
  * @return fxpt_Q0_31 
  */
-inline fxpt_Q0_31 saw_wave(unsigned int time, unsigned int period, fxpt_Q0_31 reserved = 0)
+inline fxpt_Q0_31 saw_wave(fxpt_UQ0_32 phase, fxpt_Q0_31 reserved = 0)
 {
-    // return 2. * ((static_cast<float>(time % period) / period) - 0.5f);
+    // return 2. * (phase - 0.5f);
+    return fxpt32_signed_unsigned_map(phase);
+}
 
-    // longest period takes about 13 bits, it is safe to convert to UQ16.16
-    return 2 * (static_cast<fxpt_Q0_31>(fxpt_convert_n(fxpt_dec_step(time % period, 16) / period, 16, 31)) - fxpt_Q0_31(1<<30));
+/**
+ * @brief Value of a sine wave of given parameters.
+ * 
+ * @param phase The phase in the period, a full period being 2^32.
+ * @param reserved Unused parameter.
+ * @return fxpt_Q0_31 
+ */
+inline fxpt_Q0_31 sine_wave(fxpt_UQ0_32 phase, fxpt_Q0_31 /*reserved*/ = 0)
+{
+    return fxpt_sin_interp(phase);
 }
 
 
@@ -0,0 +1,110 @@
+/**
+ * Synthpathy is a small and versatile audio synthesizer on a microcontroler. 
+ * Copyright (C) 2022  Brice Croix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SYNTHPATHY_WAVESHAPER_CURVES_H_
+#define SYNTHPATHY_WAVESHAPER_CURVES_H_
+
+#include "fxpt.h"
+
+/*
+ * The transfer curves of the waveshaper, generated by python_scripts/waveshaper_curves.py.
+ * These tables are const so that they stay in flash.
+ */
+
+/**
+ * @brief The number of segments of each transfer curve, must be a power of two.
+ * 
+ */
+constexpr unsigned int WAVESHAPER_LUT_SIZE = 256;
+
+/**
+ * @brief Hyperbolic tangent transfer curve, tanh(3.0x) / tanh(3.0).
+ * Value i is the image of -1 + 2*i/WAVESHAPER_LUT_SIZE.
+ */
+const fxpt_Q0_15 WAVESHAPER_TANH_LUT[WAVESHAPER_LUT_SIZE + 1] =
+{
+    -32767, -32759, -32751, -32742, -32734, -32724, -32714, -32704, -32693, -32682, -32670, -32658, -32645, -32631, -32617, -32602,
+    -32586, -32570, -32552, -32534, -32516, -32496, -32475, -32453, -32431, -32407, -32382, -32356, -32329, -32300, -32270, -32239,
+    -32206, -32172, -32136, -32098, -32059, -32018, -31975, -31930, -31882, -31833, -31781, -31727, -31670, -31611, -31549, -31484,
+    -31417, -31346, -31272, -31194, -31113, -31028, -30940, -30847, -30751, -30650, -30544, -30434, -30319, -30199, -30074, -29943,
+    -29806, -29664, -29515, -29360, -29199, -29030, -28855, -28672, -28481, -28283, -28076, -27861, -27638, -27405, -27163, -26911,
+    -26650, -26379, -26097, -25805, -25501, -25187, -24861, -24523, -24173, -23811, -23436, -23049, -22649, -22236, -21809, -21369,
+    -20915, -20448, -19967, -19472, -18963, -18440, -17904, -17353, -16789, -16211, -15619, -15014, -14397, -13766, -13123, -12468,
+    -11801, -11122, -10433,  -9734,  -9025,  -8306,  -7580,  -6845,  -6103,  -5355,  -4600,  -3841,  -3078,  -2312,  -1542,   -772,
+         0,    772,   1542,   2312,   3078,   3841,   4600,   5355,   6103,   6845,   7580,   8306,   9025,   9734,  10433,  11122,
+     11801,  12468,  13123,  13766,  14397,  15014,  15619,  16211,  16789,  17353,  17904,  18440,  18963,  19472,  19967,  20448,
+     20915,  21369,  21809,  22236,  22649,  23049,  23436,  23811,  24173,  24523,  24861,  25187,  25501,  25805,  26097,  26379,
+     26650,  26911,  27163,  27405,  27638,  27861,  28076,  28283,  28481,  28672,  28855,  29030,  29199,  29360,  29515,  29664,
+     29806,  29943,  30074,  30199,  30319,  30434,  30544,  30650,  30751,  30847,  30940,  31028,  31113,  31194,  31272,  31346,
+     31417,  31484,  31549,  31611,  31670,  31727,  31781,  31833,  31882,  31930,  31975,  32018,  32059,  32098,  32136,  32172,
+     32206,  32239,  32270,  32300,  32329,  32356,  32382,  32407,  32431,  32453,  32475,  32496,  32516,  32534,  32552,  32570,
+     32586,  32602,  32617,  32631,  32645,  32658,  32670,  32682,  32693,  32704,  32714,  32724,  32734,  32742,  32751,  32759,
+     32767,
+};
+
+/**
+ * @brief Hard clipping transfer curve, 2.0x saturated to [-1, 1].
+ * Value i is the image of -1 + 2*i/WAVESHAPER_LUT_SIZE.
+ */
+const fxpt_Q0_15 WAVESHAPER_HARD_CLIP_LUT[WAVESHAPER_LUT_SIZE + 1] =
+{
+    -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+    -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+    -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+    -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+    -32767, -32255, -31743, -31231, -30719, -30207, -29695, -29183, -28671, -28159, -27647, -27135, -26623, -26111, -25599, -25087,
+    -24575, -24063, -23551, -23039, -22527, -22015, -21503, -20991, -20479, -19967, -19455, -18943, -18431, -17919, -17407, -16895,
+    -16384, -15872, -15360, -14848, -14336, -13824, -13312, -12800, -12288, -11776, -11264, -10752, -10240,  -9728,  -9216,  -8704,
+     -8192,  -7680,  -7168,  -6656,  -6144,  -5632,  -5120,  -4608,  -4096,  -3584,  -3072,  -2560,  -2048,  -1536,  -1024,   -512,
+         0,    512,   1024,   1536,   2048,   2560,   3072,   3584,   4096,   4608,   5120,   5632,   6144,   6656,   7168,   7680,
+      8192,   8704,   9216,   9728,  10240,  10752,  11264,  11776,  12288,  12800,  13312,  13824,  14336,  14848,  15360,  15872,
+     16384,  16895,  17407,  17919,  18431,  18943,  19455,  19967,  20479,  20991,  21503,  22015,  22527,  23039,  23551,  24063,
+     24575,  25087,  25599,  26111,  26623,  27135,  27647,  28159,  28671,  29183,  29695,  30207,  30719,  31231,  31743,  32255,
+     32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+     32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+     32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+     32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+     32767,
+};
+
+/**
+ * @brief Asymmetric fuzz transfer curve, the negative half saturating softer and lower than the positive one.
+ * Value i is the image of -1 + 2*i/WAVESHAPER_LUT_SIZE.
+ */
+const fxpt_Q0_15 WAVESHAPER_FUZZ_LUT[WAVESHAPER_LUT_SIZE + 1] =
+{
+    -19660, -19594, -19526, -19458, -19389, -19319, -19249, -19177, -19105, -19032, -18958, -18883, -18808, -18731, -18653, -18575,
+    -18496, -18415, -18334, -18252, -18169, -18085, -18000, -17913, -17826, -17738, -17649, -17559, -17467, -17375, -17281, -17187,
+    -17091, -16994, -16896, -16797, -16697, -16595, -16493, -16389, -16283, -16177, -16069, -15961, -15850, -15739, -15626, -15512,
+    -15397, -15280, -15162, -15042, -14921, -14799, -14675, -14549, -14423, -14294, -14164, -14033, -13900, -13766, -13630, -13492,
+    -13353, -13212, -13069, -12925, -12779, -12631, -12482, -12331, -12178, -12023, -11867, -11708, -11548, -11386, -11222, -11055,
+    -10887, -10718, -10546, -10372, -10195, -10017,  -9837,  -9655,  -9470,  -9284,  -9095,  -8904,  -8710,  -8515,  -8317,  -8116,
+     -7914,  -7709,  -7501,  -7291,  -7079,  -6864,  -6647,  -6427,  -6204,  -5979,  -5751,  -5521,  -5288,  -5052,  -4813,  -4571,
+     -4327,  -4079,  -3829,  -3576,  -3320,  -3061,  -2798,  -2533,  -2265,  -1993,  -1718,  -1440,  -1159,   -874,   -586,   -295,
+         0,   1264,   2479,   3648,   4772,   5853,   6893,   7892,   8854,   9778,  10668,  11523,  12345,  13136,  13897,  14628,
+     15331,  16008,  16658,  17284,  17886,  18464,  19021,  19556,  20070,  20565,  21041,  21499,  21939,  22363,  22770,  23161,
+     23538,  23900,  24248,  24583,  24905,  25215,  25512,  25799,  26074,  26339,  26594,  26839,  27075,  27301,  27519,  27729,
+     27930,  28124,  28310,  28490,  28662,  28828,  28987,  29141,  29288,  29430,  29566,  29697,  29823,  29945,  30061,  30173,
+     30281,  30385,  30485,  30581,  30673,  30762,  30847,  30929,  31008,  31084,  31157,  31227,  31295,  31360,  31422,  31482,
+     31540,  31595,  31649,  31700,  31750,  31797,  31843,  31887,  31929,  31969,  32009,  32046,  32082,  32117,  32150,  32183,
+     32213,  32243,  32272,  32299,  32326,  32351,  32376,  32399,  32422,  32443,  32464,  32484,  32504,  32522,  32540,  32557,
+     32574,  32590,  32605,  32620,  32634,  32648,  32661,  32673,  32685,  32697,  32708,  32719,  32729,  32739,  32749,  32758,
+     32767,
+};
+
+#endif //SYNTHPATHY_WAVESHAPER_CURVES_H_
\ No newline at end of file
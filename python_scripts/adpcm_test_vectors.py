@@ -0,0 +1,54 @@
+import math
+
+from sample_bank import SAMPLE_ADPCM_BLOCK_FRAMES, adpcm_encode
+
+# These values are copied from "EngineConfig.h", for the default configuration
+AUDIO_SAMPLING_FREQUENCY = 46875
+# Neither the length nor the loop are aligned on the blocks
+ADPCM_TEST_LENGTH = 1000
+ADPCM_TEST_LOOP_START = 300
+
+
+def test_signal():
+    # A sine, full scale steps so that the predictor saturates and the step index reaches its maximum,
+    # then silence so that it comes back to its minimum, and pseudo random noise
+    codes = []
+    seed = 1
+    for i in range(ADPCM_TEST_LENGTH):
+        if i < 300:
+            codes.append(int(round(20000. * math.sin(2. * math.pi * 1000. * i / AUDIO_SAMPLING_FREQUENCY))))
+        elif i < 500:
+            codes.append(32767 if (i // 25) % 2 else -32768)
+        elif i < 700:
+            codes.append(0)
+        else:
+            seed = (1103515245 * seed + 12345) & 0x7FFFFFFF
+            codes.append((seed >> 15) - 32768)
+    return codes
+
+def print_table(c_type, name, size, values, width, nb_columns):
+    print("const " + c_type + " " + name + "[" + size + "] =")
+    print("{")
+    for i in range(0, len(values), nb_columns):
+        print("    " + " ".join(("{:" + str(width) + "d},").format(v) for v in values[i:i+nb_columns]))
+    print("};")
+    print("")
+
+
+######################################## Main Section ##############################################
+
+if __name__ == '__main__':
+    blocks, decoded = adpcm_encode(test_signal())
+    nb_blocks = len(blocks) // (4 + SAMPLE_ADPCM_BLOCK_FRAMES // 2)
+
+    print("/**")
+    print(" * @brief The ADPCM blocks of the test signal, encoded by python_scripts/sample_bank.py.")
+    print(" * They are aligned as in a sample bank.")
+    print(" */")
+    print("alignas(4)", end=" ")
+    print_table("uint8_t", "ADPCM_TEST_BLOCKS", str(nb_blocks) + " * SAMPLE_ADPCM_BLOCK_SIZE", list(blocks), 3, 16)
+    print("/**")
+    print(" * @brief The frames of the test signal decoded by python_scripts/sample_bank.py.")
+    print(" * ")
+    print(" */")
+    print_table("int16_t", "ADPCM_TEST_FRAMES", "ADPCM_TEST_LENGTH", decoded, 6, 12)
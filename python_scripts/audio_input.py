@@ -0,0 +1,52 @@
+import argparse
+import math
+
+from sample_bank import read_wav
+
+# These values are copied from "AudioInput.h" and "EngineConfig.h", for the default configuration
+ADC_BIT_DEPTH = 12
+AUDIO_SAMPLING_FREQUENCY = 46875
+# A whole number of audio blocks, whatever the engine configuration
+NB_FRAMES = 2048
+
+
+def default_signal():
+    # Two sines, the second one being close to the top of the range of the input
+    return [0.5 * math.sin(2. * math.pi * 440. * i / AUDIO_SAMPLING_FREQUENCY)
+        + 0.25 * math.sin(2. * math.pi * 3520. * i / AUDIO_SAMPLING_FREQUENCY) for i in range(NB_FRAMES)]
+
+def to_adc(values, offset):
+    # The input is biased at half the range of the ADC, with an error of offset codes
+    half = 1 << (ADC_BIT_DEPTH - 1)
+    return [max(0, min((1 << ADC_BIT_DEPTH) - 1, half + offset + int(round(v * half)))) for v in values]
+
+def print_table(name, description, codes):
+    print("/**")
+    print(" * @brief " + description)
+    print(" * ")
+    print(" */")
+    print("const uint16_t " + name + "[AUDIO_INPUT_TEST_SIGNAL_LENGTH] =")
+    print("{")
+    for i in range(0, len(codes), 16):
+        print("    " + " ".join("{:4d},".format(c) for c in codes[i:i+16]))
+    print("};")
+    print("")
+
+
+######################################## Main Section ##############################################
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description="Convert a wav file to the raw ADC samples of the audio input, "
+        "for the test of the input path in TESTS_ONLY mode.")
+    parser.add_argument("input", nargs="?", help="The wav file, two sines at 440Hz and 3520Hz being generated when not given. "
+        "Its first " + str(NB_FRAMES) + " frames are used, at AUDIO_SAMPLING_FREQUENCY whatever the rate of the file.")
+    parser.add_argument("--offset", type=int, default=100, help="The error on the bias of the input, in ADC codes (100 by default).")
+    arguments = parser.parse_args()
+
+    if arguments.input is None:
+        values = default_signal()
+    else:
+        values = read_wav(arguments.input)[0][:NB_FRAMES]
+        values += [0.] * (NB_FRAMES - len(values))
+    print_table("AUDIO_INPUT_TEST_SIGNAL", "Raw ADC samples of the audio input, generated by python_scripts/audio_input.py.",
+        to_adc(values, arguments.offset))
@@ -3,7 +3,7 @@ import matplotlib.pyplot as plt
 import numpy as np
 import soundfile as sf
 
-# These values are copied from "global.h"
+# These values are copied from "EngineConfig.h", for the default configuration
 SYSTEM_CLOCK_FREQUENCY_KHZ = 192000
 PWM_AUDIO_CLK_DIVIDER = 16
 PWM_AUDIO_BIT_DEPTH_PER_CHANNEL = 8
@@ -13,11 +13,14 @@ AUDIO_SAMPLING_FREQUENCY = int((SYSTEM_CLOCK_FREQUENCY_KHZ*1000) / (PWM_AUDIO_CL
 ######################################## Main Section ##############################################
 
 if __name__ == '__main__':
-    if len(sys.argv) != 2:
-        print("No file given, please use as follow :\n\tpython3 audio_plotter.py path/to/file.csv")
+    if len(sys.argv) not in (2, 3):
+        print("No file given, please use as follow :\n\tpython3 audio_plotter.py path/to/file.csv [sampling_frequency]")
         quit()
 
     filename = sys.argv[1]
+    # The sampling frequency of the engine configuration the file was recorded with, see "EngineConfig.h"
+    if len(sys.argv) == 3:
+        AUDIO_SAMPLING_FREQUENCY = int(sys.argv[2])
     
     # Retrieve audio signal
     data = np.genfromtxt(filename, dtype=float, delimiter=";")
@@ -0,0 +1,36 @@
+import math
+
+# These values are copied from "limiter_curve.h"
+LIMITER_LUT_SIZE = 256
+# 127/128, the peak of a note at full velocity
+LIMITER_THRESHOLD = 127. / 128.
+# The knee spans the levels between the threshold and full scale
+LIMITER_KNEE_SPAN = 1. - LIMITER_THRESHOLD
+
+
+def knee_curve(x):
+    # Linear up to the threshold, then tends to 1 with a continuous slope
+    return LIMITER_THRESHOLD + (1. - LIMITER_THRESHOLD) * math.tanh((x - LIMITER_THRESHOLD) / (1. - LIMITER_THRESHOLD))
+
+def to_Q0_31(y):
+    return max(-2147483647, min(2147483647, int(round(y * 2147483648))))
+
+def print_lut(name, description, curve):
+    # One more value than the size, so that the last segment can be interpolated
+    values = [to_Q0_31(curve(LIMITER_THRESHOLD + LIMITER_KNEE_SPAN * i / LIMITER_LUT_SIZE)) for i in range(LIMITER_LUT_SIZE + 1)]
+    print("/**")
+    print(" * @brief " + description)
+    print(" * Value i is the image of LIMITER_THRESHOLD + LIMITER_KNEE_SPAN*i/LIMITER_LUT_SIZE.")
+    print(" */")
+    print("const fxpt_Q0_31 " + name + "[LIMITER_LUT_SIZE + 1] =")
+    print("{")
+    for i in range(0, len(values), 8):
+        print("    " + " ".join("{:11d},".format(v) for v in values[i:i+8]))
+    print("};")
+    print("")
+
+
+######################################## Main Section ##############################################
+
+if __name__ == '__main__':
+    print_lut("LIMITER_KNEE_LUT", "Soft knee of the limiter, t + (1-t) * tanh((x-t) / (1-t)), t being LIMITER_THRESHOLD.", knee_curve)
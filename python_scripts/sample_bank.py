@@ -0,0 +1,218 @@
+import argparse
+import math
+import struct
+
+# These values are copied from "SampleBank.h" and "global.h"
+SAMPLE_BANK_MAGIC = 0x42535953
+SAMPLE_BANK_VERSION = 1
+SAMPLE_BANK_NB_SAMPLES_MAX = 256
+SAMPLE_GUARD_BEFORE = 1
+SAMPLE_GUARD_AFTER = 3
+SAMPLE_FORMAT_PCM16 = 0
+SAMPLE_FORMAT_PCM8 = 1
+SAMPLE_FORMAT_ADPCM = 2
+SAMPLE_ADPCM_BLOCK_FRAMES = 256
+SAMPLE_BANK_FLASH_OFFSET = 1024 * 1024
+XIP_BASE = 0x10000000
+
+HEADER_FORMAT = "<IHH"
+ENTRY_FORMAT = "<IIIIIBBbB"
+ADPCM_STATE_FORMAT = "<hBB"
+
+# These values are copied from "adpcm.h"
+ADPCM_STEPS = [
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45, 50, 55, 60, 66, 73, 80, 88, 97,
+    107, 118, 130, 143, 157, 173, 190, 209, 230, 253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796,
+    876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428,
+    4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350,
+    22385, 24623, 27086, 29794, 32767]
+ADPCM_INDEX_CHANGES = [-1, -1, -1, -1, 2, 4, 6, 8]
+
+
+def read_wav(filename):
+    # Returns the mono frames between -1 and 1, the sampling frequency and the loop of the "smpl" chunk if any
+    with open(filename, "rb") as f:
+        data = f.read()
+    if data[0:4] != b"RIFF" or data[8:12] != b"WAVE":
+        raise ValueError(filename + " is not a wav file")
+
+    fmt = None
+    frames = None
+    loop = None
+    position = 12
+    while position + 8 <= len(data):
+        chunk_id = data[position:position+4]
+        chunk_size = struct.unpack_from("<I", data, position + 4)[0]
+        chunk = data[position+8:position+8+chunk_size]
+        if chunk_id == b"fmt ":
+            fmt = struct.unpack_from("<HHIIHH", chunk)
+        elif chunk_id == b"data":
+            frames = chunk
+        elif chunk_id == b"smpl" and len(chunk) >= 36 + 24:
+            # The first loop only, its end being inclusive in the wav format
+            nb_loops = struct.unpack_from("<I", chunk, 28)[0]
+            if nb_loops > 0:
+                loop_start, loop_end = struct.unpack_from("<II", chunk, 36 + 8)
+                loop = (loop_start, loop_end + 1)
+        # Chunks are aligned on 2 bytes
+        position += 8 + chunk_size + (chunk_size & 1)
+
+    if fmt is None or frames is None:
+        raise ValueError(filename + " has no format or no data")
+    audio_format, nb_channels, sample_rate, _, _, bits = fmt
+    if audio_format != 1 or bits not in (8, 16, 24):
+        raise ValueError(filename + " must be 8, 16 or 24 bits PCM")
+
+    width = bits // 8
+    nb_frames = len(frames) // (width * nb_channels)
+    values = []
+    for i in range(nb_frames):
+        value = 0.
+        for c in range(nb_channels):
+            offset = (i * nb_channels + c) * width
+            if bits == 8:
+                # 8 bits wav files are unsigned
+                value += (frames[offset] - 128) / 128.
+            elif bits == 16:
+                value += struct.unpack_from("<h", frames, offset)[0] / 32768.
+            else:
+                value += int.from_bytes(frames[offset:offset+3], "little", signed=True) / 8388608.
+        # Channels are mixed down to mono
+        values.append(value / nb_channels)
+    return values, sample_rate, loop
+
+
+def adpcm_decode(predictor, step_index, code):
+    # Same as adpcm_decode in "adpcm.h", returns the new state
+    step = ADPCM_STEPS[step_index]
+    difference = step >> 3
+    difference += (step >> 2) if code & 1 else 0
+    difference += (step >> 1) if code & 2 else 0
+    difference += step if code & 4 else 0
+    predictor = predictor - difference if code & 8 else predictor + difference
+    predictor = max(-32768, min(32767, predictor))
+    step_index = max(0, min(len(ADPCM_STEPS) - 1, step_index + ADPCM_INDEX_CHANGES[code & 7]))
+    return predictor, step_index
+
+
+def adpcm_encode(codes):
+    # Returns the blocks of the IMA-ADPCM encoding of 16 bits frames, and the frames the decoder will get back
+    predictor, step_index = 0, 0
+    blocks = bytearray()
+    decoded = []
+    padded = codes + [0] * (-len(codes) % SAMPLE_ADPCM_BLOCK_FRAMES)
+    for start in range(0, len(padded), SAMPLE_ADPCM_BLOCK_FRAMES):
+        # Each block begins with the state of the decoder, so that it can start at any block
+        blocks += struct.pack(ADPCM_STATE_FORMAT, predictor, step_index, 0)
+        nibbles = []
+        for x in padded[start:start + SAMPLE_ADPCM_BLOCK_FRAMES]:
+            # The code is chosen by successive approximations of the difference with the prediction
+            step = ADPCM_STEPS[step_index]
+            difference = x - predictor
+            code = 8 if difference < 0 else 0
+            difference = abs(difference)
+            for bit in (4, 2, 1):
+                if difference >= step:
+                    code |= bit
+                    difference -= step
+                step >>= 1
+            predictor, step_index = adpcm_decode(predictor, step_index, code)
+            nibbles.append(code)
+            decoded.append(predictor)
+        # Low nibble first
+        blocks += bytes(nibbles[i] | (nibbles[i + 1] << 4) for i in range(0, len(nibbles), 2))
+    return bytes(blocks), decoded[:len(codes)]
+
+
+def signal_to_noise_db(reference, decoded):
+    signal = sum(x * x for x in reference)
+    noise = sum((x - y) * (x - y) for x, y in zip(reference, decoded))
+    return float("inf") if noise == 0 else 10. * math.log10(signal / noise)
+
+
+def quantize(values, is_8bits):
+    scale, maximum = (128, 127) if is_8bits else (32768, 32767)
+    return [max(-maximum - 1, min(maximum, int(round(v * scale)))) for v in values]
+
+
+def parse_sample_argument(argument):
+    # path.wav[:root[:loop_start:loop_end]], the root being a midi note which may have a fractional part
+    fields = argument.split(":")
+    root = float(fields[1]) if len(fields) > 1 else 60.
+    loop = (int(fields[2]), int(fields[3])) if len(fields) > 3 else None
+    return fields[0], root, loop
+
+
+def pack_bank(samples, sample_format):
+    # Returns the image of the bank, see SampleBank.h for its layout
+    if len(samples) > SAMPLE_BANK_NB_SAMPLES_MAX:
+        raise ValueError("Too many samples")
+    is_8bits = sample_format == SAMPLE_FORMAT_PCM8
+    frame_format, frame_size = ("<b", 1) if is_8bits else ("<h", 2)
+    header = struct.pack(HEADER_FORMAT, SAMPLE_BANK_MAGIC, SAMPLE_BANK_VERSION, len(samples))
+    entries = bytearray()
+    frames = bytearray()
+    cursor = len(header) + len(samples) * struct.calcsize(ENTRY_FORMAT)
+
+    for filename, root, loop_argument in samples:
+        values, sample_rate, loop_wav = read_wav(filename)
+        codes = quantize(values, is_8bits)
+        loop = loop_argument if loop_argument is not None else loop_wav
+        if loop is not None and not (0 <= loop[0] < loop[1] <= len(codes)):
+            raise ValueError(filename + " has an invalid loop " + str(loop))
+
+        if loop is not None:
+            # A looped sample ends with its loop, the guard frames are the beginning of the loop
+            codes = codes[:loop[1]]
+            guard = [codes[loop[0] + (i % (loop[1] - loop[0]))] for i in range(SAMPLE_GUARD_AFTER)]
+            loop_start, loop_end = loop
+        else:
+            guard = [0] * SAMPLE_GUARD_AFTER
+            loop_start, loop_end = 0, 0
+
+        if sample_format == SAMPLE_FORMAT_ADPCM:
+            # The blocks are aligned on 4 bytes, the decoder adds the guard frames by itself
+            offset = (cursor + 3) & ~3
+            blocks, decoded = adpcm_encode(codes)
+            frames += b"\x00" * (offset - cursor) + blocks
+            cursor = offset + len(blocks)
+            round_trip = ", ADPCM round trip SNR {:.1f}dB".format(signal_to_noise_db(codes, decoded))
+        else:
+            # The first frame is aligned on 4 bytes, after at least SAMPLE_GUARD_BEFORE silent frames
+            offset = (cursor + SAMPLE_GUARD_BEFORE * frame_size + 3) & ~3
+            frames += b"\x00" * (offset - cursor)
+            frames += b"".join(struct.pack(frame_format, c) for c in codes + guard)
+            cursor = offset + (len(codes) + SAMPLE_GUARD_AFTER) * frame_size
+            round_trip = ""
+
+        root_note = int(round(root))
+        fine_tune = int(round((root - root_note) * 100))
+        entries += struct.pack(ENTRY_FORMAT, offset, len(codes), loop_start, loop_end, sample_rate,
+            sample_format, root_note, fine_tune, 0)
+        print("{:3d} : {} ({} frames at {}Hz, root {:.2f}, {}{})".format(len(entries) // struct.calcsize(ENTRY_FORMAT) - 1,
+            filename, len(codes), sample_rate, root, "loop {}-{}".format(loop_start, loop_end) if loop is not None else "one shot",
+            round_trip))
+
+    return header + bytes(entries) + bytes(frames)
+
+
+######################################## Main Section ##############################################
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description="Pack wav files in a sample bank, to be written in flash at SAMPLE_BANK_FLASH_OFFSET.")
+    parser.add_argument("output", help="The image of the bank to write.")
+    parser.add_argument("samples", nargs="+", help="path/to/file.wav[:root[:loop_start:loop_end]], the root being the midi note "
+        "of the sample (60 by default), the loop being read in the file when not given.")
+    formats = parser.add_mutually_exclusive_group()
+    formats.add_argument("--8bits", dest="is_8bits", action="store_true", help="Store 8 bits frames instead of 16 bits.")
+    formats.add_argument("--adpcm", dest="is_adpcm", action="store_true", help="Store 4 bits IMA-ADPCM frames instead of 16 bits, "
+        "the signal to noise ratio of the round trip being printed.")
+    arguments = parser.parse_args()
+
+    sample_format = SAMPLE_FORMAT_PCM8 if arguments.is_8bits else (SAMPLE_FORMAT_ADPCM if arguments.is_adpcm else SAMPLE_FORMAT_PCM16)
+    image = pack_bank([parse_sample_argument(a) for a in arguments.samples], sample_format)
+    with open(arguments.output, "wb") as f:
+        f.write(image)
+
+    print("{} bytes written, load them with :\n\tpicotool load -t bin {} -o 0x{:08x}".format(
+        len(image), arguments.output, XIP_BASE + SAMPLE_BANK_FLASH_OFFSET))
@@ -0,0 +1,52 @@
+import math
+
+# These values are copied from "waveshaper_curves.h"
+WAVESHAPER_LUT_SIZE = 256
+
+# The drive of the hyperbolic tangent curve
+TANH_DRIVE = 3.
+# The gain applied before the hard clip
+HARD_CLIP_GAIN = 2.
+# The drive of the positive and negative halves of the fuzz curve
+FUZZ_DRIVE_POSITIVE = 5.
+FUZZ_DRIVE_NEGATIVE = 1.5
+# The level at which the negative half of the fuzz curve saturates
+FUZZ_LEVEL_NEGATIVE = 0.6
+
+
+def tanh_curve(x):
+    return math.tanh(TANH_DRIVE * x) / math.tanh(TANH_DRIVE)
+
+def hard_clip_curve(x):
+    return max(-1., min(1., HARD_CLIP_GAIN * x))
+
+def fuzz_curve(x):
+    if x >= 0:
+        return (1. - math.exp(-FUZZ_DRIVE_POSITIVE * x)) / (1. - math.exp(-FUZZ_DRIVE_POSITIVE))
+    else:
+        return -FUZZ_LEVEL_NEGATIVE * (1. - math.exp(FUZZ_DRIVE_NEGATIVE * x)) / (1. - math.exp(-FUZZ_DRIVE_NEGATIVE))
+
+def to_Q0_15(y):
+    return max(-32767, min(32767, int(round(y * 32767))))
+
+def print_lut(name, description, curve):
+    # One more value than the size, so that the last segment can be interpolated
+    values = [to_Q0_15(curve(-1. + 2. * i / WAVESHAPER_LUT_SIZE)) for i in range(WAVESHAPER_LUT_SIZE + 1)]
+    print("/**")
+    print(" * @brief " + description)
+    print(" * Value i is the image of -1 + 2*i/WAVESHAPER_LUT_SIZE.")
+    print(" */")
+    print("const fxpt_Q0_15 " + name + "[WAVESHAPER_LUT_SIZE + 1] =")
+    print("{")
+    for i in range(0, len(values), 16):
+        print("    " + " ".join("{:6d},".format(v) for v in values[i:i+16]))
+    print("};")
+    print("")
+
+
+######################################## Main Section ##############################################
+
+if __name__ == '__main__':
+    print_lut("WAVESHAPER_TANH_LUT", "Hyperbolic tangent transfer curve, tanh({0}x) / tanh({0}).".format(TANH_DRIVE), tanh_curve)
+    print_lut("WAVESHAPER_HARD_CLIP_LUT", "Hard clipping transfer curve, {0}x saturated to [-1, 1].".format(HARD_CLIP_GAIN), hard_clip_curve)
+    print_lut("WAVESHAPER_FUZZ_LUT", "Asymmetric fuzz transfer curve, the negative half saturating softer and lower than the positive one.", fuzz_curve)
@@ -25,9 +25,60 @@
 #include <stdio.h>
 #endif
 
+/**
+ * @brief The initial phases of the oscillators of the unison mode, scattered pseudo-randomly : evenly
+ * spaced phases would cancel the fundamental of the sum until the oscillators drift apart.
+ */
+static const fxpt_UQ0_32 UNISON_INITIAL_PHASES[UNISON_NB_OSCILLATORS_MAX] =
+{
+    0x92CA2F0EU, 0x3CD6E3F3U, 0x1B147DCCU, 0x4C081DBFU, 0x487981ABU, 0xDB408C9DU, 0x78BC1B8FU, 0xD83072E5U
+};
+
 ActiveNote::ActiveNote()
 {
     m_time_stop_fs = 0; 
+    m_pitch_modulation = 0;
+    m_phase = 0;
+    m_phase_increment = 0;
+    m_texture_modulation = 0;
+    m_amplitude = std::numeric_limits<fxpt_Q0_31>::max();
+    m_amplitude_step = 0;
+    m_noise_idx = 0;
+    m_fm_idx = 0;
+    m_pluck_slot = DELAY_ARENA_NO_SLOT;
+    m_pluck_idx = 0;
+    m_sample_idx = 0;
+    m_unison_nb_oscillators = 1;
+    m_unison_idx = 0;
+    for(unsigned int i = 0; i < SIZE_AUDIO_BLOCK; ++i)
+    {
+        m_noise_block[i] = 0;
+        m_fm_block[i] = 0;
+        m_pluck_block[i] = 0;
+        m_sample_block[i] = 0;
+    }
+    for(unsigned int i = 0; i < SIZE_UNISON_BLOCK; ++i)
+    {
+        m_unison_block[i] = 0;
+        #ifdef AUDIO_STEREO
+        m_unison_side_block[i] = 0;
+        #endif
+    }
+    for(unsigned int k = 0; k < UNISON_NB_OSCILLATORS_MAX; ++k)
+    {
+        m_unison_phases[k] = UNISON_INITIAL_PHASES[k];
+    }
+    #if defined(AUDIO_STEREO) || defined(AUDIO_OVERSAMPLING)
+    m_envelope = 0;
+    #endif
+    #ifdef AUDIO_OVERSAMPLING
+    m_waveform_weight = std::numeric_limits<fxpt_Q0_31>::max();
+    #endif
+    m_cache_entry = NOTE_CACHE_NO_ENTRY;
+    m_cache_frames = nullptr;
+    m_cache_length = 0;
+    m_is_cache_recording = false;
+    set_pan(0);
 }
 
 ActiveNote::ActiveNote(MidiByte _midi_note, fxpt_Q0_31 _velocity, unsigned int _time_start_fs, unsigned int _attack_fs, unsigned int _decay_fs) :
@@ -35,12 +86,61 @@ ActiveNote::ActiveNote(MidiByte _midi_note, fxpt_Q0_31 _velocity, unsigned int _
     m_velocity(_velocity),
     m_time_start_fs(_time_start_fs),
     m_attack_fs(_attack_fs),
-    m_decay_fs(_decay_fs)
+    m_decay_fs(_decay_fs),
+    // Each note has its own noise sequence, which only depends on the note and on its start time
+    m_noise(NOISE_WHITE, (_time_start_fs * 0x9E3779B9U) ^ ((uint32_t)_midi_note << 24))
 {
-    m_period_fs = MIDI_PERIODS_FS[_midi_note];
+    // No glide by default, the phase increment is ready for the first audio block
+    m_pitch.set_value(fxpt_convert_n((fxpt_Q15_16)_midi_note, 0, 16));
+    m_pitch_modulation = 0;
+    m_phase = 0;
+    m_phase_increment = MIDI_PHASE_INCREMENTS[_midi_note];
 
     m_time_released_fs = std::numeric_limits<unsigned int>::max();
     m_time_stop_fs = std::numeric_limits<unsigned int>::max();
+
+    // No modulation until next audio block
+    m_texture_modulation = 0;
+    m_amplitude = std::numeric_limits<fxpt_Q0_31>::max();
+    m_amplitude_step = 0;
+    // No noise until it is rendered for the next audio block
+    m_noise_idx = 0;
+    m_fm_idx = 0;
+    m_pluck_slot = DELAY_ARENA_NO_SLOT;
+    m_pluck_idx = 0;
+    m_sample_idx = 0;
+    m_unison_nb_oscillators = 1;
+    m_unison_idx = 0;
+    for(unsigned int i = 0; i < SIZE_AUDIO_BLOCK; ++i)
+    {
+        m_noise_block[i] = 0;
+        m_fm_block[i] = 0;
+        m_pluck_block[i] = 0;
+        m_sample_block[i] = 0;
+    }
+    for(unsigned int i = 0; i < SIZE_UNISON_BLOCK; ++i)
+    {
+        m_unison_block[i] = 0;
+        #ifdef AUDIO_STEREO
+        m_unison_side_block[i] = 0;
+        #endif
+    }
+    for(unsigned int k = 0; k < UNISON_NB_OSCILLATORS_MAX; ++k)
+    {
+        m_unison_phases[k] = UNISON_INITIAL_PHASES[k];
+    }
+    #if defined(AUDIO_STEREO) || defined(AUDIO_OVERSAMPLING)
+    m_envelope = 0;
+    #endif
+    #ifdef AUDIO_OVERSAMPLING
+    m_waveform_weight = std::numeric_limits<fxpt_Q0_31>::max();
+    #endif
+    m_cache_entry = NOTE_CACHE_NO_ENTRY;
+    m_cache_frames = nullptr;
+    m_cache_length = 0;
+    m_is_cache_recording = false;
+    // Centered until told otherwise
+    set_pan(0);
     #ifdef DEBUG
     printf("ActiveNote(%d, %d, %d, %d, %d)\n", m_midi_note, m_velocity, m_time_start_fs, m_attack_fs, m_decay_fs);
     #endif
@@ -87,6 +187,38 @@ fxpt_Q0_31 ActiveNote::get_ADSR_envelope(unsigned int time_fs, fxpt_Q0_31 sustai
 }
 
 
+fxpt_Q16_15 ActiveNote::get_ADSR_envelope_q15(unsigned int time_fs, fxpt_Q0_15 sustain) const
+{
+    // Same phases as get_ADSR_envelope, the ratios of durations being computed by the hardware divider
+    if(time_fs < m_time_released_fs)
+    {
+        const unsigned int l_elapsed = time_fs - m_time_start_fs;
+        if(l_elapsed >= (m_attack_fs + m_decay_fs))
+        {
+            return sustain;
+        }
+        else if(l_elapsed >= m_attack_fs)
+        {
+            // return 1 + (sustain-1) * (elapsed-attack) / decay
+            constexpr fxpt_Q16_15 l_one = 1<<15;
+            return l_one + fxpt_convert_n((sustain - l_one) * (fxpt_Q16_15)fxpt_ratio_q15(l_elapsed - m_attack_fs, m_decay_fs), 30, 15);
+        }
+        else
+        {
+            return fxpt_ratio_q15(l_elapsed, m_attack_fs);
+        }
+    }
+    else
+    {
+        // return (t_released + release - t) * adsr_at_release / release
+        return fxpt_convert_n(
+            (fxpt_Q16_15)fxpt_ratio_q15(m_time_released_fs + m_release_fs - time_fs, m_release_fs) * fxpt_convert_n(m_ADSR_at_release, 31, 15),
+            30, 15
+        );
+    }
+}
+
+
 void ActiveNote::release(unsigned int time_released_fs, float sustain, unsigned int release)
 {
     m_release_fs = release;
@@ -100,20 +232,376 @@ void ActiveNote::release(unsigned int time_released_fs, float sustain, unsigned
 }
 
 
-fxpt_Q0_31 ActiveNote::get_audio_value(unsigned int time_fs, fxpt_Q0_31(*waveform)(unsigned int, unsigned int, fxpt_Q0_31), fxpt_Q0_31 texture, fxpt_Q0_31 sustain) const
+void ActiveNote::glide_from(fxpt_Q15_16 pitch, unsigned int duration_blocks)
+{
+    // The division of the linear ramp only occurs once, at next update
+    m_pitch.set_duration(duration_blocks);
+    m_pitch.set_value(pitch);
+    m_pitch.set_target(fxpt_convert_n((fxpt_Q15_16)m_midi_note, 0, 16));
+}
+
+
+void ActiveNote::update_pitch(fxpt_Q15_16 pitch_offset)
+{
+    m_pitch.update();
+    m_phase_increment = midi_pitch_to_phase_increment(m_pitch.get() + pitch_offset + m_pitch_modulation);
+}
+
+
+void ActiveNote::set_modulation(const fxpt_Q0_31 modulations[NB_MODULATION_DESTINATIONS])
+{
+    m_texture_modulation = modulations[MODULATION_DESTINATION_TEXTURE];
+    // Q0.31 multiplied by an integer number of semitones, converted to Q15.16
+    m_pitch_modulation = fxpt_convert_n((fxpt64_t)modulations[MODULATION_DESTINATION_PITCH] * MODULATION_PITCH_RANGE_SEMITONES, 31, 16);
+
+    // Only a negative amplitude modulation has an effect, the gain cannot exceed 1
+    constexpr fxpt_Q0_31 l_one = std::numeric_limits<fxpt_Q0_31>::max();
+    const fxpt_Q0_31 l_amplitude_target = (modulations[MODULATION_DESTINATION_AMPLITUDE] < 0) ?
+        l_one + modulations[MODULATION_DESTINATION_AMPLITUDE] : l_one;
+    // Ramp from current gain to target gain along next block, SIZE_AUDIO_BLOCK being a power of two
+    m_amplitude_step = (l_amplitude_target - m_amplitude) / (fxpt_Q0_31)SIZE_AUDIO_BLOCK;
+    // Snap to target when close enough, so that an unmodulated note does not pay for the gain
+    if(m_amplitude_step == 0)
+    {
+        m_amplitude = l_amplitude_target;
+    }
+}
+
+
+void ActiveNote::set_pan(fxpt_Q0_31 pan)
+{
+    // The angle goes from 0 to a quarter of period, the gains being its cosine and sine so that their squares sum to 1.
+    // (pan+1)/2 on 8 bits is an angle within the first quarter of period of fxpt_sin, which is 256.
+    const fxpt_Q21_10 l_angle = (fxpt_UQ0_32)fxpt32_signed_unsigned_map(pan) >> 24;
+    m_pan_gains[0] = fxpt_cos(l_angle);
+    m_pan_gains[1] = fxpt_sin(l_angle);
+}
+
+
+void ActiveNote::render_noise(NoiseColor color)
+{
+    m_noise.set_color(color);
+    m_noise.fill_block(m_noise_block, SIZE_AUDIO_BLOCK);
+    m_noise_idx = 0;
+}
+
+
+void ActiveNote::render_fm(const FmPatch& patch, unsigned int time_fs)
+{
+    // The operators follow the pitch of the note, glide and modulation included
+    m_fm.set_phase_increment(m_phase_increment, patch);
+    m_fm.render_block(patch, time_fs - m_time_start_fs, m_fm_block, SIZE_AUDIO_BLOCK);
+    m_fm_idx = 0;
+}
+
+
+void ActiveNote::pluck(fxpt_Q0_15* line, int slot)
+{
+    m_pluck_slot = slot;
+    // The burst comes from the noise of the note, which differs from one note to another
+    m_pluck.pluck(line, m_noise);
+    m_pluck.tune(m_phase_increment);
+}
+
+
+int ActiveNote::detach_pluck()
+{
+    const int l_slot = m_pluck_slot;
+    m_pluck.detach();
+    m_pluck_slot = DELAY_ARENA_NO_SLOT;
+    return l_slot;
+}
+
+
+void ActiveNote::render_pluck(fxpt_Q0_15 damping)
+{
+    // The string follows the pitch of the note, glide and modulation included
+    m_pluck.tune(m_phase_increment);
+    m_pluck.render_block(m_pluck_block, SIZE_AUDIO_BLOCK, damping);
+    m_pluck_idx = 0;
+}
+
+
+void ActiveNote::start_sample(const Sample& sample)
+{
+    m_sample_player.start(sample);
+    m_sample_player.tune(m_phase_increment);
+}
+
+
+void ActiveNote::render_sample(SampleInterpolation interpolation)
+{
+    // The sample follows the pitch of the note, glide and modulation included
+    m_sample_player.tune(m_phase_increment);
+    m_sample_player.render_block(m_sample_block, SIZE_AUDIO_BLOCK, interpolation);
+    m_sample_idx = 0;
+}
+
+
+void ActiveNote::stream_cache(fxpt_Q0_15* frames, unsigned int length, int entry)
+{
+    m_cache_entry = entry;
+    m_cache_frames = frames;
+    m_cache_length = length;
+    m_is_cache_recording = false;
+}
+
+
+void ActiveNote::record_cache(fxpt_Q0_15* frames, unsigned int length, int entry)
+{
+    m_cache_entry = entry;
+    m_cache_frames = frames;
+    m_cache_length = length;
+    m_is_cache_recording = true;
+}
+
+
+bool ActiveNote::can_follow_cache(unsigned int time_fs) const
+{
+    return (time_fs - m_time_start_fs < m_cache_length) && !is_released() && (m_pitch.get() == m_pitch.get_target())
+        && (m_pitch_modulation == 0) && (m_texture_modulation == 0);
+}
+
+
+int ActiveNote::detach_cache(unsigned int time_fs, unsigned int& nb_recorded_frames)
+{
+    // A recording interrupted earlier does not reach the end of the entry
+    nb_recorded_frames = (m_is_cache_recording && time_fs - m_time_start_fs >= m_cache_length) ? m_cache_length : 0;
+    const int l_entry = m_cache_entry;
+    m_cache_entry = NOTE_CACHE_NO_ENTRY;
+    m_cache_frames = nullptr;
+    m_cache_length = 0;
+    m_is_cache_recording = false;
+    return l_entry;
+}
+
+
+void ActiveNote::render_unison(const Unison& unison, fxpt_Q0_31(*waveform)(fxpt_UQ0_32, fxpt_Q0_31), fxpt_Q0_31 texture, fxpt_Q0_31 waveform_weight)
+{
+    m_unison_nb_oscillators = unison.get_nb_oscillators();
+    m_unison_idx = 0;
+    #ifdef AUDIO_OVERSAMPLING
+    m_waveform_weight = waveform_weight;
+    #elif !defined(AUDIO_STEREO)
+    // Only the side and the oversampled sub-samples follow the crossfades
+    (void)waveform_weight;
+    #endif
+    if(m_unison_nb_oscillators <= 1)
+    {
+        return;
+    }
+
+    // While the note is streamed from the cache, the oscillators only keep running
+    if(m_cache_entry != NOTE_CACHE_NO_ENTRY && !m_is_cache_recording)
+    {
+        for(unsigned int k = 0; k < m_unison_nb_oscillators; ++k)
+        {
+            m_unison_phases[k] += SIZE_AUDIO_BLOCK * fxpt_convert_n((uint64_t)m_phase_increment * unison.get_ratio(k), 31, 0);
+        }
+        return;
+    }
+
+    // The texture modulation only changes once per block
+    texture = get_modulated_texture(texture);
+
+    // The oscillators are summed in Q3.28, so that 8 of them cannot overflow
+    for(unsigned int i = 0; i < SIZE_UNISON_BLOCK; ++i)
+    {
+        m_unison_block[i] = 0;
+        #ifdef AUDIO_STEREO
+        m_unison_side_block[i] = 0;
+        #endif
+    }
+    for(unsigned int k = 0; k < m_unison_nb_oscillators; ++k)
+    {
+        // When oversampled, the oscillators render more samples with smaller increments
+        const fxpt_UQ0_32 l_phase_increment = fxpt_convert_n((uint64_t)m_phase_increment * unison.get_ratio(k), 31, 0) / OVERSAMPLING_FACTOR;
+        fxpt_UQ0_32 l_phase = m_unison_phases[k];
+        #ifdef AUDIO_STEREO
+        // Odd oscillators are on the right, the even ones are negated with (x ^ -1) + 1
+        const fxpt_Q3_28 l_side_mask = (k & 1) ? 0 : -1;
+        #endif
+        for(unsigned int i = 0; i < SIZE_UNISON_BLOCK; ++i)
+        {
+            const fxpt_Q3_28 l_value = fxpt_convert_n(waveform(l_phase, texture), 31, 28);
+            m_unison_block[i] += l_value;
+            #ifdef AUDIO_STEREO
+            m_unison_side_block[i] += (l_value ^ l_side_mask) - l_side_mask;
+            #endif
+            l_phase += l_phase_increment;
+        }
+        m_unison_phases[k] = l_phase;
+    }
+
+    // The gain keeps the loudness, the sum is saturated since the oscillators may peak together
+    const fxpt_Q0_31 l_gain = unison.get_gain();
+    #ifdef AUDIO_STEREO
+    // The side also follows the crossfades of the waveform with the other layers
+    const fxpt_Q0_31 l_side_gain = fxpt_convert_n(
+        fxpt_convert_n((fxpt64_t)l_gain * (fxpt64_t)unison.get_stereo_spread(), 31, 0) * (fxpt64_t)waveform_weight, 31, 0);
+    #endif
+    for(unsigned int i = 0; i < SIZE_UNISON_BLOCK; ++i)
+    {
+        const fxpt64_t l_value = fxpt_convert_n((fxpt64_t)m_unison_block[i] * (fxpt64_t)l_gain, 28, 0);
+        m_unison_block[i] = (l_value > std::numeric_limits<fxpt_Q0_31>::max()) ? std::numeric_limits<fxpt_Q0_31>::max() :
+            ((l_value < std::numeric_limits<fxpt_Q0_31>::min()) ? std::numeric_limits<fxpt_Q0_31>::min() : l_value);
+        #ifdef AUDIO_STEREO
+        const fxpt64_t l_side = fxpt_convert_n((fxpt64_t)m_unison_side_block[i] * (fxpt64_t)l_side_gain, 28, 0);
+        m_unison_side_block[i] = (l_side > std::numeric_limits<fxpt_Q0_31>::max()) ? std::numeric_limits<fxpt_Q0_31>::max() :
+            ((l_side < std::numeric_limits<fxpt_Q0_31>::min()) ? std::numeric_limits<fxpt_Q0_31>::min() : l_side);
+        #endif
+    }
+}
+
+
+#if defined(AUDIO_STEREO) || defined(AUDIO_OVERSAMPLING)
+fxpt_Q0_31 ActiveNote::apply_last_envelope(fxpt_Q0_31 value) const
+{
+    fxpt_Q0_31 l_value = fxpt_convert_n(
+        fxpt_convert_n((fxpt64_t)value * (fxpt64_t)m_envelope, 61, 31) * (fxpt64_t)m_velocity,
+        62, 31
+    );
+    if(m_amplitude != std::numeric_limits<fxpt_Q0_31>::max())
+    {
+        l_value = fxpt_convert_n((fxpt64_t)l_value * (fxpt64_t)m_amplitude, 62, 31);
+    }
+    return l_value;
+}
+#endif
+
+
+#ifdef AUDIO_STEREO
+fxpt_Q0_31 ActiveNote::get_unison_side(unsigned int time_fs, unsigned int sub_sample) const
+{
+    if(m_unison_nb_oscillators <= 1 || time_fs >= m_time_stop_fs)
+    {
+        return 0;
+    }
+
+    // The sample read by the last call to get_audio_value
+    return apply_last_envelope(m_unison_side_block[(m_unison_idx - OVERSAMPLING_FACTOR + sub_sample) & (SIZE_UNISON_BLOCK - 1)]);
+}
+#endif
+
+
+fxpt_Q0_31 ActiveNote::get_audio_value(unsigned int time_fs, fxpt_Q0_31(*waveform)(fxpt_UQ0_32, fxpt_Q0_31), fxpt_Q0_31 texture, fxpt_Q0_31 sustain, fxpt_Q0_31 noise_level, fxpt_Q0_31 fm_level, fxpt_Q0_31 pluck_level, fxpt_Q0_31 sample_level)
 {
     if (time_fs >= m_time_stop_fs)
     {
         return 0;
     }
 
-    fxpt_Q0_31 l_audio_value = waveform(time_fs, m_period_fs, texture);
+    // The attack and decay of a static patch are streamed from the note cache instead of being synthesized
+    const unsigned int l_elapsed = time_fs - m_time_start_fs;
+    if(is_streaming_cache(time_fs))
+    {
+        // The oscillator keeps running, so that the live synthesis takes over seamlessly
+        m_phase += m_phase_increment;
+        #ifdef AUDIO_Q15
+        return apply_velocity_q15(m_cache_frames[l_elapsed]);
+        #else
+        return apply_velocity(fxpt_convert_n((fxpt_Q0_31)m_cache_frames[l_elapsed], 15, 31));
+        #endif
+    }
+
+    fxpt_Q0_31 l_audio_value;
+    if(m_unison_nb_oscillators > 1)
+    {
+        // The oscillators of the unison mode were rendered for the whole block
+        l_audio_value = m_unison_block[m_unison_idx];
+        // The other sub-samples of an oversampled block are read by get_audio_values_oversampled
+        m_unison_idx = (m_unison_idx + OVERSAMPLING_FACTOR) & (SIZE_UNISON_BLOCK - 1);
+    }
+    else
+    {
+        l_audio_value = waveform(m_phase, get_modulated_texture(texture));
+        // The phase wraps around naturally at the end of each period
+        m_phase += m_phase_increment;
+    }
+
+#ifdef AUDIO_Q15
+    // The same computations on 16 bits, so that each product is a single 32 bits multiplication
+    fxpt_Q16_15 l_audio_value_q15 = fxpt_convert_n(l_audio_value, 31, 15);
+
+    // Crossfade from the waveform to each other layer in turn, only when there is some
+    l_audio_value_q15 = crossfade_layer_q15(m_fm_block, m_fm_idx, fm_level, l_audio_value_q15);
+    l_audio_value_q15 = crossfade_layer_q15(m_pluck_block, m_pluck_idx, pluck_level, l_audio_value_q15);
+    l_audio_value_q15 = crossfade_layer_q15(m_sample_block, m_sample_idx, sample_level, l_audio_value_q15);
+    l_audio_value_q15 = crossfade_layer_q15(m_noise_block, m_noise_idx, noise_level, l_audio_value_q15);
 
     // Apply ADSR and velocity
-    l_audio_value = fxpt_convert_n(
-            fxpt_convert_n((fxpt64_t)l_audio_value * (fxpt64_t)get_ADSR_envelope(time_fs, sustain), 62, 31) *
-            (fxpt64_t)m_velocity,
-            62, 31
-    );
-    return l_audio_value;
-}
\ No newline at end of file
+    const fxpt_Q16_15 l_envelope_q15 = get_ADSR_envelope_q15(time_fs, fxpt_convert_n(sustain, 31, 15));
+    #if defined(AUDIO_STEREO) || defined(AUDIO_OVERSAMPLING)
+    m_envelope = fxpt_convert_n(l_envelope_q15, 15, 30);
+    #endif
+    l_audio_value_q15 = fxpt_convert_n(l_audio_value_q15 * l_envelope_q15, 30, 15);
+    // The first note of a static patch records its attack and decay for the following ones
+    if(m_is_cache_recording && l_elapsed < m_cache_length)
+    {
+        m_cache_frames[l_elapsed] = l_audio_value_q15;
+    }
+    return apply_velocity_q15(l_audio_value_q15);
+#else
+    // Crossfade from the waveform to each other layer in turn, only when there is some
+    l_audio_value = crossfade_layer(m_fm_block, m_fm_idx, fm_level, l_audio_value);
+    l_audio_value = crossfade_layer(m_pluck_block, m_pluck_idx, pluck_level, l_audio_value);
+    l_audio_value = crossfade_layer(m_sample_block, m_sample_idx, sample_level, l_audio_value);
+    l_audio_value = crossfade_layer(m_noise_block, m_noise_idx, noise_level, l_audio_value);
+
+    // Apply ADSR and velocity
+    const fxpt_Q0_31 l_envelope = get_ADSR_envelope(time_fs, sustain);
+    #if defined(AUDIO_STEREO) || defined(AUDIO_OVERSAMPLING)
+    m_envelope = fxpt_convert_n(l_envelope, 31, 30);
+    #endif
+    l_audio_value = fxpt_convert_n((fxpt64_t)l_audio_value * (fxpt64_t)l_envelope, 62, 31);
+    // The cache only keeps 16 bits, like the PWM output
+    if(m_is_cache_recording && l_elapsed < m_cache_length)
+    {
+        m_cache_frames[l_elapsed] = fxpt_convert_n(l_audio_value, 31, 15);
+    }
+    return apply_velocity(l_audio_value);
+#endif
+}
+
+#ifdef AUDIO_OVERSAMPLING
+void ActiveNote::get_audio_values_oversampled(unsigned int time_fs, fxpt_Q0_31(*waveform)(fxpt_UQ0_32, fxpt_Q0_31), fxpt_Q0_31 texture, fxpt_Q0_31 sustain, fxpt_Q0_31 noise_level, fxpt_Q0_31 fm_level, fxpt_Q0_31 pluck_level, fxpt_Q0_31 sample_level, fxpt_Q0_31* values)
+{
+    // The waveform at each sub-sample, read before get_audio_value moves the oscillators forward
+    fxpt_Q0_31 l_waveform[OVERSAMPLING_FACTOR];
+    const bool l_is_synthesized = time_fs < m_time_stop_fs && !is_streaming_cache(time_fs);
+    if(l_is_synthesized)
+    {
+        if(m_unison_nb_oscillators > 1)
+        {
+            for(unsigned int j = 0; j < OVERSAMPLING_FACTOR; ++j)
+            {
+                l_waveform[j] = m_unison_block[m_unison_idx + j];
+            }
+        }
+        else
+        {
+            const fxpt_Q0_31 l_texture = get_modulated_texture(texture);
+            const fxpt_UQ0_32 l_phase_increment = m_phase_increment / OVERSAMPLING_FACTOR;
+            for(unsigned int j = 0; j < OVERSAMPLING_FACTOR; ++j)
+            {
+                l_waveform[j] = waveform(m_phase + j * l_phase_increment, l_texture);
+            }
+        }
+    }
+
+    values[0] = get_audio_value(time_fs, waveform, texture, sustain, noise_level, fm_level, pluck_level, sample_level);
+    for(unsigned int j = 1; j < OVERSAMPLING_FACTOR; ++j)
+    {
+        values[j] = values[0];
+        if(l_is_synthesized)
+        {
+            // The difference of two waveform values needs 33 bits, it is halved before being scaled
+            const fxpt_Q0_31 l_half_difference = fxpt_convert_n(
+                ((fxpt64_t)(l_waveform[j] >> 1) - (fxpt64_t)(l_waveform[0] >> 1)) * (fxpt64_t)m_waveform_weight, 31, 0);
+            const fxpt64_t l_value = (fxpt64_t)values[0] + 2 * (fxpt64_t)apply_last_envelope(l_half_difference);
+            values[j] = (l_value > std::numeric_limits<fxpt_Q0_31>::max()) ? std::numeric_limits<fxpt_Q0_31>::max() :
+                ((l_value < std::numeric_limits<fxpt_Q0_31>::min()) ? std::numeric_limits<fxpt_Q0_31>::min() : l_value);
+        }
+    }
+}
+#endif
\ No newline at end of file
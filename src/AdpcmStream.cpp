@@ -0,0 +1,116 @@
+/**
+ * Synthpathy is a small and versatile audio synthesizer on a microcontroler. 
+ * Copyright (C) 2022  Brice Croix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "AdpcmStream.h"
+
+/**
+ * @brief Read the code of a frame of an ADPCM sample.
+ * 
+ * @param blocks The first block of the sample.
+ * @param frame The index of the frame.
+ * @return uint32_t The 4 bits code.
+ */
+static inline uint32_t adpcm_stream_read_code(const uint8_t* blocks, unsigned int frame)
+{
+    const uint8_t l_byte = blocks[(frame / SAMPLE_ADPCM_BLOCK_FRAMES) * SAMPLE_ADPCM_BLOCK_SIZE + 4 + (frame % SAMPLE_ADPCM_BLOCK_FRAMES) / 2];
+    return (frame & 1) ? (l_byte >> 4) : (l_byte & 0xF);
+}
+
+AdpcmStream::AdpcmStream()
+{
+    for(unsigned int i = 0; i < SAMPLE_ADPCM_RING_SIZE; ++i)
+    {
+        m_ring[i] = 0;
+    }
+    m_blocks = nullptr;
+    m_end = 0;
+    m_loop_start = 0;
+    m_is_looped = false;
+    m_frame = 0;
+    m_virtual_end = 0;
+    m_state.predictor = 0;
+    m_state.step_index = 0;
+    m_loop_state = m_state;
+}
+
+AdpcmState AdpcmStream::read_block_state(unsigned int block) const
+{
+    // Blocks are aligned on 4 bytes, the predictor is read at once
+    const uint8_t* l_block = m_blocks + block * SAMPLE_ADPCM_BLOCK_SIZE;
+    AdpcmState l_state;
+    l_state.predictor = *reinterpret_cast<const int16_t*>(l_block);
+    l_state.step_index = (l_block[2] < ADPCM_NB_STEPS) ? l_block[2] : ADPCM_NB_STEPS - 1;
+    return l_state;
+}
+
+void AdpcmStream::start(const Sample& sample)
+{
+    m_blocks = static_cast<const uint8_t*>(sample.data);
+    m_is_looped = sample.loop_end > sample.loop_start;
+    // A looped sample ends with its loop
+    m_end = m_is_looped ? sample.loop_end : sample.length;
+    m_loop_start = sample.loop_start;
+    m_frame = 0;
+    m_virtual_end = 0;
+    m_state = read_block_state(0);
+    // The frame before the first one, read by the cubic interpolation
+    m_ring[RING_MSK] = 0;
+
+    if(m_is_looped)
+    {
+        // The state before the loop is decoded from the beginning of its block, SAMPLE_ADPCM_BLOCK_FRAMES frames at most
+        const unsigned int l_block = m_loop_start / SAMPLE_ADPCM_BLOCK_FRAMES;
+        m_loop_state = read_block_state(l_block);
+        for(unsigned int f = l_block * SAMPLE_ADPCM_BLOCK_FRAMES; f < m_loop_start; ++f)
+        {
+            adpcm_decode(m_loop_state, adpcm_stream_read_code(m_blocks, f));
+        }
+    }
+}
+
+void AdpcmStream::decode_until(uint32_t virtual_end)
+{
+    // The state is kept in registers while decoding
+    AdpcmState l_state = m_state;
+    unsigned int l_frame = m_frame;
+    uint32_t l_virtual_end = m_virtual_end;
+
+    // The difference handles the wrapping of the virtual indices
+    while((int32_t)(virtual_end - l_virtual_end) > 0)
+    {
+        if(l_frame >= m_end)
+        {
+            if(!m_is_looped)
+            {
+                // Silence after the end, as the guard frames of PCM samples
+                m_ring[l_virtual_end & RING_MSK] = 0;
+                l_virtual_end++;
+                continue;
+            }
+            l_frame = m_loop_start;
+            l_state = m_loop_state;
+        }
+        m_ring[l_virtual_end & RING_MSK] = adpcm_decode(l_state, adpcm_stream_read_code(m_blocks, l_frame));
+        l_frame++;
+        l_virtual_end++;
+    }
+
+    m_state = l_state;
+    m_frame = l_frame;
+    m_virtual_end = l_virtual_end;
+}
\ No newline at end of file
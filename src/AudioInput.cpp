@@ -0,0 +1,42 @@
+/**
+ * Synthpathy is a small and versatile audio synthesizer on a microcontroler. 
+ * Copyright (C) 2022  Brice Croix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "AudioInput.h"
+
+#include <limits>
+
+AudioInput::AudioInput()
+{
+    m_x1 = 0;
+    m_y1 = 0;
+}
+
+void AudioInput::process_block(const volatile uint16_t* raw, unsigned int stride, fxpt_Q0_31* samples, unsigned int nb_samples)
+{
+    constexpr fxpt_Q2_29 l_max = std::numeric_limits<fxpt_Q0_31>::max() >> 2;
+    constexpr fxpt_Q2_29 l_min = std::numeric_limits<fxpt_Q0_31>::min() >> 2;
+    for(unsigned int i = 0; i < nb_samples; ++i)
+    {
+        // Center the unsigned sample, the filter works in Q2.29 since its gain can reach 2 on steps
+        const fxpt_Q2_29 l_x = fxpt_convert_n((fxpt_Q2_29)raw[i * stride] - (1<<(ADC_BIT_DEPTH-1)), ADC_BIT_DEPTH-1, 29);
+        // y = x - x1 + (1 - 2^-shift) * y1
+        m_y1 = l_x - m_x1 + m_y1 - (m_y1 >> DC_BLOCKER_SHIFT);
+        m_x1 = l_x;
+        samples[i] = fxpt_convert_n((m_y1 > l_max) ? l_max : ((m_y1 < l_min) ? l_min : m_y1), 29, 31);
+    }
+}
\ No newline at end of file
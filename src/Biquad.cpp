@@ -89,9 +89,12 @@ fxpt_Q0_31 Biquad::process(fxpt_Q0_31 x)
     // set_z1(get_b1() * x - get_a1() * y + get_z2());
     // set_z2(get_b2() * x - get_a2() * y);
 
-    const fxpt_Q0_31 y = 
+    const fxpt64_t l_y =
         + fxpt_convert_n((fxpt64_t)get_b0() * (fxpt64_t)x, 61, 31)
         + fxpt_convert_n((fxpt64_t)get_z1(), 28, 31);
+    // The limiter leaves the mix up to full scale, the resonance can push it above : it is saturated rather than wrapped around
+    const fxpt_Q0_31 y = (l_y > std::numeric_limits<fxpt_Q0_31>::max()) ? std::numeric_limits<fxpt_Q0_31>::max() :
+        ((l_y < std::numeric_limits<fxpt_Q0_31>::min()) ? std::numeric_limits<fxpt_Q0_31>::min() : l_y);
 
     set_z1(
         + fxpt_convert_n((fxpt64_t)get_b1() * (fxpt64_t)x, 61, 28)
@@ -108,6 +111,14 @@ fxpt_Q0_31 Biquad::process(fxpt_Q0_31 x)
     return y;
 }
 
+void Biquad::process_block(fxpt_Q0_31* samples, unsigned int nb_samples)
+{
+    for(unsigned int i = 0; i < nb_samples; ++i)
+    {
+        samples[i] = process(samples[i]);
+    }
+}
+
 DynamicBiquad::DynamicBiquad(const Biquad &biquad):
     Biquad()
 {
@@ -217,3 +228,11 @@ fxpt_Q0_31 DynamicBiquad::process(fxpt_Q0_31 x)
              + fxpt_convert_n((fxpt64_t)l_ratio * (fxpt64_t)y_target, 62, 31);
     }
 }
+
+void DynamicBiquad::process_block(fxpt_Q0_31* samples, unsigned int nb_samples)
+{
+    for(unsigned int i = 0; i < nb_samples; ++i)
+    {
+        samples[i] = process(samples[i]);
+    }
+}
\ No newline at end of file
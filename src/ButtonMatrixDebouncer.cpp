@@ -0,0 +1,47 @@
+/**
+ * Synthpathy is a small and versatile audio synthesizer on a microcontroler. 
+ * Copyright (C) 2022  Brice Croix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "ButtonMatrixDebouncer.h"
+
+ButtonMatrixDebouncer::ButtonMatrixDebouncer()
+{
+    // mov osr, null ; mov y, null
+    m_previous_scan = 0;
+    m_published = 0;
+}
+
+bool ButtonMatrixDebouncer::scan(uint32_t raw_state)
+{
+    bool l_published = false;
+
+    // jmp x!=y store : still bouncing
+    if(raw_state == m_previous_scan)
+    {
+        // mov y, osr ; jmp x!=y publish
+        if(raw_state != m_published)
+        {
+            // mov osr, x ; mov isr, x ; push noblock
+            m_published = raw_state;
+            l_published = true;
+        }
+    }
+
+    // store : mov y, x
+    m_previous_scan = raw_state;
+    return l_published;
+}
\ No newline at end of file
@@ -22,7 +22,10 @@
 
 #include "pico/stdlib.h"
 #include "hardware/adc.h"
-#include "hardware/irq.h"
+#include "hardware/dma.h"
+#include "hardware/pio.h"
+#include "hardware/timer.h"
+#include "button_matrix.pio.h"
 
 #include <limits>
 #include <math.h>
@@ -37,110 +40,70 @@ Controls::Controls()
     // Initialize all buttons as not pressed
     m_buttons = 0;
     m_buttons_old = 0;
-    // Initalize all buttons as instable
-    for(unsigned int row = 0; row < NB_PIN_BUTTON_MATRIX_OUT; ++row)
-    {
-        m_buttons_stability_count[row] = 0;
-    }
+    m_buttons_time_us = 0;
+    // No button event has been published yet
+    m_button_events_read_idx = 0;
     // Initialize all leds as turned off
     m_leds = 0;
-    // The first button matrix pin to be high
-    m_button_matrix_out_idx = 0;
 
     // Default selection
     m_selected_octave = 3;
-    m_selected_waveform = &square_wave;
-    m_texture = fxpt_Q0_31(1<<30);
-    m_leds |= (1<<LED_WAVEFORM_SQUARE_ENABLED_IDX);
+    select_voice(VOICE_SQUARE_IDX);
+    m_texture = SmoothedParameter<fxpt_Q0_31>(fxpt_Q0_31(1<<30), TEXTURE_SMOOTHING_BLOCKS, SMOOTHING_LINEAR);
 
     // Default ADSR
     m_attack_fs = (ATTACK_MAX_FS - ATTACK_MIN_FS) / 2;
     m_decay_fs = 0.1 * AUDIO_SAMPLING_FREQUENCY; // 0.1 second
-    m_sustain = (SUSTAIN_MAX - SUSTAIN_MIN) / 2;
+    m_sustain = SmoothedParameter<fxpt_Q0_31>((SUSTAIN_MAX - SUSTAIN_MIN) / 2, SUSTAIN_SMOOTHING_BLOCKS, SMOOTHING_LINEAR);
     m_release_fs = (RELEASE_MAX_FS - RELEASE_MIN_FS) / 2;
 
     // Initialize filter parameters
-    m_filter_cutoff = FILTER_CUTOFF_MAX_HZ;
-    m_filter_cutoff_old = m_filter_cutoff;
+    m_filter_cutoff = SmoothedParameter<fxpt_UQ16_16>(FILTER_CUTOFF_MAX_HZ, FILTER_CUTOFF_SMOOTHING_BLOCKS, SMOOTHING_ONE_POLE);
+    m_filter_cutoff_old = m_filter_cutoff.get();
     m_filter_Q = fxpt_from_float(M_SQRT1_2, 29);
     m_filter_Q_old = m_filter_Q;
 
-    // Get ready for first button matrix read operation
-    gpio_put_1_from_high_z(PIN_BUTTON_MATRIX_OUT[m_button_matrix_out_idx]);
+    // The LFOs run, but the modulation matrix has no route by default, so that the default sound is left untouched
+    m_lfos[0] = Lfo(LFO_SINE, fxpt_from_float(4.f, 16));
+    m_lfos[1] = Lfo(LFO_TRIANGLE, fxpt_from_float(0.5f, 16), ~NOISE_DEFAULT_SEED);
+
+    // Potentiometers are unknown, so that their first reading is always published
+    for(unsigned int i = 0; i < NB_PIN_POTENTIOMETERS; ++i)
+    {
+        m_potentiometers[i] = std::numeric_limits<uint16_t>::max();
+    }
+
     // Turn on leds
     write_leds();
 }
 
 
-bool Controls::read_buttons(unsigned int time_fs)
+bool Controls::read_buttons()
 {
-    // This read operation could be handled by the PIO in order not to update the pin 1 time out of NB_PIN_BUTTON_MATRIX_OUT
+    // The matrix is scanned and debounced by the PIO, only its published states are read here.
     // Using charlieplexing could also provide a lot more buttons if needed (N^2-N instead of (N/2)^2)
 
-    // Do not do anything if called too early. This is done because two consecutive calls can interfer.
-    if(time_fs < m_button_time_fs_last_read + BUTTONS_READ_TIME_INTERVAL_FS)
+    // Index of the next event to be written, timestamps being written after states
+    const unsigned int l_write_idx =
+        ((dma_channel_hw_addr(m_button_timestamps_dma_channel)->write_addr - reinterpret_cast<uintptr_t>(m_button_timestamps_ring_buffer))
+        / sizeof(uint32_t)) % SIZE_BUTTON_EVENTS_RING_BUFFER;
+
+    // Nothing to do if no new state has been published
+    if(l_write_idx == m_button_events_read_idx)
     {
         return false;
     }
-    // Update last time read was actually done
-    m_button_time_fs_last_read = time_fs;
 
     // Old buttons state are now current state
     m_buttons_old = m_buttons;
-
-    // A bit mask with NB_PIN_BUTTON_MATRIX_IN 1's.
-    constexpr uint32_t l_input_mask = (1U << NB_PIN_BUTTON_MATRIX_IN) - 1;
-
-    // Reading all buttons of this row, and put relevant bits in lsb
-    // WARNING : this only works if the pins used as input are contiguous and ordered.
-    const uint32_t l_buttons_inputs = (gpio_get_all() >> PIN_BUTTON_MATRIX_IN[0]) & l_input_mask;
-    // Retrieve last status of these buttons
-    const uint32_t l_buttons_inputs_prev = (m_buttons_raw >> (m_button_matrix_out_idx * NB_PIN_BUTTON_MATRIX_IN)) & l_input_mask;
-    // Update stability of these buttons
-    if(l_buttons_inputs == l_buttons_inputs_prev)
-    {
-        m_buttons_stability_count[m_button_matrix_out_idx]++;
-    }
-    else
-    {
-        m_buttons_stability_count[m_button_matrix_out_idx] = 0;
-    }
-    // Copy read buttons to raw buttons bit array for next read
-    m_buttons_raw &= ~(l_input_mask << (m_button_matrix_out_idx * NB_PIN_BUTTON_MATRIX_IN));
-    m_buttons_raw |= l_buttons_inputs << (m_button_matrix_out_idx * NB_PIN_BUTTON_MATRIX_IN);
-
-    // Check if these buttons are stable
-    if(m_buttons_stability_count[m_button_matrix_out_idx] == BUTTONS_STABILITY_THRESHOLD)
-    {
-        // Copy read buttons to raw buttons bit array
-        m_buttons &= ~(l_input_mask << (m_button_matrix_out_idx * NB_PIN_BUTTON_MATRIX_IN));
-        m_buttons |= (l_buttons_inputs << (m_button_matrix_out_idx * NB_PIN_BUTTON_MATRIX_IN));
-
-        #if DEBUG > 1
-        printf("Buttons stable : 0x%08x\n", m_buttons);
-        #endif
-    }
-    #if DEBUG > 1
-    else if(m_buttons_stability_count[m_button_matrix_out_idx] < BUTTONS_STABILITY_THRESHOLD)
-    {
-        printf("Buttons transient (%u) : 0x%08x\n", m_buttons_stability_count[m_button_matrix_out_idx], m_buttons_raw);
-    }
-    #endif
-
-    // Disconnect gpio from matrix in order to read next row of button matrix
-    gpio_put_high_z(PIN_BUTTON_MATRIX_OUT[m_button_matrix_out_idx]);
-    // Increment index of the active row
-    if(++m_button_matrix_out_idx == NB_PIN_BUTTON_MATRIX_OUT)
-    {
-        m_button_matrix_out_idx = 0;
-    }
-    // Set next output to high
-    gpio_put_1_from_high_z(PIN_BUTTON_MATRIX_OUT[m_button_matrix_out_idx]);
+    m_buttons = m_button_states_ring_buffer[m_button_events_read_idx];
+    m_buttons_time_us = m_button_timestamps_ring_buffer[m_button_events_read_idx];
+    m_button_events_read_idx = (m_button_events_read_idx + 1) % SIZE_BUTTON_EVENTS_RING_BUFFER;
 
     #ifdef DEBUG
     if(m_buttons != m_buttons_old)
     {
-        printf("Buttons changed : 0x%08x to 0x%08x\n", m_buttons_old, m_buttons);
+        printf("Buttons changed : 0x%08x to 0x%08x (%u us ago)\n", m_buttons_old, m_buttons, time_us_32() - m_buttons_time_us);
     }
     #endif
 
@@ -201,26 +164,14 @@ void Controls::process_buttons()
         #endif
     }
 
-    // Process waveform change
+    // Process voice change, the waveforms and then the other layers being selected in turn
     if((m_buttons & (1<<BUTTON_WAVEFORM_SELECT_IDX)) && ~(m_buttons_old & (1<<BUTTON_WAVEFORM_SELECT_IDX)))
     {
-        if(m_selected_waveform == &square_wave)
-        {
-            m_selected_waveform = &saw_wave;
-            m_leds &= ~(1<<LED_WAVEFORM_SQUARE_ENABLED_IDX);
-            m_leds |= (1<<LED_WAVEFORM_SAW_ENABLED_IDX);
-        }
-        // There are only two waveforms possible
-        else
-        {
-            m_selected_waveform = &square_wave;
-            m_leds &= ~(1<<LED_WAVEFORM_SAW_ENABLED_IDX);
-            m_leds |= (1<<LED_WAVEFORM_SQUARE_ENABLED_IDX);
-        }
+        select_voice((m_selected_voice + 1) % NB_VOICES);
         // Maybe set m_texture to relevant value, although it will be overwritten next time its potentiometer is read
         l_leds_need_refresh = true;
         #ifdef DEBUG
-        printf("Waveform change ! Is now %d\n", m_selected_waveform);
+        printf("Voice change ! Is now %u\n", m_selected_voice);
         #endif
     }
 
@@ -246,7 +197,43 @@ void Controls::write_leds() const
 }
 
 
-void Controls::set_potentiometer(unsigned int potentiometer_idx, uint8_t value)
+void Controls::select_voice(unsigned int voice_idx)
+{
+    m_selected_voice = voice_idx;
+
+    // The waveform is kept when a layer is selected, its oscillators being muted by the crossfade anyway
+    switch(voice_idx)
+    {
+    case VOICE_SQUARE_IDX:
+        m_selected_waveform = &square_wave;
+        break;
+
+    case VOICE_SAW_IDX:
+        m_selected_waveform = &saw_wave;
+        break;
+
+    case VOICE_SINE_IDX:
+        m_selected_waveform = &sine_wave;
+        break;
+
+    default:
+        break;
+    }
+
+    // A layer is heard alone, the others being muted
+    m_pluck_level = (voice_idx == VOICE_PLUCK_IDX) ? std::numeric_limits<fxpt_Q0_31>::max() : 0;
+    m_fm_level = (voice_idx == VOICE_FM_IDX) ? std::numeric_limits<fxpt_Q0_31>::max() : 0;
+    m_sample_level = (voice_idx == VOICE_SAMPLE_IDX) ? std::numeric_limits<fxpt_Q0_31>::max() : 0;
+    m_noise_level = (voice_idx == VOICE_NOISE_IDX) ? std::numeric_limits<fxpt_Q0_31>::max() : 0;
+    ++m_patch_version;
+
+    // The voices are counted in binary on the LEDs, from 1 so that one LED is always lit
+    constexpr uint32_t l_leds_msk = (1<<LED_WAVEFORM_SQUARE_ENABLED_IDX) | (1<<LED_WAVEFORM_SAW_ENABLED_IDX) | (1<<LED_VOICE_LAYER_ENABLED_IDX);
+    m_leds = (m_leds & ~l_leds_msk) | ((voice_idx + 1) << LED_WAVEFORM_SQUARE_ENABLED_IDX);
+}
+
+
+void Controls::set_potentiometer(unsigned int potentiometer_idx, uint16_t value)
 {
     #if DEBUG == 3
     printf("ADC %u : %u\n", potentiometer_idx, value);
@@ -256,42 +243,41 @@ void Controls::set_potentiometer(unsigned int potentiometer_idx, uint8_t value)
     switch (potentiometer_idx)
     {
     case POTENTIOMETER_ATTACK_IDX:
+    {
         // Attack potentiometer is converted to logarithmic (this could be achieved by using a logarithmic pot directly)
-        // fxpt8 is simply an exponential mapping [0, 255] -> [0, 255], its output can be considered in fxpt_UQ0.8
-        m_attack_fs = ATTACK_MIN_FS + fxpt_convert_n((ufxpt64_t)(ATTACK_MAX_FS-ATTACK_MIN_FS) * (ufxpt64_t)fxpt8_pow2(value), 8, 0);
+        const fxpt_UQ0_16 l_exponential = get_exponential_mapping(value);
+        m_attack_fs = ATTACK_MIN_FS + fxpt_convert_n((ufxpt64_t)(ATTACK_MAX_FS-ATTACK_MIN_FS) * (ufxpt64_t)l_exponential, 16, 0);
         // While only two pots can be used for ADSR, release is also controlled by attack potentiometer
-        m_release_fs = RELEASE_MIN_FS + fxpt_convert_n((ufxpt64_t)(RELEASE_MAX_FS-RELEASE_MIN_FS) * (ufxpt64_t)fxpt_UQ0_8(fxpt8_pow2(value)), 8, 0);
+        m_release_fs = RELEASE_MIN_FS + fxpt_convert_n((ufxpt64_t)(RELEASE_MAX_FS-RELEASE_MIN_FS) * (ufxpt64_t)l_exponential, 16, 0);
+        ++m_patch_version;
         //printf("atk : %u -> %u\n", value, m_attack_fs);
         break;
+    }
 
     case POTENTIOMETER_SUSTAIN_IDX:
-        // Sustain is linear between min and max, comes in fxpt_UQ0.8
-        m_sustain = SUSTAIN_MIN + fxpt_convert_n((fxpt64_t)(SUSTAIN_MAX-SUSTAIN_MIN) * (fxpt64_t)value, 31+8, 31);
-        //printf("sus : %u -> %f\n", value, fxpt_to_float(m_sustain, 31));
+        // Sustain is linear between min and max, comes in fxpt_UQ0.12
+        m_sustain.set_target(SUSTAIN_MIN + fxpt_convert_n((fxpt64_t)(SUSTAIN_MAX-SUSTAIN_MIN) * (fxpt64_t)value, 31+POTENTIOMETERS_BIT_DEPTH, 31));
+        //printf("sus : %u -> %f\n", value, fxpt_to_float(m_sustain.get_target(), 31));
         break;
 
     case POTENTIOMETER_FILTER_CUTOFF_IDX:
         // Filter cutoff potentiometer is converted to logarithmic (this could be achieved by using a logarithmic pot directly)
-        m_filter_cutoff = FILTER_CUTOFF_MIN_HZ
-            + fxpt_convert_n((ufxpt64_t)(FILTER_CUTOFF_MAX_HZ-FILTER_CUTOFF_MIN_HZ) * (ufxpt64_t)fxpt8_pow2(value), 16+8, 16);
-        //printf("fc : %u -> %f\n", value, fxpt_to_float(m_filter_cutoff, 16));
+        m_filter_cutoff.set_target(FILTER_CUTOFF_MIN_HZ
+            + fxpt_convert_n((ufxpt64_t)(FILTER_CUTOFF_MAX_HZ-FILTER_CUTOFF_MIN_HZ) * (ufxpt64_t)get_exponential_mapping(value), 16+16, 16));
+        //printf("fc : %u -> %f\n", value, fxpt_to_float(m_filter_cutoff.get_target(), 16));
         break;
 
     case POTENTIOMETER_TEXTURE_IDX:
         // Update texture parameter according to selected waveform
         if(m_selected_waveform == &square_wave)
         {
-            // Square wave can have a duty cycle between 0 and 0.5, so value can be interpreted as fxpt_UQ-1.9
-            m_texture = fxpt_convert_n((fxpt_Q0_31)value, 9, 31);
-        }
-        else if(m_selected_waveform == &square_wave)
-        {
-            // Saw wave does not have a texture parameter yet
-            m_texture = 0;
+            // Square wave can have a duty cycle between 0 and 0.5, so value can be interpreted as fxpt_UQ-1.13
+            m_texture.set_target(fxpt_convert_n((fxpt_Q0_31)value, POTENTIOMETERS_BIT_DEPTH+1, 31));
         }
         else
         {
-            // Unhandled case, should not occur
+            // Saw and sine waves do not have a texture parameter yet
+            m_texture.set_target(0);
         }
     
     default:
@@ -300,24 +286,173 @@ void Controls::set_potentiometer(unsigned int potentiometer_idx, uint8_t value)
     }
 }
 
+
+void Controls::set_controller(MidiByte controller, MidiByte value)
+{
+    #ifdef DEBUG
+    printf("Controller %u : %u\n", controller, value);
+    #endif
+
+    switch(controller)
+    {
+    case CONTROLLER_SAMPLE_LEVEL:
+        m_sample_level = get_controller_level(value);
+        break;
+
+    case CONTROLLER_SAMPLE_INDEX:
+        // Only notes started afterwards play the new sample
+        m_sample_index = value;
+        break;
+
+    case CONTROLLER_SAMPLE_INTERPOLATION:
+        // The lower half of the course selects the linear interpolation, the upper half the cubic one
+        m_sample_interpolation = (value < 64) ? SAMPLE_INTERPOLATION_LINEAR : SAMPLE_INTERPOLATION_CUBIC;
+        break;
+
+    case CONTROLLER_NOISE_LEVEL:
+        m_noise_level = get_controller_level(value);
+        break;
+
+    case CONTROLLER_NOISE_COLOR:
+        // The course is split in three, from white to brown noise
+        m_noise_color = (value < 43) ? NOISE_WHITE : ((value < 86) ? NOISE_PINK : NOISE_BROWN);
+        break;
+
+    default:
+        // Unhandled controller
+        break;
+    }
+}
+
+
+void Controls::read_potentiometers()
+{
+    // Restart the capture in the unlikely case the DMA has reached the end of its transfer count
+    if(!dma_channel_is_busy(m_adc_dma_channel))
+    {
+        dma_channel_set_trans_count(m_adc_dma_channel, std::numeric_limits<uint32_t>::max(), true);
+    }
+
+    for(unsigned int i = 0; i < NB_PIN_POTENTIOMETERS; ++i)
+    {
+        // Average all samples of this channel in the ring buffer, whatever the DMA write position
+        unsigned int l_sum = 0;
+        for(unsigned int j = i; j < SIZE_ADC_RING_BUFFER; j += NB_ADC_CHANNELS)
+        {
+            l_sum += m_adc_ring_buffer[j];
+        }
+        uint16_t l_value = l_sum / ADC_OVERSAMPLING;
+
+        // Snap the values at both ends of the course
+        if(l_value < POTENTIOMETERS_DEADBAND)
+        {
+            l_value = 0;
+        }
+        else if(l_value > POTENTIOMETERS_MAX - POTENTIOMETERS_DEADBAND)
+        {
+            l_value = POTENTIOMETERS_MAX;
+        }
+
+        // Only publish values that moved more than the hysteresis, or that have just reached an end
+        const uint16_t l_value_old = m_potentiometers[i];
+        const uint16_t l_delta = (l_value > l_value_old) ? (l_value - l_value_old) : (l_value_old - l_value);
+        if((l_delta >= POTENTIOMETERS_HYSTERESIS) || ((l_value != l_value_old) && (l_value == 0 || l_value == POTENTIOMETERS_MAX)))
+        {
+            m_potentiometers[i] = l_value;
+            set_potentiometer(i, l_value);
+        }
+    }
+}
+
+
+#ifdef AUDIO_INPUT
+bool Controls::read_audio_input(fxpt_Q0_31* samples)
+{
+    constexpr unsigned int l_size_half = SIZE_ADC_RING_BUFFER / 2;
+    static_assert(l_size_half == NB_ADC_CHANNELS * SIZE_AUDIO_BLOCK, "Each half of the ADC ring buffer must hold one audio block");
+
+    // The half being written by the DMA, the other one is complete
+    const unsigned int l_write_idx =
+        ((dma_channel_hw_addr(m_adc_dma_channel)->write_addr - reinterpret_cast<uintptr_t>(m_adc_ring_buffer))
+        / sizeof(uint16_t)) % SIZE_ADC_RING_BUFFER;
+    const unsigned int l_half_complete = 1 - (l_write_idx / l_size_half);
+    if(l_half_complete == m_audio_input_half_read)
+    {
+        return false;
+    }
+
+    m_audio_input.process_block(&m_adc_ring_buffer[l_half_complete * l_size_half + ADC_AUDIO_INPUT_IDX], NB_ADC_CHANNELS,
+        samples, SIZE_AUDIO_BLOCK);
+    m_audio_input_half_read = l_half_complete;
+    return true;
+}
+#endif
+
+
+fxpt_UQ0_16 Controls::get_exponential_mapping(uint16_t value)
+{
+    // 2^(8*value/2^12) is in [1, 256[, computing 2^(8 + 8*value/2^12) instead keeps 8 more bits of precision
+    // 8*value/2^12 is value in UQ5.27 shifted by 27-12+3 bits
+    constexpr unsigned int l_shift = FXPT32_LOG2_DEC_PREC - POTENTIOMETERS_BIT_DEPTH + 3;
+    return fxpt32_pow2(fxpt_dec_step((fxpt_UQ5_27)value, l_shift) + fxpt_dec_step((fxpt_UQ5_27)8, FXPT32_LOG2_DEC_PREC));
+}
+
+
 bool Controls::have_filter_params_changed()
 {
-    const bool l_has_changed = (m_filter_cutoff != m_filter_cutoff_old) || (m_filter_Q != m_filter_Q_old);
-    m_filter_cutoff_old = m_filter_cutoff;
+    const bool l_has_changed = (m_filter_cutoff.get() != m_filter_cutoff_old) || (m_filter_Q != m_filter_Q_old);
+    m_filter_cutoff_old = m_filter_cutoff.get();
     m_filter_Q_old = m_filter_Q;
     return l_has_changed;
 }
 
 
+void Controls::update_parameters()
+{
+    // Publish the potentiometers that have changed since last block
+    read_potentiometers();
+
+    // Only the smoothed values are seen by the DSP, intermediate potentiometers values are lost
+    // The attacks and decays cached with the former values are stale
+    if(m_sustain.update())
+    {
+        ++m_patch_version;
+    }
+    if(m_texture.update())
+    {
+        ++m_patch_version;
+    }
+    m_filter_cutoff.update();
+
+    for(unsigned int i = 0; i < NB_LFOS; ++i)
+    {
+        m_lfos[i].update();
+    }
+}
+
+
+fxpt_UQ16_16 Controls::get_modulated_filter_cutoff(fxpt_Q0_31 modulation) const
+{
+    // cutoff * 2^(range*modulation) is computed as cutoff * 2^(range*modulation + range + 16) / 2^(range + 16),
+    // so that the exponent is positive and the power of 2 keeps 16 bits of precision
+    constexpr unsigned int l_offset = MODULATION_FILTER_CUTOFF_RANGE_OCTAVES + 16;
+    const fxpt_UQ5_27 l_exponent = fxpt_convert_n((fxpt64_t)modulation * MODULATION_FILTER_CUTOFF_RANGE_OCTAVES, 31, FXPT32_LOG2_DEC_PREC)
+        + fxpt_dec_step((fxpt_UQ5_27)l_offset, FXPT32_LOG2_DEC_PREC);
+    const ufxpt64_t l_cutoff = fxpt_inc_step((ufxpt64_t)m_filter_cutoff.get() * (ufxpt64_t)fxpt32_pow2(l_exponent), l_offset);
+
+    return (l_cutoff > FILTER_CUTOFF_MAX_HZ) ? FILTER_CUTOFF_MAX_HZ : ((l_cutoff < FILTER_CUTOFF_MIN_HZ) ? FILTER_CUTOFF_MIN_HZ : l_cutoff);
+}
+
+
 void initialize_controls()
 {
-    // Setup the outputs for the button matrix
+    // The PIO program scans exactly 5 rows and 5 columns, each on consecutive pins
+    static_assert(NB_PIN_BUTTON_MATRIX_OUT == 5 && NB_PIN_BUTTON_MATRIX_IN == 5, "Button matrix must be 5x5");
+
+    // Setup the pulled-down outputs for the button matrix, they are put to high impedance when not scanned
+    // For some reason the buttons matrix rows interfer with the next row if not pulled 
     for(unsigned int i = 0; i < NB_PIN_BUTTON_MATRIX_OUT; ++i)
     {
-        gpio_init(PIN_BUTTON_MATRIX_OUT[i]);
-        // gpios are not put to GPIO_OUT since high-z state puts them as inputs
-        gpio_put_high_z(PIN_BUTTON_MATRIX_OUT[i]);
-        // For some reason the buttons matrix rows interfer with the next row if not pulled 
         gpio_pull_down(PIN_BUTTON_MATRIX_OUT[i]);
     }
 
@@ -342,7 +477,39 @@ void initialize_controls()
     gpio_set_dir(PIN_LED_ONBOARD, GPIO_OUT);
 
     // Get the Controls instance in order to initialize it
-    Controls::get_instance();
+    Controls& controls = Controls::get_instance();
+
+    // Setup the DMA to copy each published button state, then the time at which it was copied.
+    // Both channels trigger each other so that states and timestamps are written in lockstep.
+    controls.m_button_states_dma_channel = dma_claim_unused_channel(true);
+    controls.m_button_timestamps_dma_channel = dma_claim_unused_channel(true);
+
+    dma_channel_config l_timestamps_dma_config = dma_channel_get_default_config(controls.m_button_timestamps_dma_channel);
+    channel_config_set_transfer_data_size(&l_timestamps_dma_config, DMA_SIZE_32);
+    channel_config_set_read_increment(&l_timestamps_dma_config, false);
+    channel_config_set_write_increment(&l_timestamps_dma_config, true);
+    channel_config_set_ring(&l_timestamps_dma_config, true, fxpt_log2(sizeof(controls.m_button_timestamps_ring_buffer)));
+    channel_config_set_chain_to(&l_timestamps_dma_config, controls.m_button_states_dma_channel);
+    dma_channel_configure(controls.m_button_timestamps_dma_channel, &l_timestamps_dma_config,
+        controls.m_button_timestamps_ring_buffer, &timer_hw->timerawl, 1, false);
+
+    // Load the program and start scanning on a free state machine
+    const unsigned int l_sm = pio_claim_unused_sm(pio0, true);
+    const unsigned int l_offset = pio_add_program(pio0, &button_matrix_program);
+
+    dma_channel_config l_states_dma_config = dma_channel_get_default_config(controls.m_button_states_dma_channel);
+    channel_config_set_transfer_data_size(&l_states_dma_config, DMA_SIZE_32);
+    channel_config_set_read_increment(&l_states_dma_config, false);
+    channel_config_set_write_increment(&l_states_dma_config, true);
+    channel_config_set_ring(&l_states_dma_config, true, fxpt_log2(sizeof(controls.m_button_states_ring_buffer)));
+    channel_config_set_dreq(&l_states_dma_config, pio_get_dreq(pio0, l_sm, false));
+    channel_config_set_chain_to(&l_states_dma_config, controls.m_button_timestamps_dma_channel);
+    dma_channel_configure(controls.m_button_states_dma_channel, &l_states_dma_config,
+        controls.m_button_states_ring_buffer, &pio0->rxf[l_sm], 1, true);
+
+    const float l_clkdiv = (static_cast<float>(SYSTEM_CLOCK_FREQUENCY_KHZ) * 1000.f * Controls::BUTTONS_SCAN_PERIOD_S)
+        / BUTTON_MATRIX_CYCLES_PER_SCAN;
+    button_matrix_program_init(pio0, l_sm, l_offset, PIN_BUTTON_MATRIX_OUT[0], PIN_BUTTON_MATRIX_IN[0], l_clkdiv);
 
     // Initialize ADC
     adc_init();
@@ -350,48 +517,36 @@ void initialize_controls()
     {
         adc_gpio_init(PIN_POTENTIOMETERS[i]);
     }
+    #ifdef AUDIO_INPUT
+    adc_gpio_init(PIN_AUDIO_INPUT);
+    #endif
     // Set adc conversion speed
     adc_set_clkdiv((static_cast<float>(ADC_BASE_CLOCK_HZ) / POTENTIOMETERS_REFRESH_RATE_HZ) - 1.f);
-    // Set ADC to reed all inputs alternatively (mask with NB_PIN_POTENTIOMETERS ones)
-    adc_set_round_robin((1<<NB_PIN_POTENTIOMETERS)-1);
+    // Set ADC to read all inputs alternatively (mask with NB_ADC_CHANNELS ones)
+    adc_set_round_robin((1<<NB_ADC_CHANNELS)-1);
     // Disable temperature sensor
     adc_set_temp_sensor_enabled(false);
-    // Enable ADC interrupts
-    irq_clear(ADC_IRQ_FIFO);
-    adc_irq_set_enabled(true);
-    irq_set_exclusive_handler(ADC_IRQ_FIFO, adc_irq_handler);
     // Setup ADC to write its results in fifo :
-    // - Disable DMA request
-    // - Interrupt is raised with 1 sample in the fifo
+    // - Enable DMA request
+    // - DMA request is raised with 1 sample in the fifo
     // - Disable error bit,
-    // - Enable byte shift so that result is on one byte only
-    adc_fifo_setup(true, false, 1, false, true);
-    // Authorize ADC FIFO to raise interrupts
-    irq_set_enabled(ADC_IRQ_FIFO, true);
-
-    // Start ADC in free-running mode
+    // - Disable byte shift so that result keeps its 12 bits
+    adc_fifo_setup(true, true, 1, false, false);
+
+    // Setup the DMA to copy ADC results in the ring buffer, without any interrupt
+    controls.m_adc_dma_channel = dma_claim_unused_channel(true);
+    dma_channel_config l_dma_config = dma_channel_get_default_config(controls.m_adc_dma_channel);
+    channel_config_set_transfer_data_size(&l_dma_config, DMA_SIZE_16);
+    channel_config_set_read_increment(&l_dma_config, false);
+    channel_config_set_write_increment(&l_dma_config, true);
+    // Wrap write address around the ring buffer, whose size in bytes is a power of two
+    channel_config_set_ring(&l_dma_config, true, fxpt_log2(sizeof(controls.m_adc_ring_buffer)));
+    channel_config_set_dreq(&l_dma_config, DREQ_ADC);
+    // Transfer count is as big as possible, see Controls::read_potentiometers
+    dma_channel_configure(controls.m_adc_dma_channel, &l_dma_config,
+        controls.m_adc_ring_buffer, &adc_hw->fifo, std::numeric_limits<uint32_t>::max(), true);
+
+    // Start ADC in free-running mode, first sample being channel 0 like the first ring buffer index
     adc_select_input(0);
     adc_run(true);
-}
-
-
-void adc_irq_handler()
-{
-    // IRQ is cleared by draining the result fifo below the threshold, which is 1 here.
-
-    // A static variable remembering which adc channel is used
-    // adc_get_selected_input() cannot be used since next conversion has already started
-    static unsigned int sl_adc_channel = 0;
-
-    // Should not block since function is triggered by ADC itself
-    const uint8_t l_adc_value = adc_fifo_get_blocking();
-
-    // Send to Controls instance
-    Controls::get_instance().set_potentiometer(sl_adc_channel, l_adc_value);
-
-    // A new conversion has started on the next channel
-    if(++sl_adc_channel == NB_PIN_POTENTIOMETERS)
-    {
-        sl_adc_channel = 0;
-    }
 }
\ No newline at end of file
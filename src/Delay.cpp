@@ -0,0 +1,99 @@
+/**
+ * Synthpathy is a small and versatile audio synthesizer on a microcontroler. 
+ * Copyright (C) 2022  Brice Croix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "Delay.h"
+
+/**
+ * @brief Saturate a 64 bits value to the Q0.31 range.
+ * 
+ * @param x 
+ * @return fxpt_Q0_31 
+ */
+static inline fxpt_Q0_31 saturate_Q0_31(fxpt64_t x)
+{
+    return (x > std::numeric_limits<fxpt_Q0_31>::max()) ? std::numeric_limits<fxpt_Q0_31>::max() :
+        ((x < -std::numeric_limits<fxpt_Q0_31>::max()) ? -std::numeric_limits<fxpt_Q0_31>::max() : x);
+}
+
+Delay::Delay(unsigned int delay_ms, fxpt_Q0_31 feedback, fxpt_Q0_31 mix, fxpt_Q0_31 damping) :
+    m_delay_fs(fxpt_convert_n(1, 0, 16), DELAY_SMOOTHING_BLOCKS, SMOOTHING_LINEAR),
+    m_mix(mix),
+    m_damping(damping),
+    m_damped(0)
+{
+    set_feedback(feedback);
+    set_delay_ms(delay_ms);
+    // Do not slide from the minimum delay at start
+    m_delay_fs.set_value(m_delay_fs.get_target());
+}
+
+void Delay::set_delay_ms(unsigned int delay_ms)
+{
+    // Saturate before conversion to avoid overflows
+    delay_ms = (delay_ms > DELAY_MAX_MS) ? DELAY_MAX_MS : delay_ms;
+    set_delay_fs(fxpt_convert_n((fxpt64_t)delay_ms * AUDIO_SAMPLING_FREQUENCY, 0, 16) / 1000);
+}
+
+void Delay::set_delay_tempo(unsigned int tempo_bpm, unsigned int numerator, unsigned int denominator)
+{
+    // A null tempo or denominator would divide by zero : clamp them to 1, the delay then saturates to DELAY_MAX_FS
+    const unsigned int l_tempo_bpm = (tempo_bpm < 1) ? 1 : tempo_bpm;
+    const unsigned int l_denominator = (denominator < 1) ? 1 : denominator;
+
+    // One beat lasts 60 / tempo seconds
+    const fxpt64_t l_delay_fs = fxpt_convert_n((fxpt64_t)AUDIO_SAMPLING_FREQUENCY * 60 * numerator, 0, 16) / ((fxpt64_t)l_tempo_bpm * l_denominator);
+    set_delay_fs((l_delay_fs > fxpt_convert_n((fxpt64_t)DELAY_MAX_FS, 0, 16)) ? fxpt_convert_n(DELAY_MAX_FS, 0, 16) : l_delay_fs);
+}
+
+void Delay::set_delay_fs(fxpt_UQ16_16 delay_fs)
+{
+    constexpr fxpt_UQ16_16 l_min = fxpt_convert_n(1U, 0, 16);
+    constexpr fxpt_UQ16_16 l_max = fxpt_convert_n(DELAY_MAX_FS, 0, 16);
+    m_delay_fs.set_target((delay_fs < l_min) ? l_min : ((delay_fs > l_max) ? l_max : delay_fs));
+}
+
+void Delay::clear()
+{
+    m_line.clear();
+    m_damped = 0;
+}
+
+void Delay::process_block(fxpt_Q0_31* samples, unsigned int nb_samples)
+{
+    m_delay_fs.update();
+    const fxpt_UQ16_16 l_delay_fs = m_delay_fs.get();
+    // The damping filter is y += (x - y) * (1 - damping)
+    const fxpt_Q0_31 l_damping_gain = std::numeric_limits<fxpt_Q0_31>::max() - m_damping;
+
+    for(unsigned int i = 0; i < nb_samples; ++i)
+    {
+        const fxpt_Q0_31 l_delayed = fxpt_convert_n((fxpt_Q0_31)m_line.read_interpolated(l_delay_fs), 15, 31);
+
+        // Damp the repetition
+        m_damped += fxpt_convert_n(((fxpt64_t)l_delayed - (fxpt64_t)m_damped) * (fxpt64_t)l_damping_gain, 62, 31);
+
+        // Feed the input and the damped repetition back in the line
+        const fxpt_Q0_31 l_fed_back = saturate_Q0_31(
+            (fxpt64_t)samples[i] + fxpt_convert_n((fxpt64_t)m_damped * (fxpt64_t)m_feedback, 62, 31)
+        );
+        m_line.write(fxpt_convert_n(l_fed_back, 31, 15));
+
+        // Add the repetition to the dry signal
+        samples[i] = saturate_Q0_31((fxpt64_t)samples[i] + fxpt_convert_n((fxpt64_t)m_damped * (fxpt64_t)m_mix, 62, 31));
+    }
+}
\ No newline at end of file
@@ -0,0 +1,74 @@
+/**
+ * Synthpathy is a small and versatile audio synthesizer on a microcontroler. 
+ * Copyright (C) 2022  Brice Croix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "Lfo.h"
+
+Lfo::Lfo(LfoShape shape, fxpt_UQ16_16 frequency, uint32_t seed) :
+    m_noise(NOISE_WHITE, seed)
+{
+    m_shape = shape;
+    m_phase = 0;
+    m_value = 0;
+    set_frequency(frequency);
+}
+
+void Lfo::set_frequency(fxpt_UQ16_16 frequency)
+{
+    // increment = 2^32 * frequency / control rate, frequency being in UQ16.16
+    m_phase_increment = fxpt_dec_step((ufxpt64_t)frequency, 16) / CONTROL_RATE_HZ;
+}
+
+fxpt_Q0_31 Lfo::update()
+{
+    const fxpt_UQ0_32 l_phase_old = m_phase;
+    m_phase += m_phase_increment;
+
+    switch(m_shape)
+    {
+    case LFO_SINE:
+        // fxpt_sin takes a phase with 10 bits per period
+        m_value = fxpt_sin(fxpt_convert_n(m_phase, 32, 10));
+        break;
+
+    case LFO_TRIANGLE:
+    {
+        // Twice the phase, mirrored on second half of period, rises then falls over the full unsigned range
+        const fxpt_UQ0_32 l_ramp = (m_phase & (1U<<31)) ? ~(m_phase << 1) : (m_phase << 1);
+        m_value = fxpt32_signed_unsigned_map(l_ramp);
+        break;
+    }
+
+    case LFO_SAW:
+        m_value = fxpt32_signed_unsigned_map(m_phase);
+        break;
+
+    case LFO_SAMPLE_AND_HOLD:
+        // A new random value is drawn each time the phase wraps around
+        if(m_phase < l_phase_old)
+        {
+            m_value = m_noise.next_white();
+        }
+        break;
+
+    default:
+        // Unhandled case, should not occur
+        break;
+    }
+
+    return m_value;
+}
\ No newline at end of file
@@ -0,0 +1,66 @@
+/**
+ * Synthpathy is a small and versatile audio synthesizer on a microcontroler. 
+ * Copyright (C) 2022  Brice Croix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "MasterBus.h"
+
+MasterBus::MasterBus(fxpt_UQ16_16 gain)
+{
+    set_gain(gain);
+    m_envelope = 0;
+}
+
+fxpt_Q0_31 MasterBus::limit(fxpt64_t level) const
+{
+    // The knee is symmetrical, it is indexed by the excess of the absolute level over the threshold
+    constexpr unsigned int l_idx_shift = 16;
+    static_assert(((fxpt64_t)LIMITER_LUT_SIZE << l_idx_shift) == LIMITER_KNEE_SPAN,
+        "The index shift must match the span and the size of the knee table");
+
+    if(m_envelope > (fxpt64_t(1) << 31))
+    {
+        // The gain 2^31 / envelope is computed with a 32 bits division, on the 16 most significant bits of the envelope.
+        // They are rounded up so that the level stays below full scale.
+        const unsigned int l_shift = (63 - __builtin_clzll(m_envelope)) - 15;
+        const uint32_t l_gain = (1U << 31) / (uint32_t)((m_envelope >> l_shift) + 1);
+        level = (level * l_gain) >> l_shift;
+    }
+
+    const bool l_is_negative = level < 0;
+    const fxpt64_t l_excess = (l_is_negative ? -level : level) - LIMITER_THRESHOLD;
+
+    fxpt_Q0_31 l_limited;
+    if(l_excess <= 0)
+    {
+        return level;
+    }
+    else if(l_excess >= LIMITER_KNEE_SPAN)
+    {
+        l_limited = LIMITER_KNEE_LUT[LIMITER_LUT_SIZE];
+    }
+    else
+    {
+        // Linear interpolation between two values of the knee
+        const unsigned int l_idx = l_excess >> l_idx_shift;
+        const fxpt64_t l_fraction = l_excess & ((1<<l_idx_shift) - 1);
+        const fxpt64_t l_y0 = LIMITER_KNEE_LUT[l_idx];
+        const fxpt64_t l_y1 = LIMITER_KNEE_LUT[l_idx + 1];
+        l_limited = l_y0 + fxpt_convert_n((l_y1 - l_y0) * l_fraction, l_idx_shift, 0);
+    }
+
+    return l_is_negative ? -l_limited : l_limited;
+}
\ No newline at end of file
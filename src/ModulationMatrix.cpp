@@ -0,0 +1,71 @@
+/**
+ * Synthpathy is a small and versatile audio synthesizer on a microcontroler. 
+ * Copyright (C) 2022  Brice Croix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "ModulationMatrix.h"
+
+#include <limits>
+
+ModulationMatrix::ModulationMatrix()
+{
+    m_nb_routes = 0;
+}
+
+bool ModulationMatrix::add_route(ModulationSource source, ModulationDestination destination, fxpt_Q1_30 amount)
+{
+    if(m_nb_routes == NB_MODULATION_ROUTES_MAX)
+    {
+        return false;
+    }
+    m_routes[m_nb_routes].source = source;
+    m_routes[m_nb_routes].destination = destination;
+    m_routes[m_nb_routes].amount = amount;
+    m_nb_routes++;
+    return true;
+}
+
+bool ModulationMatrix::is_modulated(ModulationDestination destination) const
+{
+    for(unsigned int i = 0; i < m_nb_routes; ++i)
+    {
+        if(m_routes[i].destination == destination)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void ModulationMatrix::evaluate(const fxpt_Q0_31 sources[NB_MODULATION_SOURCES], fxpt_Q0_31 destinations[NB_MODULATION_DESTINATIONS]) const
+{
+    // Accumulate on 64 bits so that several routes on the same parameter cannot overflow, in Q32.31
+    fxpt64_t l_sums[NB_MODULATION_DESTINATIONS] = {0};
+
+    for(unsigned int i = 0; i < m_nb_routes; ++i)
+    {
+        // Q1.30 multiplied by Q0.31 gives Q2.61
+        l_sums[m_routes[i].destination] +=
+            fxpt_convert_n((fxpt64_t)m_routes[i].amount * (fxpt64_t)sources[m_routes[i].source], 61, 31);
+    }
+
+    // Saturate each modulation between -1 and 1
+    constexpr fxpt_Q0_31 l_one = std::numeric_limits<fxpt_Q0_31>::max();
+    for(unsigned int i = 0; i < NB_MODULATION_DESTINATIONS; ++i)
+    {
+        destinations[i] = (l_sums[i] > l_one) ? l_one : ((l_sums[i] < -l_one) ? -l_one : l_sums[i]);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,99 @@
+/**
+ * Synthpathy is a small and versatile audio synthesizer on a microcontroler. 
+ * Copyright (C) 2022  Brice Croix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "NoiseGenerator.h"
+
+#include <limits>
+
+NoiseGenerator::NoiseGenerator(NoiseColor color, uint32_t seed)
+{
+    m_color = color;
+    this->seed(seed);
+}
+
+void NoiseGenerator::seed(uint32_t seed)
+{
+    // The xorshift state must never be null, it would stay null forever
+    m_state = (seed != 0) ? seed : NOISE_DEFAULT_SEED;
+    for(unsigned int i = 0; i < 3; ++i)
+    {
+        m_pink_states[i] = 0;
+    }
+    m_brown_state = 0;
+}
+
+void NoiseGenerator::fill_block(fxpt_Q0_31* samples, unsigned int nb_samples)
+{
+    switch(m_color)
+    {
+    case NOISE_WHITE:
+        for(unsigned int i = 0; i < nb_samples; ++i)
+        {
+            samples[i] = next_white();
+        }
+        break;
+
+    case NOISE_PINK:
+    {
+        // Paul Kellet's economy filter, the states are kept in Q3.28 since their sum reaches about 8.
+        // The output is the sum read as Q0.31, hence divided by 8, and saturated since its peaks come close to 8.
+        constexpr fxpt_Q1_30 l_poles[3] = {
+            (fxpt_Q1_30)fxpt_from_float(0.99765f, 30), (fxpt_Q1_30)fxpt_from_float(0.963f, 30), (fxpt_Q1_30)fxpt_from_float(0.57f, 30)
+        };
+        constexpr fxpt_Q1_30 l_gains[3] = {
+            (fxpt_Q1_30)fxpt_from_float(0.099046f, 30), (fxpt_Q1_30)fxpt_from_float(0.2965164f, 30), (fxpt_Q1_30)fxpt_from_float(1.0526913f, 30)
+        };
+        constexpr fxpt_Q1_30 l_direct_gain = fxpt_from_float(0.1848f, 30);
+        constexpr fxpt64_t l_max = std::numeric_limits<fxpt_Q3_28>::max();
+        constexpr fxpt64_t l_min = std::numeric_limits<fxpt_Q3_28>::min();
+        for(unsigned int i = 0; i < nb_samples; ++i)
+        {
+            const fxpt64_t l_white = fxpt_convert_n(next_white(), 31, 28);
+            fxpt64_t l_pink = fxpt_convert_n(l_white * l_direct_gain, 30, 0);
+            for(unsigned int j = 0; j < 3; ++j)
+            {
+                m_pink_states[j] = fxpt_convert_n((fxpt64_t)m_pink_states[j] * l_poles[j] + l_white * l_gains[j], 30, 0);
+                l_pink += m_pink_states[j];
+            }
+            samples[i] = (l_pink > l_max) ? l_max : ((l_pink < l_min) ? l_min : l_pink);
+        }
+        break;
+    }
+
+    case NOISE_BROWN:
+    {
+        // The integrator leaks towards the white noise, as a one-pole low-pass filter of unit gain.
+        // Its output is amplified 4 times, so that its RMS value is about 0.2.
+        constexpr unsigned int l_shift = 6;
+        constexpr unsigned int l_gain_shift = 2;
+        constexpr fxpt64_t l_max = std::numeric_limits<fxpt_Q0_31>::max();
+        constexpr fxpt64_t l_min = std::numeric_limits<fxpt_Q0_31>::min();
+        for(unsigned int i = 0; i < nb_samples; ++i)
+        {
+            m_brown_state += (next_white() >> l_shift) - (m_brown_state >> l_shift);
+            const fxpt64_t l_brown = (fxpt64_t)m_brown_state << l_gain_shift;
+            samples[i] = (l_brown > l_max) ? l_max : ((l_brown < l_min) ? l_min : l_brown);
+        }
+        break;
+    }
+
+    default:
+        // Unhandled case, should not occur
+        break;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,97 @@
+/**
+ * Synthpathy is a small and versatile audio synthesizer on a microcontroler. 
+ * Copyright (C) 2022  Brice Croix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "NoteCache.h"
+
+#include <limits>
+
+NoteCache::NoteCache()
+{
+    m_patch_version = 0;
+    for(unsigned int i = 0; i < NOTE_CACHE_NB_ENTRIES; ++i)
+    {
+        m_midi_notes[i] = 0;
+        m_lengths[i] = 0;
+        m_patch_versions[i] = 0;
+        m_nb_users[i] = 0;
+        m_times_used_fs[i] = 0;
+    }
+}
+
+int NoteCache::find(MidiByte midi_note, unsigned int time_fs)
+{
+    for(unsigned int i = 0; i < NOTE_CACHE_NB_ENTRIES; ++i)
+    {
+        if(m_midi_notes[i] == midi_note && m_lengths[i] != 0 && m_patch_versions[i] == m_patch_version)
+        {
+            m_nb_users[i]++;
+            m_times_used_fs[i] = time_fs;
+            return i;
+        }
+    }
+    return NOTE_CACHE_NO_ENTRY;
+}
+
+int NoteCache::record(MidiByte midi_note, unsigned int time_fs)
+{
+    int l_entry = NOTE_CACHE_NO_ENTRY;
+    unsigned int l_age_max = 0;
+    for(unsigned int i = 0; i < NOTE_CACHE_NB_ENTRIES; ++i)
+    {
+        const bool l_is_current = m_patch_versions[i] == m_patch_version;
+        // The note is already being recorded by another note
+        if(m_midi_notes[i] == midi_note && m_lengths[i] == 0 && m_nb_users[i] != 0 && l_is_current)
+        {
+            return NOTE_CACHE_NO_ENTRY;
+        }
+        if(m_nb_users[i] == 0)
+        {
+            // Empty and stale entries are replaced first, then the least recently used one
+            const unsigned int l_age = (m_lengths[i] == 0 || !l_is_current) ?
+                std::numeric_limits<unsigned int>::max() : time_fs - m_times_used_fs[i];
+            if(l_entry == NOTE_CACHE_NO_ENTRY || l_age > l_age_max)
+            {
+                l_entry = i;
+                l_age_max = l_age;
+            }
+        }
+    }
+
+    if(l_entry != NOTE_CACHE_NO_ENTRY)
+    {
+        m_midi_notes[l_entry] = midi_note;
+        m_lengths[l_entry] = 0;
+        m_patch_versions[l_entry] = m_patch_version;
+        m_nb_users[l_entry] = 1;
+        m_times_used_fs[l_entry] = time_fs;
+    }
+    return l_entry;
+}
+
+void NoteCache::release(int entry, unsigned int nb_recorded_frames)
+{
+    if(entry != NOTE_CACHE_NO_ENTRY)
+    {
+        m_nb_users[entry]--;
+        // A recording is only kept when complete
+        if(nb_recorded_frames != 0)
+        {
+            m_lengths[entry] = nb_recorded_frames;
+        }
+    }
+}
\ No newline at end of file
@@ -24,18 +24,67 @@
 #include <stdio.h>
 #endif
 
-NoteManager::NoteManager()
+NoteManager::NoteManager() :
+    m_sample_bank(reinterpret_cast<const void*>(XIP_BASE + SAMPLE_BANK_FLASH_OFFSET))
 {
     for(unsigned int i = 0; i < NB_ACTIVE_NOTES; ++i)
     {
         m_active_notes_pool[i].kill();
     }
+    m_pitch_bend = 0;
+    m_aftertouch = 0;
+    for(unsigned int i = 0; i < NB_MODULATION_DESTINATIONS; ++i)
+    {
+        m_global_modulations[i] = 0;
+    }
+}
+
+bool NoteManager::is_patch_cacheable() const
+{
+    #ifdef AUDIO_OVERSAMPLING
+    // The cache would bring back the aliasing of the oscillators
+    return false;
+    #else
+    const Controls& controls = Controls::get_instance();
+    // The other layers have a state of their own, the noise being different for each note
+    return controls.get_noise_level() == 0 && controls.get_fm_level() == 0 && controls.get_pluck_level() == 0
+        && controls.get_sample_level() == 0 && m_pitch_bend == 0
+        #ifdef AUDIO_STEREO
+        && controls.get_unison().get_nb_oscillators() <= 1
+        #endif
+        ;
+    #endif
+}
+
+void NoteManager::detach_cache(ActiveNote& note, unsigned int time_fs)
+{
+    unsigned int l_nb_recorded_frames;
+    const int l_entry = note.detach_cache(time_fs, l_nb_recorded_frames);
+    m_note_cache.release(l_entry, l_nb_recorded_frames);
+}
+
+unsigned int NoteManager::get_nb_cached_notes() const
+{
+    unsigned int l_nb_notes = 0;
+    for(unsigned int i = 0; i < NB_ACTIVE_NOTES; ++i)
+    {
+        // An entry being recorded has no length yet
+        const int l_entry = m_active_notes_pool[i].get_cache_entry();
+        if(l_entry != NOTE_CACHE_NO_ENTRY && m_note_cache.get_length(l_entry) != 0)
+        {
+            ++l_nb_notes;
+        }
+    }
+    return l_nb_notes;
 }
 
 void NoteManager::update_active_notes(unsigned int time_fs)
 {
     unsigned int i;
+    const ActiveNote* l_glide_note;
+    fxpt_Q15_16 l_glide_pitch;
     const Controls& controls = Controls::get_instance();
+    m_note_cache.set_patch_version(controls.get_patch_version());
 
     // The midi buffer will be empty most of the time
     while(!g_midi_internal_buffer.is_empty())
@@ -57,6 +106,19 @@ void NoteManager::update_active_notes(unsigned int time_fs)
         {
             // A new note must be created
             case MIDI_NOTE_ON:
+                // Search for the most recent note still held, to glide from
+                l_glide_note = nullptr;
+                for(i = 0; i < NB_ACTIVE_NOTES; ++i)
+                {
+                    ActiveNote& note = m_active_notes_pool[i];
+                    if(note.is_alive(time_fs) && !note.is_released() &&
+                        (l_glide_note == nullptr || note.get_time_start_fs() >= l_glide_note->get_time_start_fs()))
+                    {
+                        l_glide_note = &note;
+                    }
+                }
+                l_glide_pitch = (l_glide_note != nullptr) ? l_glide_note->get_pitch() : 0;
+
                 // Search for an available index in the pool
                 i = 0;
                 do
@@ -69,8 +131,53 @@ void NoteManager::update_active_notes(unsigned int time_fs)
 
                         // The midi velocity can be interpreted as Q0.7
                         const fxpt_Q0_31 velocity = fxpt_convert_n(l_midi_data2, 7, 31);
+                        // The dead note may not have given its delay line back yet
+                        m_pluck_arena.release(m_active_notes_pool[i].detach_pluck());
+                        detach_cache(m_active_notes_pool[i], time_fs);
                         // Add the new note to the pool, perhaps sustain should also be fixed to avoid jitter
                         m_active_notes_pool[i] = ActiveNote(l_midi_data1, velocity, time_fs, controls.get_attack_fs(), controls.get_decay_fs());
+                        // The string is plucked when the note starts, only if it is heard
+                        if(controls.get_pluck_level() != 0)
+                        {
+                            const int l_slot = m_pluck_arena.allocate();
+                            if(l_slot != DELAY_ARENA_NO_SLOT)
+                            {
+                                m_active_notes_pool[i].pluck(m_pluck_arena.get_line(l_slot), l_slot);
+                            }
+                        }
+                        // Likewise for the sample, which stays silent if the bank has no such sample
+                        Sample l_sample;
+                        if(controls.get_sample_level() != 0 && m_sample_bank.get_sample(controls.get_sample_index(), l_sample))
+                        {
+                            m_active_notes_pool[i].start_sample(l_sample);
+                        }
+                        // Notes are panned along the keyboard, the middle of the midi range being centered
+                        m_active_notes_pool[i].set_pan(fxpt_convert_n((fxpt64_t)controls.get_stereo_spread() * ((fxpt64_t)l_midi_data1 - 64), 6, 0));
+                        // Legato notes glide from the previous one
+                        if(l_glide_note != nullptr && controls.get_glide_blocks() > 0)
+                        {
+                            m_active_notes_pool[i].glide_from(l_glide_pitch, controls.get_glide_blocks());
+                        }
+                        // Otherwise a static patch streams the attack and decay from the cache, or records them for the next notes
+                        else if(is_patch_cacheable())
+                        {
+                            int l_entry = m_note_cache.find(l_midi_data1, time_fs);
+                            if(l_entry != NOTE_CACHE_NO_ENTRY)
+                            {
+                                m_active_notes_pool[i].stream_cache(m_note_cache.get_frames(l_entry), m_note_cache.get_length(l_entry), l_entry);
+                            }
+                            else
+                            {
+                                // Whole audio blocks are recorded, the end of the longer envelopes being synthesized live
+                                const unsigned int l_length = (controls.get_attack_fs() + controls.get_decay_fs() + SIZE_AUDIO_BLOCK - 1) & ~(SIZE_AUDIO_BLOCK - 1);
+                                l_entry = m_note_cache.record(l_midi_data1, time_fs);
+                                if(l_entry != NOTE_CACHE_NO_ENTRY)
+                                {
+                                    m_active_notes_pool[i].record_cache(m_note_cache.get_frames(l_entry),
+                                        (l_length < NoteCache::ENTRY_SIZE) ? l_length : NoteCache::ENTRY_SIZE, l_entry);
+                                }
+                            }
+                        }
                         break;
                     }
                 }
@@ -99,7 +206,24 @@ void NoteManager::update_active_notes(unsigned int time_fs)
                 while ((++i) < NB_ACTIVE_NOTES);
                 break;
 
+            case MIDI_CONTROLLER_CHANGE:
+                // The controllers set the parameters of the layers that have no potentiometer
+                Controls::get_instance().set_controller(l_midi_data1, l_midi_data2);
+                break;
+
             case MIDI_AFTERTOUCH_CHANNEL:
+                // The midi pressure can be interpreted as Q0.7
+                m_aftertouch = fxpt_convert_n(l_midi_data1, 7, 31);
+                break;
+
+            case MIDI_PITCH_BEND:
+                // The 14 bits bend is centered, PITCH_BEND_RANGE_SEMITONES being reached at both ends
+                m_pitch_bend = fxpt_convert_n(
+                    ((fxpt_Q15_16)(l_midi_data1 | (l_midi_data2 << 7)) - (fxpt_Q15_16)MIDI_PITCH_BEND_CENTER) * (fxpt_Q15_16)PITCH_BEND_RANGE_SEMITONES,
+                    13, 16
+                );
+                break;
+
             case MIDI_AFTERTOUCH_NOTE:
                 // TODO : handle these cases, and other
 
@@ -110,12 +234,102 @@ void NoteManager::update_active_notes(unsigned int time_fs)
     }
 }
 
+void NoteManager::update_modulation(unsigned int time_fs)
+{
+    const Controls& controls = Controls::get_instance();
+    const ModulationMatrix& matrix = controls.get_modulation_matrix();
+
+    fxpt_Q0_31 l_sources[NB_MODULATION_SOURCES];
+    l_sources[MODULATION_SOURCE_LFO1] = controls.get_lfo_value(0);
+    l_sources[MODULATION_SOURCE_LFO2] = controls.get_lfo_value(1);
+    l_sources[MODULATION_SOURCE_AFTERTOUCH] = m_aftertouch;
+
+    // Shared parameters follow the most recent note, notes sources are null when none is alive
+    fxpt_Q0_31 l_latest_envelope = 0;
+    fxpt_Q0_31 l_latest_velocity = 0;
+    unsigned int l_latest_time_start_fs = 0;
+
+    // Pitch offset common to all notes, computed once
+    const fxpt_Q15_16 l_pitch_offset = m_pitch_bend + controls.get_fine_tune();
+    // Noise is only generated when it is heard
+    const bool l_is_noise_mixed = controls.get_noise_level() != 0;
+    // Likewise for the FM voice
+    const bool l_is_fm_mixed = controls.get_fm_level() != 0;
+    const bool l_is_pluck_mixed = controls.get_pluck_level() != 0;
+    const bool l_is_sample_mixed = controls.get_sample_level() != 0;
+    // The notes streaming or recording a stale entry of the cache are synthesized live
+    m_note_cache.set_patch_version(controls.get_patch_version());
+    const bool l_is_patch_cacheable = is_patch_cacheable();
+    // The part of the waveform left once crossfaded with each of the other layers
+    const fxpt_Q0_31 l_mixed_levels[4] = {controls.get_fm_level(), controls.get_pluck_level(), controls.get_sample_level(), controls.get_noise_level()};
+    fxpt_Q0_31 l_waveform_weight = std::numeric_limits<fxpt_Q0_31>::max();
+    for(unsigned int k = 0; k < 4; ++k)
+    {
+        l_waveform_weight = fxpt_convert_n((fxpt64_t)l_waveform_weight * (fxpt64_t)(std::numeric_limits<fxpt_Q0_31>::max() - l_mixed_levels[k]), 31, 0);
+    }
+
+    // Evaluate the matrix for each note, with its own envelope and velocity
+    fxpt_Q0_31 l_modulations[NB_MODULATION_DESTINATIONS];
+    for(unsigned int i = 0; i < NB_ACTIVE_NOTES; ++i)
+    {
+        ActiveNote& note = m_active_notes_pool[i];
+        if(note.is_alive(time_fs))
+        {
+            l_sources[MODULATION_SOURCE_ENVELOPE] = note.get_ADSR_envelope(time_fs, controls.get_sustain());
+            l_sources[MODULATION_SOURCE_VELOCITY] = note.get_velocity();
+            matrix.evaluate(l_sources, l_modulations);
+            note.set_modulation(l_modulations);
+            note.update_pitch(l_pitch_offset);
+            // The note leaves the cache at the end of its entry, or as soon as it is released, gliding or modulated
+            const int l_entry = note.get_cache_entry();
+            if(l_entry != NOTE_CACHE_NO_ENTRY && !(l_is_patch_cacheable && m_note_cache.is_current(l_entry) && note.can_follow_cache(time_fs)))
+            {
+                detach_cache(note, time_fs);
+            }
+            // The unison replaces the waveform, which is always rendered
+            note.render_unison(controls.get_unison(), controls.get_selected_waveform(), controls.get_texture(), l_waveform_weight);
+            if(l_is_noise_mixed)
+            {
+                note.render_noise(controls.get_noise_color());
+            }
+            if(l_is_fm_mixed)
+            {
+                note.render_fm(controls.get_fm_patch(), time_fs);
+            }
+            if(l_is_pluck_mixed)
+            {
+                note.render_pluck(controls.get_pluck_damping());
+            }
+            if(l_is_sample_mixed)
+            {
+                note.render_sample(controls.get_sample_interpolation());
+            }
+
+            if(note.get_time_start_fs() >= l_latest_time_start_fs)
+            {
+                l_latest_time_start_fs = note.get_time_start_fs();
+                l_latest_envelope = l_sources[MODULATION_SOURCE_ENVELOPE];
+                l_latest_velocity = l_sources[MODULATION_SOURCE_VELOCITY];
+            }
+        }
+        else
+        {
+            // A dead note gives its delay line back, so that another note can be plucked
+            m_pluck_arena.release(note.detach_pluck());
+            detach_cache(note, time_fs);
+        }
+    }
+
+    l_sources[MODULATION_SOURCE_ENVELOPE] = l_latest_envelope;
+    l_sources[MODULATION_SOURCE_VELOCITY] = l_latest_velocity;
+    matrix.evaluate(l_sources, m_global_modulations);
+}
+
 fxpt_Q0_31 NoteManager::get_audio(unsigned int time_fs)
 {
     const Controls& controls = Controls::get_instance();
-    // 2 bits for integer part allows for 4 active notes without overflow
-    // TODO check if 64 bits is an option in order not to lose 2 bits of precision for each note
-    fxpt_Q2_29 l_audio_value = 0;
+    // The sum is accumulated on 64 bits, so that no precision is lost whatever the number of notes
+    fxpt64_t l_audio_value = 0;
     // Add output of each single note
     for(unsigned int i = 0; i < NB_ACTIVE_NOTES; ++i)
     {
@@ -123,14 +337,111 @@ fxpt_Q0_31 NoteManager::get_audio(unsigned int time_fs)
             time_fs,
             controls.get_selected_waveform(),
             controls.get_texture(),
-            controls.get_sustain()
+            controls.get_sustain(),
+            controls.get_noise_level(),
+            controls.get_fm_level(),
+            controls.get_pluck_level(),
+            controls.get_sample_level()
         );
-        // Convert each value to 2 integer bits
-        l_audio_value += fxpt_convert_m(l_audio_value_single, 0, 2);
+        l_audio_value += l_audio_value_single;
     }
 
-    // Each note contribution has amplitude 1, sum must stay of amplitude 1
-    l_audio_value /= NB_ACTIVE_NOTES;
+    // The sum is not divided by the number of notes anymore, the limiter compresses the loudest chords instead
+    return m_master_bus.process(l_audio_value);
+}
+
+void NoteManager::get_audio_stereo(unsigned int time_fs, fxpt_Q0_31* frame)
+{
+    const Controls& controls = Controls::get_instance();
+    // Each channel is accumulated on 64 bits, as in get_audio
+    fxpt64_t l_audio_value_left = 0;
+    fxpt64_t l_audio_value_right = 0;
+    for(unsigned int i = 0; i < NB_ACTIVE_NOTES; ++i)
+    {
+        ActiveNote& note = m_active_notes_pool[i];
+        const fxpt_Q0_31 l_audio_value_single = note.get_audio_value(
+            time_fs,
+            controls.get_selected_waveform(),
+            controls.get_texture(),
+            controls.get_sustain(),
+            controls.get_noise_level(),
+            controls.get_fm_level(),
+            controls.get_pluck_level(),
+            controls.get_sample_level()
+        );
+        #ifdef AUDIO_STEREO
+        // The unison oscillators are spread around the position of the note
+        const fxpt_Q0_31 l_unison_side = note.get_unison_side(time_fs);
+        #else
+        const fxpt_Q0_31 l_unison_side = 0;
+        #endif
+        mix_panned(note, l_audio_value_single, l_unison_side, l_audio_value_left, l_audio_value_right);
+    }
 
-    return fxpt_convert_m(l_audio_value, 2, 0);
+    frame[0] = m_master_bus.process(l_audio_value_left);
+    frame[1] = m_master_bus.process(l_audio_value_right);
+}
+
+void NoteManager::get_audio_block(unsigned int time_fs, fxpt_Q0_31* block)
+{
+#ifdef AUDIO_OVERSAMPLING
+    const Controls& controls = Controls::get_instance();
+    for(unsigned int i = 0; i < SIZE_AUDIO_BLOCK; ++i)
+    {
+        // Each sub-sample is accumulated on 64 bits, as in get_audio
+        fxpt64_t l_mix[NB_AUDIO_CHANNELS][OVERSAMPLING_FACTOR] = {};
+        for(unsigned int n = 0; n < NB_ACTIVE_NOTES; ++n)
+        {
+            ActiveNote& note = m_active_notes_pool[n];
+            fxpt_Q0_31 l_values[OVERSAMPLING_FACTOR];
+            note.get_audio_values_oversampled(
+                time_fs + i,
+                controls.get_selected_waveform(),
+                controls.get_texture(),
+                controls.get_sustain(),
+                controls.get_noise_level(),
+                controls.get_fm_level(),
+                controls.get_pluck_level(),
+                controls.get_sample_level(),
+                l_values
+            );
+            for(unsigned int j = 0; j < OVERSAMPLING_FACTOR; ++j)
+            {
+                #ifdef AUDIO_STEREO
+                mix_panned(note, l_values[j], note.get_unison_side(time_fs + i, j), l_mix[0][j], l_mix[1][j]);
+                #else
+                l_mix[0][j] += l_values[j];
+                #endif
+            }
+        }
+        // The limiter also runs at the higher rate, so that its distortion is decimated as well
+        for(unsigned int c = 0; c < NB_AUDIO_CHANNELS; ++c)
+        {
+            for(unsigned int j = 0; j < OVERSAMPLING_FACTOR; ++j)
+            {
+                m_oversampled_mix[c][OVERSAMPLING_FACTOR * i + j] = m_master_bus.process(l_mix[c][j]);
+            }
+        }
+    }
+
+    // Only the mix is decimated, not each note
+    fxpt_Q0_31 l_channel[SIZE_AUDIO_BLOCK];
+    for(unsigned int c = 0; c < NB_AUDIO_CHANNELS; ++c)
+    {
+        m_decimators[c].process_block(m_oversampled_mix[c], l_channel, SIZE_AUDIO_BLOCK);
+        for(unsigned int i = 0; i < SIZE_AUDIO_BLOCK; ++i)
+        {
+            block[NB_AUDIO_CHANNELS * i + c] = l_channel[i];
+        }
+    }
+#else
+    for(unsigned int i = 0; i < SIZE_AUDIO_BLOCK; ++i)
+    {
+        #ifdef AUDIO_STEREO
+        get_audio_stereo(time_fs + i, &block[NB_AUDIO_CHANNELS * i]);
+        #else
+        block[i] = get_audio(time_fs + i);
+        #endif
+    }
+#endif
 }
\ No newline at end of file
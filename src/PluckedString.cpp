@@ -0,0 +1,102 @@
+/**
+ * Synthpathy is a small and versatile audio synthesizer on a microcontroler. 
+ * Copyright (C) 2022  Brice Croix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "PluckedString.h"
+
+#include <limits>
+
+PluckedString::PluckedString()
+{
+    m_line = nullptr;
+    m_write_idx = 0;
+    m_length = PLUCK_DELAY_LINE_SIZE - 2;
+    m_phase_increment = 0;
+    m_allpass_coeff = 0;
+    m_allpass_x1 = 0;
+    m_allpass_y1 = 0;
+    m_last_output = 0;
+}
+
+void PluckedString::pluck(fxpt_Q0_15* line, NoiseGenerator& noise)
+{
+    m_line = line;
+    // The whole line is filled, so that the string can be tuned lower afterwards
+    for(unsigned int i = 0; i < PLUCK_DELAY_LINE_SIZE; ++i)
+    {
+        m_line[i] = fxpt_convert_n(noise.next_white(), 31, 15);
+    }
+    m_write_idx = 0;
+    m_allpass_x1 = 0;
+    m_allpass_y1 = 0;
+    m_last_output = 0;
+}
+
+void PluckedString::tune(fxpt_UQ0_32 phase_increment)
+{
+    if(phase_increment == m_phase_increment || phase_increment == 0)
+    {
+        return;
+    }
+    m_phase_increment = phase_increment;
+
+    // The period in samples in Q16.16, limited by the delay line, minus the half sample of the loss filter
+    const uint64_t l_period = ((uint64_t)1 << 48) / phase_increment;
+    constexpr uint64_t l_period_max = fxpt_convert_n((uint64_t)PLUCK_DELAY_LINE_SIZE - 2, 0, 16);
+    const fxpt_Q15_16 l_delay = (fxpt_Q15_16)((l_period > l_period_max) ? l_period_max : l_period) - (1<<15);
+
+    // The all-pass filter is kept with a fractional delay between 0.1 and 1.1, where its delay is the flattest
+    constexpr fxpt_Q15_16 l_fraction_min = (1<<16) / 10;
+    constexpr fxpt_Q15_16 l_fraction_max = (1<<16) + (1<<16) / 10;
+    const fxpt_Q15_16 l_length = fxpt_convert_n(l_delay - l_fraction_min, 16, 0);
+    m_length = (l_length < 2) ? 2 : l_length;
+
+    // Fractional delay d, the all-pass coefficient being (1-d)/(1+d), computed by the hardware divider
+    const fxpt_Q15_16 l_fraction = l_delay - fxpt_convert_n((fxpt_Q15_16)m_length, 0, 16);
+    const fxpt_Q15_16 l_fraction_clamped = (l_fraction < l_fraction_min) ? l_fraction_min :
+        ((l_fraction > l_fraction_max) ? l_fraction_max : l_fraction);
+    m_allpass_coeff = fxpt_dec_step((1<<16) - l_fraction_clamped, 15) / ((1<<16) + l_fraction_clamped);
+}
+
+void PluckedString::render_block(fxpt_Q0_31* samples, unsigned int nb_samples, fxpt_Q0_15 damping)
+{
+    if(m_line == nullptr)
+    {
+        for(unsigned int i = 0; i < nb_samples; ++i)
+        {
+            samples[i] = 0;
+        }
+        return;
+    }
+
+    for(unsigned int i = 0; i < nb_samples; ++i)
+    {
+        const fxpt_Q16_15 l_output = m_line[(m_write_idx - m_length) & IDX_MSK];
+        // Two-point average and damping in a single product, (a + b) / 2 * g
+        const fxpt_Q16_15 l_lowpass = fxpt_convert_n((l_output + m_last_output) * damping, 16, 0);
+        m_last_output = l_output;
+        // First-order all-pass y = c * (x - y1) + x1, the difference needs 17 bits and c is below 1
+        const fxpt_Q16_15 l_allpass = fxpt_convert_n(m_allpass_coeff * (l_lowpass - m_allpass_y1), 15, 0) + m_allpass_x1;
+        m_allpass_x1 = l_lowpass;
+        m_allpass_y1 = l_allpass;
+        // The all-pass overshoots on transients, the line is saturated
+        m_line[m_write_idx] = (l_allpass > std::numeric_limits<fxpt_Q0_15>::max()) ? std::numeric_limits<fxpt_Q0_15>::max() :
+            ((l_allpass < std::numeric_limits<fxpt_Q0_15>::min()) ? std::numeric_limits<fxpt_Q0_15>::min() : l_allpass);
+        m_write_idx = (m_write_idx + 1) & IDX_MSK;
+        samples[i] = fxpt_convert_n(l_output, 15, 31);
+    }
+}
\ No newline at end of file
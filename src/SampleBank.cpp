@@ -0,0 +1,73 @@
+/**
+ * Synthpathy is a small and versatile audio synthesizer on a microcontroler. 
+ * Copyright (C) 2022  Brice Croix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "SampleBank.h"
+
+#include "global.h"
+#include "frequencies.h"
+
+#include <limits>
+
+SampleBank::SampleBank(const void* base)
+{
+    m_base = nullptr;
+    m_nb_samples = 0;
+
+    const SampleBankHeader* l_header = static_cast<const SampleBankHeader*>(base);
+    // Erased flash reads 0xFF, which is neither the magic number nor a valid number of samples
+    if(l_header->magic == SAMPLE_BANK_MAGIC && l_header->version == SAMPLE_BANK_VERSION &&
+        l_header->nb_samples <= SAMPLE_BANK_NB_SAMPLES_MAX)
+    {
+        m_base = static_cast<const uint8_t*>(base);
+        m_nb_samples = l_header->nb_samples;
+    }
+}
+
+bool SampleBank::get_sample(unsigned int index, Sample& sample) const
+{
+    if(index >= m_nb_samples)
+    {
+        return false;
+    }
+
+    const SampleBankEntry& l_entry = reinterpret_cast<const SampleBankEntry*>(m_base + sizeof(SampleBankHeader))[index];
+    if(l_entry.format >= NB_SAMPLE_FORMATS || l_entry.length == 0 || l_entry.loop_end > l_entry.length ||
+        (l_entry.offset & 3) != 0 || l_entry.sample_rate == 0)
+    {
+        return false;
+    }
+
+    // The phase increment of the root note at AUDIO_SAMPLING_FREQUENCY, scaled to the sampling frequency of the sample
+    const fxpt_Q15_16 l_root_pitch = fxpt_convert_n((fxpt_Q15_16)l_entry.root_note, 0, 16) +
+        (fxpt_Q15_16)l_entry.fine_tune * (1<<16) / 100;
+    const uint64_t l_unity_increment = (uint64_t)midi_pitch_to_phase_increment(l_root_pitch) *
+        AUDIO_SAMPLING_FREQUENCY / l_entry.sample_rate;
+    // The root note cannot be above the sampling frequency of the sample
+    if(l_unity_increment == 0 || l_unity_increment > std::numeric_limits<fxpt_UQ0_32>::max())
+    {
+        return false;
+    }
+
+    sample.data = m_base + l_entry.offset;
+    sample.length = l_entry.length;
+    sample.loop_start = l_entry.loop_start;
+    sample.loop_end = l_entry.loop_end;
+    sample.format = static_cast<SampleFormat>(l_entry.format);
+    sample.unity_increment = l_unity_increment;
+    return true;
+}
\ No newline at end of file
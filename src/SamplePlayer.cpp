@@ -0,0 +1,219 @@
+/**
+ * Synthpathy is a small and versatile audio synthesizer on a microcontroler. 
+ * Copyright (C) 2022  Brice Croix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "SamplePlayer.h"
+
+#include <limits>
+
+/**
+ * @brief Read a frame of a 16 bits sample.
+ * 
+ */
+static inline fxpt_Q16_15 sample_player_read(int16_t frame)
+{
+    return frame;
+}
+
+/**
+ * @brief Read a frame of an 8 bits sample, as a 16 bits one.
+ * 
+ */
+static inline fxpt_Q16_15 sample_player_read(int8_t frame)
+{
+    return fxpt_convert_n((fxpt_Q16_15)frame, 7, 15);
+}
+
+/**
+ * @brief The frames of a PCM sample, read in place.
+ * 
+ * @tparam Frame The type of the frames.
+ */
+template<class Frame>
+struct SamplePlayerPcmFrames
+{
+    const Frame* data;
+
+    inline fxpt_Q16_15 operator[](int index) const { return sample_player_read(data[index]); }
+};
+
+/**
+ * @brief The frames of an ADPCM sample, read in the ring of decoded frames by virtual index.
+ * 
+ */
+struct SamplePlayerRingFrames
+{
+    const int16_t* ring;
+
+    inline fxpt_Q16_15 operator[](int index) const { return ring[(unsigned int)index & AdpcmStream::RING_MSK]; }
+};
+
+SamplePlayer::SamplePlayer()
+{
+    m_sample.data = nullptr;
+    m_sample.length = 0;
+    m_sample.loop_start = 0;
+    m_sample.loop_end = 0;
+    m_sample.format = SAMPLE_FORMAT_PCM16;
+    m_sample.unity_increment = 0;
+    m_is_playing = false;
+    m_position = 0;
+    m_step = 0;
+    m_phase_increment = 0;
+}
+
+void SamplePlayer::start(const Sample& sample)
+{
+    m_sample = sample;
+    m_is_playing = true;
+    m_position = 0;
+    if(sample.format == SAMPLE_FORMAT_ADPCM)
+    {
+        m_stream.start(sample);
+    }
+    // The step is computed by the next call to tune
+    m_step = 0;
+    m_phase_increment = 0;
+}
+
+void SamplePlayer::tune(fxpt_UQ0_32 phase_increment)
+{
+    if(!m_is_playing || phase_increment == m_phase_increment)
+    {
+        return;
+    }
+    m_phase_increment = phase_increment;
+    // Both increments being UQ0.32, their ratio is the step in Q32.32, a single 64 bits division per pitch change
+    m_step = ((uint64_t)phase_increment << 32) / m_sample.unity_increment;
+    if(m_sample.format == SAMPLE_FORMAT_ADPCM && m_step > ADPCM_STEP_MAX)
+    {
+        m_step = ADPCM_STEP_MAX;
+    }
+}
+
+template<class Frames, SampleInterpolation interpolation>
+void SamplePlayer::render(const Frames& frames, fxpt_Q0_31* samples, unsigned int nb_samples, uint64_t end, uint64_t loop_length)
+{
+    uint64_t l_position = m_position;
+
+    for(unsigned int i = 0; i < nb_samples; ++i)
+    {
+        if(l_position >= end)
+        {
+            if(loop_length == 0)
+            {
+                for(; i < nb_samples; ++i)
+                {
+                    samples[i] = 0;
+                }
+                m_is_playing = false;
+                break;
+            }
+            // The step may be longer than a short loop
+            do
+            {
+                l_position -= loop_length;
+            }
+            while(l_position >= end);
+        }
+
+        // The neighbours of any frame are readable, without wrapping around
+        const int l_idx = (int)(l_position >> 32);
+        const fxpt_UQ0_32 l_fraction = (fxpt_UQ0_32)l_position;
+        if(interpolation == SAMPLE_INTERPOLATION_LINEAR)
+        {
+            const fxpt_Q16_15 l_x0 = frames[l_idx];
+            const fxpt_Q16_15 l_x1 = frames[l_idx + 1];
+            // The difference needs 17 bits, its product with a Q0.15 fraction still fits in 32 bits
+            const fxpt_Q16_15 l_t = fxpt_convert_n(l_fraction, 32, 15);
+            samples[i] = fxpt_convert_n(fxpt_convert_n(l_x0, 15, 30) + (l_x1 - l_x0) * l_t, 30, 31);
+        }
+        else
+        {
+            const fxpt_Q16_15 l_xm1 = frames[l_idx - 1];
+            const fxpt_Q16_15 l_x0 = frames[l_idx];
+            const fxpt_Q16_15 l_x1 = frames[l_idx + 1];
+            const fxpt_Q16_15 l_x2 = frames[l_idx + 2];
+            // Catmull-Rom coefficients, doubled so that they are integers, on 19 bits at most
+            const fxpt_Q16_15 l_c1 = l_x1 - l_xm1;
+            const fxpt_Q16_15 l_c2 = 2*l_xm1 - 5*l_x0 + 4*l_x1 - l_x2;
+            const fxpt_Q16_15 l_c3 = l_x2 - l_xm1 + 3*(l_x0 - l_x1);
+            // Horner scheme with a Q0.31 fraction, on 64 bits
+            const fxpt64_t l_t = fxpt_convert_n(l_fraction, 32, 31);
+            fxpt_Q16_15 l_y = fxpt_convert_n(l_c3 * l_t, 31, 0) + l_c2;
+            l_y = fxpt_convert_n(l_y * l_t, 31, 0) + l_c1;
+            l_y = fxpt_convert_n(l_y * l_t, 31, 0) + 2*l_x0;
+            // The cubic overshoots around steep frames, the doubled value is saturated on 17 bits
+            l_y = (l_y > (1<<16) - 1) ? (1<<16) - 1 : ((l_y < -(1<<16)) ? -(1<<16) : l_y);
+            samples[i] = fxpt_convert_n(l_y, 16, 31);
+        }
+        l_position += m_step;
+    }
+    m_position = l_position;
+}
+
+template<class Frames>
+void SamplePlayer::render(const Frames& frames, fxpt_Q0_31* samples, unsigned int nb_samples, SampleInterpolation interpolation, uint64_t end, uint64_t loop_length)
+{
+    // The interpolation is tested once per block
+    if(interpolation == SAMPLE_INTERPOLATION_CUBIC)
+    {
+        render<Frames, SAMPLE_INTERPOLATION_CUBIC>(frames, samples, nb_samples, end, loop_length);
+    }
+    else
+    {
+        render<Frames, SAMPLE_INTERPOLATION_LINEAR>(frames, samples, nb_samples, end, loop_length);
+    }
+}
+
+void SamplePlayer::render_block(fxpt_Q0_31* samples, unsigned int nb_samples, SampleInterpolation interpolation)
+{
+    if(!m_is_playing)
+    {
+        for(unsigned int i = 0; i < nb_samples; ++i)
+        {
+            samples[i] = 0;
+        }
+        return;
+    }
+
+    const bool l_is_looped = m_sample.loop_end > m_sample.loop_start;
+    if(m_sample.format == SAMPLE_FORMAT_ADPCM)
+    {
+        // All frames read by the block, the last cubic neighbours included, are decoded beforehand
+        m_stream.decode_until((uint32_t)((m_position + m_step * nb_samples) >> 32) + 3);
+        const SamplePlayerRingFrames l_frames = {m_stream.get_ring()};
+        // The positions are virtual indices, the stream follows the loop by itself
+        const uint64_t l_end = l_is_looped ? std::numeric_limits<uint64_t>::max() : (uint64_t)m_sample.length << 32;
+        render(l_frames, samples, nb_samples, interpolation, l_end, 0);
+        return;
+    }
+
+    // A looped sample ends with its loop, the guard frames after it being the beginning of the loop
+    const uint64_t l_end = (uint64_t)(l_is_looped ? m_sample.loop_end : m_sample.length) << 32;
+    const uint64_t l_loop_length = l_is_looped ? (uint64_t)(m_sample.loop_end - m_sample.loop_start) << 32 : 0;
+    if(m_sample.format == SAMPLE_FORMAT_PCM8)
+    {
+        const SamplePlayerPcmFrames<int8_t> l_frames = {static_cast<const int8_t*>(m_sample.data)};
+        render(l_frames, samples, nb_samples, interpolation, l_end, l_loop_length);
+    }
+    else
+    {
+        const SamplePlayerPcmFrames<int16_t> l_frames = {static_cast<const int16_t*>(m_sample.data)};
+        render(l_frames, samples, nb_samples, interpolation, l_end, l_loop_length);
+    }
+}
\ No newline at end of file
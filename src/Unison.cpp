@@ -0,0 +1,71 @@
+/**
+ * Synthpathy is a small and versatile audio synthesizer on a microcontroler. 
+ * Copyright (C) 2022  Brice Croix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "Unison.h"
+#include "frequencies.h"
+
+/**
+ * @brief 1/sqrt(n) for n from 1 to UNISON_NB_OSCILLATORS_MAX.
+ * 
+ */
+static const fxpt_Q0_31 UNISON_GAINS[UNISON_NB_OSCILLATORS_MAX] =
+{
+    2147483647, 1518500250, 1239850262, 1073741824, 960383883, 876706528, 811672525, 759250125
+};
+
+Unison::Unison(unsigned int nb_oscillators, fxpt_Q15_16 detune, fxpt_Q0_31 stereo_spread)
+{
+    m_nb_oscillators = 1;
+    m_detune = 0;
+    set_stereo_spread(stereo_spread);
+    set_nb_oscillators(nb_oscillators);
+    set_detune(detune);
+}
+
+void Unison::set_nb_oscillators(unsigned int nb_oscillators)
+{
+    m_nb_oscillators = (nb_oscillators < 1) ? 1 : ((nb_oscillators > UNISON_NB_OSCILLATORS_MAX) ? UNISON_NB_OSCILLATORS_MAX : nb_oscillators);
+    update_ratios();
+}
+
+void Unison::set_detune(fxpt_Q15_16 detune)
+{
+    // The ratios must stay below 2
+    constexpr fxpt_Q15_16 l_detune_max = fxpt_convert_n((fxpt_Q15_16)UNISON_DETUNE_MAX_SEMITONES, 0, 16);
+    m_detune = (detune < 0) ? 0 : ((detune > l_detune_max) ? l_detune_max : detune);
+    update_ratios();
+}
+
+fxpt_Q0_31 Unison::get_gain() const
+{
+    return UNISON_GAINS[m_nb_oscillators - 1];
+}
+
+void Unison::update_ratios()
+{
+    // The ratios are taken from the phase increments around a middle note
+    constexpr fxpt_Q15_16 l_reference_pitch = fxpt_convert_n((fxpt_Q15_16)64, 0, 16);
+    const fxpt_UQ0_32 l_reference_increment = midi_pitch_to_phase_increment(l_reference_pitch);
+    for(unsigned int k = 0; k < m_nb_oscillators; ++k)
+    {
+        // Detunes evenly spread from -detune to +detune
+        const fxpt_Q15_16 l_offset = (m_nb_oscillators > 1) ?
+            (fxpt_Q15_16)(((fxpt64_t)m_detune * (fxpt64_t)(2*(int)k - (int)(m_nb_oscillators - 1))) / (fxpt64_t)(m_nb_oscillators - 1)) : 0;
+        m_ratios[k] = ((uint64_t)midi_pitch_to_phase_increment(l_reference_pitch + l_offset) << 31) / l_reference_increment;
+    }
+}
\ No newline at end of file
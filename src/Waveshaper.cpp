@@ -0,0 +1,135 @@
+/**
+ * Synthpathy is a small and versatile audio synthesizer on a microcontroler. 
+ * Copyright (C) 2022  Brice Croix
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "Waveshaper.h"
+#include "waveshaper_curves.h"
+
+#include <limits>
+
+Waveshaper::Waveshaper(WaveshaperCurve curve, fxpt_UQ4_28 drive, bool oversampling) :
+    m_drive(drive)
+{
+    set_curve(curve);
+    set_oversampling(oversampling);
+}
+
+void Waveshaper::set_curve(WaveshaperCurve curve)
+{
+    m_curve_type = curve;
+    switch(curve)
+    {
+        case WAVESHAPER_CURVE_HARD_CLIP:
+            m_curve = WAVESHAPER_HARD_CLIP_LUT;
+            break;
+
+        case WAVESHAPER_CURVE_FUZZ:
+            m_curve = WAVESHAPER_FUZZ_LUT;
+            break;
+
+        case WAVESHAPER_CURVE_TANH:
+        default:
+            m_curve = WAVESHAPER_TANH_LUT;
+            break;
+    }
+}
+
+void Waveshaper::set_oversampling(bool oversampling)
+{
+    m_oversampling = oversampling;
+    // Filters restart from silence
+    for(unsigned int i = 0; i < SIZE_UPSAMPLER_HISTORY; ++i)
+    {
+        m_upsampler_history[i] = 0;
+    }
+    for(unsigned int i = 0; i < SIZE_DOWNSAMPLER_HISTORY; ++i)
+    {
+        m_downsampler_history[i] = 0;
+    }
+}
+
+fxpt_Q0_15 Waveshaper::shape(fxpt_Q0_31 x) const
+{
+    // Apply drive with saturation, Q0.31 multiplied by UQ4.28 gives Q4.59
+    fxpt64_t l_driven = fxpt_convert_n((fxpt64_t)x * (fxpt64_t)m_drive, 59, 31);
+    l_driven = (l_driven > std::numeric_limits<fxpt_Q0_31>::max()) ? std::numeric_limits<fxpt_Q0_31>::max() :
+        ((l_driven < -std::numeric_limits<fxpt_Q0_31>::max()) ? -std::numeric_limits<fxpt_Q0_31>::max() : l_driven);
+
+    // Map [-1, 1] to [0, 2^32[, the 8 most significant bits being the index in the table
+    const fxpt_UQ0_32 l_position = fxpt32_signed_unsigned_map((fxpt_Q0_31)l_driven);
+    const unsigned int l_idx = l_position >> 24;
+    // Keep 15 bits of fraction so that the product with a 17 bits difference fits in 32 bits
+    const fxpt_Q15_16 l_fraction = (l_position >> 9) & 0x7FFF;
+    return m_curve[l_idx] + fxpt_convert_n(((fxpt_Q15_16)m_curve[l_idx + 1] - (fxpt_Q15_16)m_curve[l_idx]) * l_fraction, 15, 0);
+}
+
+void Waveshaper::process_block(fxpt_Q0_31* samples, unsigned int nb_samples)
+{
+    if(!m_oversampling)
+    {
+        for(unsigned int i = 0; i < nb_samples; ++i)
+        {
+            samples[i] = fxpt_convert_n((fxpt_Q0_31)shape(samples[i]), 15, 31);
+        }
+        return;
+    }
+
+    // Both resampling filters are the half-band filter [3, 0, -25, 0, 150, 256, 150, 0, -25, 0, 3] / 512,
+    // whose even coefficients are null, except the central one
+    for(unsigned int i = 0; i < nb_samples; ++i)
+    {
+        // Upsampling : the even sample is a delayed input, the odd one is interpolated between its neighbours
+        const fxpt_Q0_31* l_x = m_upsampler_history;
+        const fxpt_Q0_31 l_input = samples[i];
+        fxpt64_t l_odd = (
+            150 * ((fxpt64_t)l_x[2] + (fxpt64_t)l_x[3])
+            - 25 * ((fxpt64_t)l_x[1] + (fxpt64_t)l_x[4])
+            + 3 * ((fxpt64_t)l_x[0] + (fxpt64_t)l_input)
+        ) / 256;
+        l_odd = (l_odd > std::numeric_limits<fxpt_Q0_31>::max()) ? std::numeric_limits<fxpt_Q0_31>::max() :
+            ((l_odd < -std::numeric_limits<fxpt_Q0_31>::max()) ? -std::numeric_limits<fxpt_Q0_31>::max() : l_odd);
+        const fxpt_Q0_31 l_even = l_x[2];
+        for(unsigned int j = 0; j < SIZE_UPSAMPLER_HISTORY - 1; ++j)
+        {
+            m_upsampler_history[j] = m_upsampler_history[j + 1];
+        }
+        m_upsampler_history[SIZE_UPSAMPLER_HISTORY - 1] = l_input;
+
+        // Apply the transfer curve at twice the sampling frequency
+        const fxpt_Q15_16 l_even_shaped = shape(l_even);
+        const fxpt_Q15_16 l_odd_shaped = shape(l_odd);
+
+        // Downsampling : filter and keep one sample out of two
+        const fxpt_Q15_16* l_z = m_downsampler_history;
+        fxpt_Q15_16 l_y = (
+            256 * l_z[5]
+            + 150 * (l_z[4] + l_z[6])
+            - 25 * (l_z[2] + l_z[8])
+            + 3 * (l_z[0] + l_odd_shaped)
+        ) / 512;
+        l_y = (l_y > std::numeric_limits<fxpt_Q0_15>::max()) ? std::numeric_limits<fxpt_Q0_15>::max() :
+            ((l_y < -std::numeric_limits<fxpt_Q0_15>::max()) ? -std::numeric_limits<fxpt_Q0_15>::max() : l_y);
+        for(unsigned int j = 0; j < SIZE_DOWNSAMPLER_HISTORY - 2; ++j)
+        {
+            m_downsampler_history[j] = m_downsampler_history[j + 2];
+        }
+        m_downsampler_history[SIZE_DOWNSAMPLER_HISTORY - 2] = l_even_shaped;
+        m_downsampler_history[SIZE_DOWNSAMPLER_HISTORY - 1] = l_odd_shaped;
+
+        samples[i] = fxpt_convert_n(l_y, 15, 31);
+    }
+}
\ No newline at end of file
@@ -46,6 +46,16 @@ void initialize_pwm_audio()
     //pwm_set_gpio_level(PIN_PWM_AUDIO_OUTPUT_L, 0);
     //pwm_set_gpio_level(PIN_PWM_AUDIO_OUTPUT_H, 0);
     pwm_set_both_levels(SLICE_PWM_AUDIO_OUTPUT, 0, 0);
+
+    #ifdef AUDIO_STEREO
+    // The right channel slice has the same configuration, but no interrupt : both slices are written by the same handler
+    gpio_init(PIN_PWM_AUDIO_OUTPUT_RIGHT_L);
+    gpio_init(PIN_PWM_AUDIO_OUTPUT_RIGHT_H);
+    gpio_set_function(PIN_PWM_AUDIO_OUTPUT_RIGHT_L, GPIO_FUNC_PWM);
+    gpio_set_function(PIN_PWM_AUDIO_OUTPUT_RIGHT_H, GPIO_FUNC_PWM);
+    pwm_init(SLICE_PWM_AUDIO_OUTPUT_RIGHT, &config, false);
+    pwm_set_both_levels(SLICE_PWM_AUDIO_OUTPUT_RIGHT, 0, 0);
+    #endif
 }
 
 
@@ -56,8 +66,15 @@ void pwm_wrap_interrupt_handler()
     // Increment time
     g_time_fs++;
 
-    // Recover computed audio sample
+    // Recover computed audio sample, the left one in stereo
+    #ifdef AUDIO_STEREO
+    // Both samples of a frame are popped at once, silence being output until the frame is complete :
+    // popping the left sample alone on an underrun would swap the channels for good
+    const bool l_is_frame_complete = g_output_audio_buffer.get_count() >= NB_AUDIO_CHANNELS;
+    const fxpt_Q0_31 l_audio_sample = l_is_frame_complete ? g_output_audio_buffer.pop_fast() : 0;
+    #else
     const fxpt_Q0_31 l_audio_sample = g_output_audio_buffer.pop();
+    #endif
 
     //if float between -1 and 1 :
     //uint16_t l_int_audio_value = (l_audio_sample + 1) * std::numeric_limits<uint16_t>::max() / 2;
@@ -69,12 +86,24 @@ void pwm_wrap_interrupt_handler()
     //pwm_set_gpio_level(PIN_PWM_AUDIO_OUTPUT_L, l_int_audio_value & 0x00FF);
     //pwm_set_gpio_level(PIN_PWM_AUDIO_OUTPUT_H, l_int_audio_value >> 8);
     pwm_set_both_levels(SLICE_PWM_AUDIO_OUTPUT, l_int_audio_value & 0x00FF, l_int_audio_value >> 8);
+
+    #ifdef AUDIO_STEREO
+    // The right sample always follows the left one
+    const fxpt_Q0_31 l_audio_sample_right = l_is_frame_complete ? g_output_audio_buffer.pop_fast() : 0;
+    const fxpt_UQ0_16 l_int_audio_value_right = fxpt_convert_n(fxpt32_signed_unsigned_map(l_audio_sample_right), 32, 16);
+    pwm_set_both_levels(SLICE_PWM_AUDIO_OUTPUT_RIGHT, l_int_audio_value_right & 0x00FF, l_int_audio_value_right >> 8);
+    #endif
 }
 
 
 void start_pwm_audio()
 {
+    #ifdef AUDIO_STEREO
+    // Both slices are started at once so that their counters stay in phase
+    pwm_set_mask_enabled((1<<SLICE_PWM_AUDIO_OUTPUT) | (1<<SLICE_PWM_AUDIO_OUTPUT_RIGHT));
+    #else
     pwm_set_enabled(SLICE_PWM_AUDIO_OUTPUT, true);
+    #endif
 }
 
 
@@ -82,4 +111,8 @@ void stop_pwm_audio()
 {
     pwm_set_both_levels(SLICE_PWM_AUDIO_OUTPUT, 0, 0);
     pwm_set_enabled(SLICE_PWM_AUDIO_OUTPUT, false);
+    #ifdef AUDIO_STEREO
+    pwm_set_both_levels(SLICE_PWM_AUDIO_OUTPUT_RIGHT, 0, 0);
+    pwm_set_enabled(SLICE_PWM_AUDIO_OUTPUT_RIGHT, false);
+    #endif
 }
\ No newline at end of file
@@ -24,4 +24,4 @@ volatile unsigned int g_time_fs;
 
 CircularBuffer<MidiEvent, 4> g_midi_internal_buffer;
 
-CircularBuffer<fxpt_Q0_31, SIZE_AUDIO_BUFFER> g_output_audio_buffer;
\ No newline at end of file
+CircularBuffer<fxpt_Q0_31, SIZE_AUDIO_BUFFER * NB_AUDIO_CHANNELS> g_output_audio_buffer;
\ No newline at end of file
@@ -34,11 +34,13 @@
 #include "tests.h"
 #endif
 
+#include <limits>
+
 #include "global.h"
 #include "audio_pwm.h"
 #include "Controls.h"
 #include "NoteManager.h"
-#include "Biquad.h"
+#include "effects.h"
 
 
 int panic();
@@ -83,20 +85,54 @@ int main() {
     Controls& controls = Controls::get_instance();
     // Retrieve the notes manager
     NoteManager& active_note_manager = NoteManager::get_instance();
-    // Create the low-pass filter and acknowledge that controls were taken into account
-    DynamicBiquad l_filter = DynamicBiquad(Biquad::get_low_pass(controls.get_filter_cutoff(), AUDIO_SAMPLING_FREQUENCY, controls.get_filter_Q()));
+    // Create the effects, with the low-pass filter, and acknowledge that controls were taken into account
+    // The chain is static since the delay line does not fit in the stack
+    static MasterEffectsChain l_effects;
+    for(unsigned int c = 0; c < NB_AUDIO_CHANNELS; ++c)
+    {
+        get_master_low_pass(l_effects, c) = DynamicBiquad(Biquad::get_low_pass(controls.get_filter_cutoff(), AUDIO_SAMPLING_FREQUENCY, controls.get_filter_Q()));
+    }
     controls.have_filter_params_changed();
+    // No control is assigned to the distortion, delay and reverberation yet, they are bypassed
+    l_effects.set_enabled<EFFECT_WAVESHAPER_IDX>(false);
+    l_effects.set_enabled<EFFECT_DELAY_IDX>(false);
+    l_effects.set_enabled<EFFECT_REVERB_IDX>(false);
+    // The cutoff frequency the filter is tending to, after modulation
+    fxpt_UQ16_16 l_filter_cutoff = controls.get_filter_cutoff();
 
 
     // A local value of time, that can be a little late on the global one
     unsigned int l_time_fs = 0;
 
+    // The block of samples being computed, channels being interleaved
+    fxpt_Q0_31 l_audio_block[SIZE_AUDIO_BLOCK * NB_AUDIO_CHANNELS];
+
+    #ifdef AUDIO_INPUT
+    // The last block read from the audio input
+    fxpt_Q0_31 l_input_block[SIZE_AUDIO_BLOCK] = {0};
+    #endif
+
     // Pre-compute buffer full of 0's, update time accordingly
+    #ifdef AUDIO_INPUT
+    // The output starts right after the DMA has captured a new block, which is rendered at once :
+    // the output buffer then holds a single block each time the next input block is captured
+    controls.read_audio_input(l_input_block);
+    while(!controls.read_audio_input(l_input_block))
+    {
+    }
+    #ifndef DEBUG_AUDIO
+    bool l_is_input_block_pending = true;
+    #endif
+    while(l_time_fs < AUDIO_INPUT_OUTPUT_BLOCKS * SIZE_AUDIO_BLOCK * NB_AUDIO_CHANNELS)
+    #else
     while(!g_output_audio_buffer.is_full())
+    #endif
     {
         g_output_audio_buffer.push(0);
         l_time_fs++;
     }
+    // Time counts frames, not samples
+    l_time_fs /= NB_AUDIO_CHANNELS;
     g_time_fs = l_time_fs;
 
     // Start the audio output
@@ -106,7 +142,7 @@ int main() {
     while(1)
     {
         // Check and process new inputs
-        if(controls.read_buttons(g_time_fs))
+        if(controls.read_buttons())
         {
             controls.process_buttons();
         }
@@ -114,45 +150,80 @@ int main() {
         // Create, release and update notes
         active_note_manager.update_active_notes(l_time_fs);
 
-        // Update low-pass filter
-        if(controls.have_filter_params_changed())
-        {
-            l_filter.set_target(
-                Biquad::get_low_pass(controls.get_filter_cutoff(), AUDIO_SAMPLING_FREQUENCY, controls.get_filter_Q()),
-                DYNAMIC_FILTER_TRANSITION_FS
-            );
-        }
-
-        // Compute next samples
+        // Compute next blocks of samples
         #ifndef DEBUG_AUDIO
-        while(!g_output_audio_buffer.is_full())
+        while(g_output_audio_buffer.get_size() - g_output_audio_buffer.get_count() >= SIZE_AUDIO_BLOCK * NB_AUDIO_CHANNELS
+            #ifdef AUDIO_INPUT
+            // A new block is rendered each time the DMA has captured one
+            && (l_is_input_block_pending || controls.read_audio_input(l_input_block))
+            #endif
+        )
         #endif
         {
-            // Compute audio sample
-            fxpt_Q0_31 l_audio_sample = active_note_manager.get_audio(l_time_fs);
-            // Filter audio sample
-            l_audio_sample = l_filter.process(l_audio_sample);
+            #if defined(AUDIO_INPUT) && !defined(DEBUG_AUDIO)
+            l_is_input_block_pending = false;
+            #endif
+
+            // Update parameters at control rate, once per block
+            controls.update_parameters();
+            active_note_manager.update_modulation(l_time_fs);
+
+            // Update low-pass filter, when either the controls or the modulation changed
+            const fxpt_UQ16_16 l_modulated_cutoff = controls.get_modulated_filter_cutoff(
+                active_note_manager.get_global_modulation(MODULATION_DESTINATION_FILTER_CUTOFF)
+            );
+            if(controls.have_filter_params_changed() || l_modulated_cutoff != l_filter_cutoff)
+            {
+                l_filter_cutoff = l_modulated_cutoff;
+                const Biquad l_filter_target = Biquad::get_low_pass(l_filter_cutoff, AUDIO_SAMPLING_FREQUENCY, controls.get_filter_Q());
+                for(unsigned int c = 0; c < NB_AUDIO_CHANNELS; ++c)
+                {
+                    get_master_low_pass(l_effects, c).set_target(l_filter_target, DYNAMIC_FILTER_TRANSITION_FS);
+                }
+            }
 
-            // Effects can be added on the audio sample here
+            // Compute audio samples
+            active_note_manager.get_audio_block(l_time_fs, l_audio_block);
 
-            #ifdef DEBUG_AUDIO
-            printf("%d\n", l_audio_sample);
+            #ifdef AUDIO_INPUT
+            // Mix the audio input in every channel, before the effects
+            for(unsigned int i = 0; i < SIZE_AUDIO_BLOCK; ++i)
+            {
+                constexpr fxpt64_t l_max = std::numeric_limits<fxpt_Q0_31>::max();
+                constexpr fxpt64_t l_min = std::numeric_limits<fxpt_Q0_31>::min();
+                const fxpt_Q0_31 l_input = fxpt_convert_n((fxpt64_t)l_input_block[i] * controls.get_input_level(), 62, 31);
+                for(unsigned int c = 0; c < NB_AUDIO_CHANNELS; ++c)
+                {
+                    const fxpt64_t l_sum = (fxpt64_t)l_audio_block[NB_AUDIO_CHANNELS * i + c] + l_input;
+                    l_audio_block[NB_AUDIO_CHANNELS * i + c] = (l_sum > l_max) ? l_max : ((l_sum < l_min) ? l_min : l_sum);
+                }
+            }
             #endif
 
-            // Check that there are still samples ready
-            if(g_output_audio_buffer.is_empty())
+            // Filter and apply effects on the whole block
+            l_effects.process_block(l_audio_block, SIZE_AUDIO_BLOCK * NB_AUDIO_CHANNELS);
+
+            for(unsigned int i = 0; i < SIZE_AUDIO_BLOCK * NB_AUDIO_CHANNELS; ++i)
             {
-                #ifndef DEBUG_AUDIO
-                panic();
+                #ifdef DEBUG_AUDIO
+                printf("%d\n", l_audio_block[i]);
                 #endif
-            }
 
-            // Push audio sample in buffer, without verification since it is not full
-            // TODO : protect this push from interrupt (replace by pico/utils/queue)
-            g_output_audio_buffer.push_fast(l_audio_sample);
+                // Check that there are still samples ready
+                if(g_output_audio_buffer.is_empty())
+                {
+                    #ifndef DEBUG_AUDIO
+                    panic();
+                    #endif
+                }
+
+                // Push audio sample in buffer, without verification since there is room for a whole block
+                // TODO : protect this push from interrupt (replace by pico/utils/queue)
+                g_output_audio_buffer.push_fast(l_audio_block[i]);
+            }
 
             // Increment local time
-            l_time_fs++;
+            l_time_fs += SIZE_AUDIO_BLOCK;
         }
     }
 
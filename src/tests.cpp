@@ -27,6 +27,129 @@
 #include "NoteManager.h"
 #include "waveforms.h"
 #include "Biquad.h"
+#include "effects.h"
+#include "ButtonMatrixDebouncer.h"
+#include "Lfo.h"
+#include "NoiseGenerator.h"
+#include "MasterBus.h"
+#include "AudioInput.h"
+#include "audio_input_test_signal.h"
+#include "adpcm_test_vectors.h"
+#include "frequencies.h"
+#include "Fixed.hpp"
+#include "FmVoice.hpp"
+#include "PluckedString.h"
+#include "DelayArena.hpp"
+#include "SamplePlayer.h"
+#include "Unison.h"
+#include "NoteCache.h"
+#include "HalfBandDecimator.hpp"
+#include "Fir.hpp"
+#include "hardware/structs/xip_ctrl.h"
+
+#include <math.h>
+#include "ModulationMatrix.h"
+
+/**
+ * @brief Measure the duration of the processing of blocks of samples by an effect.
+ * 
+ * @tparam Effect Any class implementing process_block(fxpt_Q0_31*, unsigned int).
+ * @param effect The effect to measure.
+ * @return unsigned int The mean duration per sample in ns.
+ */
+template<class Effect>
+static unsigned int measure_process_block_ns(Effect& effect)
+{
+    fxpt_Q0_31 l_block[SIZE_AUDIO_BLOCK];
+    unsigned int l_duration_us = 0;
+    for(unsigned int i = 0; i < NB_TESTS / SIZE_AUDIO_BLOCK; ++i)
+    {
+        // Saw-like input, so that the effect does not process silence
+        for(unsigned int j = 0; j < SIZE_AUDIO_BLOCK; ++j)
+        {
+            l_block[j] = (i * SIZE_AUDIO_BLOCK + j) << 22;
+        }
+        const unsigned int t_us = time_us_32();
+        effect.process_block(l_block, SIZE_AUDIO_BLOCK);
+        l_duration_us += time_us_32() - t_us;
+    }
+    return l_duration_us * 1000 / (NB_TESTS / SIZE_AUDIO_BLOCK * SIZE_AUDIO_BLOCK);
+}
+
+/**
+ * @brief Measure the duration of the rendering of several sample players reading their own samples in flash,
+ * block by block as the notes are rendered, starting with an empty XIP cache.
+ * 
+ * @param samples The sample of each voice.
+ * @param nb_voices The number of voices, 4 at most.
+ * @param interpolation The interpolation between the frames.
+ * @param hit_permille The hit rate of the XIP cache during the measure, code fetches included, in per mille.
+ * @return unsigned int The mean duration per voice and per sample in ns.
+ */
+static unsigned int measure_sample_players_ns(const Sample* samples, unsigned int nb_voices, SampleInterpolation interpolation, unsigned int& hit_permille)
+{
+    SamplePlayer l_players[4];
+    fxpt_Q0_31 l_block[SIZE_AUDIO_BLOCK];
+    for(unsigned int v = 0; v < nb_voices; ++v)
+    {
+        l_players[v].start(samples[v]);
+        // A fifth above the root, so that the frames are not read one by one
+        l_players[v].tune(midi_pitch_to_phase_increment(fxpt_convert_n((fxpt_Q15_16)67, 0, 16)));
+    }
+
+    // Empty the cache, the flush is done once it is read back, then reset the counters
+    xip_ctrl_hw->flush = 1;
+    (void)xip_ctrl_hw->flush;
+    xip_ctrl_hw->ctr_hit = 0;
+    xip_ctrl_hw->ctr_acc = 0;
+
+    const unsigned int t_us = time_us_32();
+    for(unsigned int i = 0; i < NB_TESTS / SIZE_AUDIO_BLOCK; ++i)
+    {
+        for(unsigned int v = 0; v < nb_voices; ++v)
+        {
+            l_players[v].render_block(l_block, SIZE_AUDIO_BLOCK, interpolation);
+        }
+    }
+    const unsigned int l_duration_us = time_us_32() - t_us;
+
+    const uint32_t l_hits = xip_ctrl_hw->ctr_hit;
+    const uint32_t l_accesses = xip_ctrl_hw->ctr_acc;
+    hit_permille = (l_accesses == 0) ? 1000 : (uint32_t)((uint64_t)l_hits * 1000 / l_accesses);
+    return (uint64_t)l_duration_us * 1000 / (nb_voices * (NB_TESTS / SIZE_AUDIO_BLOCK * SIZE_AUDIO_BLOCK));
+}
+
+/**
+ * @brief Biquad::process written with the Fixed template instead of the fxpt.h macros,
+ * to compare the code generated both ways. Both must give exactly the same samples.
+ */
+class FixedBiquad : public Biquad
+{
+public:
+
+    FixedBiquad(const Biquad& biquad)
+    {
+        copy_coefficients(biquad);
+    }
+
+    fxpt_Q0_31 process(fxpt_Q0_31 x_raw = 0)
+    {
+        const FixedQ0_31 x = FixedQ0_31::from_raw(x_raw);
+        const FixedQ1_30 b0 = FixedQ1_30::from_raw(get_b0());
+        const FixedQ1_30 b1 = FixedQ1_30::from_raw(get_b1());
+        const FixedQ1_30 b2 = FixedQ1_30::from_raw(get_b2());
+        const FixedQ1_30 a1 = FixedQ1_30::from_raw(get_a1());
+        const FixedQ1_30 a2 = FixedQ1_30::from_raw(get_a2());
+
+        // The products of the Q1.30 coefficients by the Q0.31 samples are Q2.61 on 64 bits, the shifts are deduced from the formats
+        // The output is summed on 64 bits and saturated, as in Biquad::process
+        const FixedQ0_31 y = fixed_cast<FixedQ0_31, FIXED_TRUNCATE, FIXED_SATURATE>(
+            fixed_cast<Fixed<32, 31>>(b0 * x) + fixed_cast<Fixed<32, 31>>(FixedQ3_28::from_raw(get_z1())));
+        set_z1((fixed_cast<FixedQ3_28>(b1 * x) - fixed_cast<FixedQ3_28>(a1 * y) + fixed_cast<FixedQ3_28>(FixedQ1_30::from_raw(get_z2()))).raw());
+        set_z2((fixed_cast<FixedQ1_30>(b2 * x) - fixed_cast<FixedQ1_30>(a2 * y)).raw());
+        return y.raw();
+    }
+};
 
 void perform_tests()
 {
@@ -46,10 +169,14 @@ void perform_tests()
     {
         printf("\n\n==================== Synthpathy tests ====================\n\n");
 
+        // The configurations are benchmarked side by side from the output of each build
+        printf("Engine configuration : %u Hz, %u samples per block, %u voices\n\n",
+            AUDIO_SAMPLING_FREQUENCY, SIZE_AUDIO_BLOCK, ENGINE_CONFIG.nb_active_notes);
+
         t_us = time_us_32();
         for(unsigned int i = 0; i < NB_TESTS; ++i)
         {
-            controls.read_buttons(10*i);
+            controls.read_buttons();
         }
         t_us = time_us_32() - t_us;
         duration_ns = t_us * 1000 / NB_TESTS;
@@ -57,6 +184,21 @@ void perform_tests()
 
         /*----------------------------------------------------------------------------------------*/
 
+        // Same bouncing press and release as seen by the PIO program, one raw state per scan
+        constexpr uint32_t l_raw_scans[] = {0, 1, 0, 1, 1, 1, 0, 1, 1, 0, 0, 0};
+        // Expected published states, 0xFF meaning nothing is published
+        constexpr uint32_t l_expected_states[] = {0xFF, 0xFF, 0xFF, 0xFF, 1, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0, 0xFF};
+        ButtonMatrixDebouncer l_debouncer;
+        bool l_debouncer_ok = true;
+        for(unsigned int i = 0; i < sizeof(l_raw_scans)/sizeof(uint32_t); ++i)
+        {
+            const bool l_published = l_debouncer.scan(l_raw_scans[i]);
+            l_debouncer_ok &= l_published ? (l_debouncer.get_state() == l_expected_states[i]) : (l_expected_states[i] == 0xFF);
+        }
+        printf("ButtonMatrixDebouncer.scan(...) [bouncing press and release] : %s\n", l_debouncer_ok ? "OK" : "FAILED");
+
+        /*----------------------------------------------------------------------------------------*/
+
         t_us = time_us_32();
         for(unsigned int i = 0; i < NB_TESTS; ++i)
         {
@@ -68,6 +210,17 @@ void perform_tests()
 
         /*----------------------------------------------------------------------------------------*/
 
+        t_us = time_us_32();
+        for(unsigned int i = 0; i < NB_TESTS; ++i)
+        {
+            controls.update_parameters();
+        }
+        t_us = time_us_32() - t_us;
+        duration_ns = t_us * 1000 / NB_TESTS;
+        printf("controls.update_parameters() : %u ns\n", duration_ns);
+
+        /*----------------------------------------------------------------------------------------*/
+
         t_us = time_us_32();
         for(unsigned int i = 0; i < NB_TESTS; ++i)
         {
@@ -98,6 +251,283 @@ void perform_tests()
 
         /*----------------------------------------------------------------------------------------*/
 
+        Lfo l_lfo(LFO_SINE, fxpt_convert_n(4, 0, 16));
+        t_us = time_us_32();
+        for(unsigned int i = 0; i < NB_TESTS; ++i)
+        {
+            l_lfo.update();
+        }
+        t_us = time_us_32() - t_us;
+        duration_ns = t_us * 1000 / NB_TESTS;
+        printf("lfo.update() [sine] : %u ns\n", duration_ns);
+
+        /*----------------------------------------------------------------------------------------*/
+
+        {
+            const NoiseColor l_colors[] = {NOISE_WHITE, NOISE_PINK, NOISE_BROWN};
+            const char* l_color_names[] = {"white", "pink", "brown"};
+            fxpt_Q0_31 l_noise_block[SIZE_AUDIO_BLOCK];
+            for(unsigned int c = 0; c < 3; ++c)
+            {
+                NoiseGenerator l_noise(l_colors[c]);
+                t_us = time_us_32();
+                for(unsigned int i = 0; i < NB_TESTS / SIZE_AUDIO_BLOCK; ++i)
+                {
+                    l_noise.fill_block(l_noise_block, SIZE_AUDIO_BLOCK);
+                }
+                t_us = time_us_32() - t_us;
+                duration_ns = t_us * 1000 / (NB_TESTS / SIZE_AUDIO_BLOCK * SIZE_AUDIO_BLOCK);
+                printf("NoiseGenerator.fill_block(...) [per sample, %s] : %u ns\n", l_color_names[c], duration_ns);
+            }
+        }
+
+        /*----------------------------------------------------------------------------------------*/
+
+        {
+            FmPatch l_fm_patch;
+            fxpt_Q0_31 l_fm_block[SIZE_AUDIO_BLOCK];
+            const FmAlgorithm l_algorithms[] = {FM_ALGORITHM_STACK, FM_ALGORITHM_ADDITIVE};
+            const char* l_algorithm_names[] = {"stack", "additive"};
+            for(unsigned int a = 0; a < 2; ++a)
+            {
+                l_fm_patch.algorithm = l_algorithms[a];
+
+                FmVoice<2> l_fm_voice_2;
+                l_fm_voice_2.set_phase_increment(midi_pitch_to_phase_increment(fxpt_convert_n((fxpt_Q15_16)60, 0, 16)), l_fm_patch);
+                t_us = time_us_32();
+                for(unsigned int i = 0; i < NB_TESTS / SIZE_AUDIO_BLOCK; ++i)
+                {
+                    l_fm_voice_2.render_block(l_fm_patch, i * SIZE_AUDIO_BLOCK, l_fm_block, SIZE_AUDIO_BLOCK);
+                }
+                t_us = time_us_32() - t_us;
+                duration_ns = t_us * 1000 / (NB_TESTS / SIZE_AUDIO_BLOCK * SIZE_AUDIO_BLOCK * 2);
+                printf("FmVoice<2>.render_block(...) [per operator per sample, %s] : %u ns\n", l_algorithm_names[a], duration_ns);
+
+                FmVoice<4> l_fm_voice_4;
+                l_fm_voice_4.set_phase_increment(midi_pitch_to_phase_increment(fxpt_convert_n((fxpt_Q15_16)60, 0, 16)), l_fm_patch);
+                t_us = time_us_32();
+                for(unsigned int i = 0; i < NB_TESTS / SIZE_AUDIO_BLOCK; ++i)
+                {
+                    l_fm_voice_4.render_block(l_fm_patch, i * SIZE_AUDIO_BLOCK, l_fm_block, SIZE_AUDIO_BLOCK);
+                }
+                t_us = time_us_32() - t_us;
+                duration_ns = t_us * 1000 / (NB_TESTS / SIZE_AUDIO_BLOCK * SIZE_AUDIO_BLOCK * 4);
+                printf("FmVoice<4>.render_block(...) [per operator per sample, %s] : %u ns\n", l_algorithm_names[a], duration_ns);
+            }
+        }
+
+        /*----------------------------------------------------------------------------------------*/
+
+        {
+            static DelayArena<4, PLUCK_DELAY_LINE_SIZE> l_arena;
+            // All slots can be lent, then the arena is exhausted, and a given back slot is lent again
+            int l_slots[4];
+            bool l_arena_ok = true;
+            for(unsigned int i = 0; i < 4; ++i)
+            {
+                l_slots[i] = l_arena.allocate();
+                l_arena_ok = l_arena_ok && (l_slots[i] != DELAY_ARENA_NO_SLOT);
+            }
+            l_arena_ok = l_arena_ok && (l_arena.allocate() == DELAY_ARENA_NO_SLOT);
+            l_arena.release(l_slots[2]);
+            l_arena_ok = l_arena_ok && (l_arena.allocate() == l_slots[2]) && (l_arena.get_nb_free() == 0);
+            printf("DelayArena.allocate() [exhaust and give back] : %s\n", l_arena_ok ? "OK" : "FAILED");
+
+            PluckedString l_string;
+            NoiseGenerator l_burst;
+            fxpt_Q0_31 l_pluck_block[SIZE_AUDIO_BLOCK];
+            t_us = time_us_32();
+            l_string.pluck(l_arena.get_line(l_slots[0]), l_burst);
+            t_us = time_us_32() - t_us;
+            printf("PluckedString.pluck(...) [%u samples] : %u us\n", PLUCK_DELAY_LINE_SIZE, t_us);
+
+            l_string.tune(midi_pitch_to_phase_increment(fxpt_convert_n((fxpt_Q15_16)60, 0, 16)));
+            t_us = time_us_32();
+            for(unsigned int i = 0; i < NB_TESTS / SIZE_AUDIO_BLOCK; ++i)
+            {
+                l_string.render_block(l_pluck_block, SIZE_AUDIO_BLOCK, 32604);
+            }
+            t_us = time_us_32() - t_us;
+            duration_ns = t_us * 1000 / (NB_TESTS / SIZE_AUDIO_BLOCK * SIZE_AUDIO_BLOCK);
+            printf("PluckedString.render_block(...) [per sample] : %u ns\n", duration_ns);
+        }
+
+        /*----------------------------------------------------------------------------------------*/
+
+        {
+            // Each voice reads its own 128kB of flash, 256kB apart, the content being irrelevant to the timing
+            Sample l_samples[4];
+            for(unsigned int v = 0; v < 4; ++v)
+            {
+                l_samples[v].data = reinterpret_cast<const void*>(XIP_BASE + (v + 1) * 256 * 1024);
+                l_samples[v].length = 64 * 1024;
+                l_samples[v].loop_start = 0;
+                l_samples[v].loop_end = 64 * 1024;
+                l_samples[v].format = SAMPLE_FORMAT_PCM16;
+                l_samples[v].unity_increment = midi_pitch_to_phase_increment(fxpt_convert_n((fxpt_Q15_16)60, 0, 16));
+            }
+            const char* l_interpolation_names[2] = {"linear", "cubic"};
+            const SampleInterpolation l_interpolations[2] = {SAMPLE_INTERPOLATION_LINEAR, SAMPLE_INTERPOLATION_CUBIC};
+            unsigned int l_hit_permille;
+            for(unsigned int k = 0; k < 2; ++k)
+            {
+                for(unsigned int l_nb_voices = 1; l_nb_voices <= 4; l_nb_voices *= 2)
+                {
+                    duration_ns = measure_sample_players_ns(l_samples, l_nb_voices, l_interpolations[k], l_hit_permille);
+                    printf("SamplePlayer.render_block(...) [%s, %u voices] : %u ns, %u cycles per voice per sample, XIP cache hits %u/1000\n",
+                        l_interpolation_names[k], l_nb_voices, duration_ns, duration_ns * SYSTEM_CLOCK_FREQUENCY_KHZ / 1000000, l_hit_permille);
+                }
+            }
+
+            // The same reads through the uncached alias of the flash, each of them going to the QSPI bus
+            for(unsigned int v = 0; v < 4; ++v)
+            {
+                l_samples[v].data = reinterpret_cast<const void*>(XIP_NOCACHE_NOALLOC_BASE + (v + 1) * 256 * 1024);
+            }
+            duration_ns = measure_sample_players_ns(l_samples, 4, SAMPLE_INTERPOLATION_LINEAR, l_hit_permille);
+            printf("SamplePlayer.render_block(...) [linear, 4 voices, uncached] : %u ns, %u cycles per voice per sample\n",
+                duration_ns, duration_ns * SYSTEM_CLOCK_FREQUENCY_KHZ / 1000000);
+
+            // 8 bits frames, twice as many per cache line
+            for(unsigned int v = 0; v < 4; ++v)
+            {
+                l_samples[v].data = reinterpret_cast<const void*>(XIP_BASE + (v + 1) * 256 * 1024);
+                l_samples[v].format = SAMPLE_FORMAT_PCM8;
+            }
+            duration_ns = measure_sample_players_ns(l_samples, 4, SAMPLE_INTERPOLATION_LINEAR, l_hit_permille);
+            printf("SamplePlayer.render_block(...) [linear, 8 bits, 4 voices] : %u ns, %u cycles per voice per sample, XIP cache hits %u/1000\n",
+                duration_ns, duration_ns * SYSTEM_CLOCK_FREQUENCY_KHZ / 1000000, l_hit_permille);
+
+            // 4 bits ADPCM frames, decoded a block ahead, the flash content being decoded as is
+            for(unsigned int v = 0; v < 4; ++v)
+            {
+                l_samples[v].format = SAMPLE_FORMAT_ADPCM;
+            }
+            duration_ns = measure_sample_players_ns(l_samples, 4, SAMPLE_INTERPOLATION_LINEAR, l_hit_permille);
+            printf("SamplePlayer.render_block(...) [linear, ADPCM, 4 voices] : %u ns, %u cycles per voice per sample, XIP cache hits %u/1000\n",
+                duration_ns, duration_ns * SYSTEM_CLOCK_FREQUENCY_KHZ / 1000000, l_hit_permille);
+
+            // The decoding alone, its cost only depends on the number of frames
+            AdpcmStream l_stream;
+            l_stream.start(l_samples[0]);
+            t_us = time_us_32();
+            for(unsigned int i = 1; i <= NB_TESTS / SIZE_AUDIO_BLOCK; ++i)
+            {
+                l_stream.decode_until(i * SIZE_AUDIO_BLOCK);
+            }
+            t_us = time_us_32() - t_us;
+            duration_ns = t_us * 1000 / (NB_TESTS / SIZE_AUDIO_BLOCK * SIZE_AUDIO_BLOCK);
+            printf("AdpcmStream.decode_until(...) [per frame] : %u ns, %u cycles\n", duration_ns, duration_ns * SYSTEM_CLOCK_FREQUENCY_KHZ / 1000000);
+        }
+
+        {
+            // The frames decoded by python_scripts/sample_bank.py, through the states of the blocks and twice through the loop
+            Sample l_sample;
+            l_sample.data = ADPCM_TEST_BLOCKS;
+            l_sample.length = ADPCM_TEST_LENGTH;
+            l_sample.loop_start = ADPCM_TEST_LOOP_START;
+            l_sample.loop_end = ADPCM_TEST_LENGTH;
+            l_sample.format = SAMPLE_FORMAT_ADPCM;
+            l_sample.unity_increment = 0;
+            static AdpcmStream l_stream;
+            l_stream.start(l_sample);
+            bool l_is_exact = true;
+            for(unsigned int i = 0; i < 3 * ADPCM_TEST_LENGTH; i += SIZE_AUDIO_BLOCK)
+            {
+                l_stream.decode_until(i + SIZE_AUDIO_BLOCK);
+                for(unsigned int j = i; j < i + SIZE_AUDIO_BLOCK; ++j)
+                {
+                    const unsigned int l_frame = (j < ADPCM_TEST_LENGTH) ? j
+                        : ADPCM_TEST_LOOP_START + (j - ADPCM_TEST_LENGTH) % (ADPCM_TEST_LENGTH - ADPCM_TEST_LOOP_START);
+                    l_is_exact = l_is_exact && (l_stream.get_ring()[j & AdpcmStream::RING_MSK] == ADPCM_TEST_FRAMES[l_frame]);
+                }
+            }
+            printf("AdpcmStream.decode_until(...) [bit exact with python_scripts/sample_bank.py] : %s\n", l_is_exact ? "OK" : "FAILED");
+        }
+
+        /*----------------------------------------------------------------------------------------*/
+
+        {
+            // Rounds of the 4 ADC channels, as written by the DMA
+            uint16_t l_raw[NB_ADC_CHANNELS * SIZE_AUDIO_BLOCK];
+            for(unsigned int i = 0; i < NB_ADC_CHANNELS * SIZE_AUDIO_BLOCK; ++i)
+            {
+                l_raw[i] = (i * 977) & 0xFFF;
+            }
+            fxpt_Q0_31 l_input_block[SIZE_AUDIO_BLOCK];
+            AudioInput l_audio_input;
+            t_us = time_us_32();
+            for(unsigned int i = 0; i < NB_TESTS / SIZE_AUDIO_BLOCK; ++i)
+            {
+                l_audio_input.process_block(&l_raw[ADC_AUDIO_INPUT_IDX], NB_ADC_CHANNELS, l_input_block, SIZE_AUDIO_BLOCK);
+            }
+            t_us = time_us_32() - t_us;
+            duration_ns = t_us * 1000 / (NB_TESTS / SIZE_AUDIO_BLOCK * SIZE_AUDIO_BLOCK);
+            printf("AudioInput.process_block(...) [per sample] : %u ns\n", duration_ns);
+        }
+
+        {
+            // The test signal through the input path, interleaved as written by the DMA, against a floating point DC blocker
+            static uint16_t l_raw[NB_ADC_CHANNELS * SIZE_AUDIO_BLOCK];
+            fxpt_Q0_31 l_input_block[SIZE_AUDIO_BLOCK];
+            AudioInput l_audio_input;
+            float l_x1 = 0.f, l_y1 = 0.f, l_signal = 0.f, l_error = 0.f;
+            for(unsigned int b = 0; b < AUDIO_INPUT_TEST_SIGNAL_LENGTH; b += SIZE_AUDIO_BLOCK)
+            {
+                for(unsigned int i = 0; i < NB_ADC_CHANNELS * SIZE_AUDIO_BLOCK; ++i)
+                {
+                    // The potentiometers are at the top of their range, so that they cannot hide in the input
+                    l_raw[i] = ((i % NB_ADC_CHANNELS) == ADC_AUDIO_INPUT_IDX) ? AUDIO_INPUT_TEST_SIGNAL[b + i / NB_ADC_CHANNELS] : 0xFFF;
+                }
+                l_audio_input.process_block(&l_raw[ADC_AUDIO_INPUT_IDX], NB_ADC_CHANNELS, l_input_block, SIZE_AUDIO_BLOCK);
+                for(unsigned int i = 0; i < SIZE_AUDIO_BLOCK; ++i)
+                {
+                    // y = x - x1 + (1 - 2^-10) * y1, the pole of AudioInput
+                    const float l_x = (AUDIO_INPUT_TEST_SIGNAL[b + i] - (1<<(AudioInput::ADC_BIT_DEPTH-1))) / (float)(1<<(AudioInput::ADC_BIT_DEPTH-1));
+                    const float l_y = l_x - l_x1 + (1.f - 1.f / 1024.f) * l_y1;
+                    l_x1 = l_x;
+                    l_y1 = l_y;
+                    const float l_difference = fxpt_to_float(l_input_block[i], 31) - l_y;
+                    l_signal += l_y * l_y;
+                    l_error += l_difference * l_difference;
+                }
+            }
+            printf("AudioInput.process_block(...) [test signal, against a floating point DC blocker] : %.1f dB : %s\n",
+                10.f * log10f(l_signal / l_error), (l_error <= 1e-8f * l_signal) ? "OK" : "FAILED");
+        }
+
+        /*----------------------------------------------------------------------------------------*/
+
+        {
+            // The default matrix is empty, two typical routes are measured instead
+            ModulationMatrix l_modulation_matrix;
+            l_modulation_matrix.add_route(MODULATION_SOURCE_LFO1, MODULATION_DESTINATION_TEXTURE, fxpt_from_float(0.125f, 30));
+            l_modulation_matrix.add_route(MODULATION_SOURCE_AFTERTOUCH, MODULATION_DESTINATION_FILTER_CUTOFF, fxpt_from_float(0.5f, 30));
+            const fxpt_Q0_31 l_modulation_sources[NB_MODULATION_SOURCES] = {1<<30, -(1<<29), 1<<28, 1<<27, 1<<26};
+            fxpt_Q0_31 l_modulation_destinations[NB_MODULATION_DESTINATIONS];
+            t_us = time_us_32();
+            for(unsigned int i = 0; i < NB_TESTS; ++i)
+            {
+                l_modulation_matrix.evaluate(l_modulation_sources, l_modulation_destinations);
+            }
+            t_us = time_us_32() - t_us;
+            duration_ns = t_us * 1000 / NB_TESTS;
+            printf("modulation_matrix.evaluate(...) [%u routes] : %u ns\n", l_modulation_matrix.get_nb_routes(), duration_ns);
+        }
+
+        /*----------------------------------------------------------------------------------------*/
+
+        t_us = time_us_32();
+        for(unsigned int i = 0; i < NB_TESTS; ++i)
+        {
+            note_manager.update_modulation(42);
+        }
+        t_us = time_us_32() - t_us;
+        duration_ns = t_us * 1000 / NB_TESTS;
+        printf("note_manager.update_modulation(...) : %u ns\n", duration_ns);
+
+        /*----------------------------------------------------------------------------------------*/
+
         t_us = time_us_32();
         ActiveNote active_note(0, fxpt_Q0_31(1<<30), 0, 500, 500);
         for(unsigned int i = 0; i < NB_TESTS; ++i)
@@ -118,6 +548,254 @@ void perform_tests()
         t_us = time_us_32() - t_us;
         duration_ns = t_us * 1000 / NB_TESTS;
         printf("active_note.get_audio_value(...) [saw wave, alive] : %u ns\n", duration_ns);
+        // The reference of the unison oscillators below
+        const unsigned int l_saw_voice_ns = duration_ns;
+        // The number of notes one core could render in a sampling period, without effects nor controls
+        #ifdef AUDIO_Q15
+        printf("Voices per core [saw wave, Q15 path] : %u\n", 1000000000U / AUDIO_SAMPLING_FREQUENCY / duration_ns);
+        #else
+        printf("Voices per core [saw wave, Q31 path] : %u\n", 1000000000U / AUDIO_SAMPLING_FREQUENCY / duration_ns);
+        #endif
+
+        /*----------------------------------------------------------------------------------------*/
+
+        {
+            // Signal to noise ratio of a note through attack, decay and sustain, against a floating-point model.
+            // The result differs between the Q15 and Q31 paths only, see AUDIO_Q15.
+            constexpr unsigned int l_attack = 1000, l_decay = 4000;
+            constexpr float l_velocity = 0.75f, l_sustain = 0.5f;
+            ActiveNote l_note(60, fxpt_Q0_31(3<<29), 0, l_attack, l_decay);
+            const fxpt_UQ0_32 l_phase_increment = midi_pitch_to_phase_increment(fxpt_convert_n((fxpt_Q15_16)60, 0, 16));
+            float l_signal = 0.f, l_noise = 0.f;
+            for(unsigned int i = 0; i < NB_TESTS; ++i)
+            {
+                const float l_value = fxpt_to_float(l_note.get_audio_value(i, &saw_wave, 0, fxpt_Q0_31(1<<30)), 31);
+                const float l_envelope = (i < l_attack) ? (float)i / l_attack :
+                    ((i < l_attack + l_decay) ? 1.f + (l_sustain - 1.f) * (i - l_attack) / l_decay : l_sustain);
+                const float l_expected = fxpt_to_float(saw_wave(i * l_phase_increment, 0), 31) * l_envelope * l_velocity;
+                l_signal += l_expected * l_expected;
+                l_noise += (l_value - l_expected) * (l_value - l_expected);
+            }
+            printf("active_note.get_audio_value(...) SNR [saw wave, envelope] : %.1f dB\n", 10.f * log10f(l_signal / l_noise));
+        }
+
+        /*----------------------------------------------------------------------------------------*/
+
+        {
+            const fxpt_UQ0_32 l_phase_increment = midi_pitch_to_phase_increment(fxpt_convert_n((fxpt_Q15_16)69, 0, 16));
+            // Volatile so that the loop is not optimized away
+            volatile fxpt_Q0_31 l_sine;
+            t_us = time_us_32();
+            for(unsigned int i = 0; i < NB_TESTS; ++i)
+            {
+                l_sine = sine_wave(i * l_phase_increment);
+            }
+            t_us = time_us_32() - t_us;
+            (void)l_sine;
+            duration_ns = t_us * 1000 / NB_TESTS;
+            printf("sine_wave(...) : %u ns, %u cycles per sample\n", duration_ns, duration_ns * SYSTEM_CLOCK_FREQUENCY_KHZ / 1000000);
+
+            // Total harmonic distortion and noise against a double precision sine, compared with the former 10 bits phase
+            double l_signal = 0., l_error_interp = 0., l_error_lut = 0.;
+            for(unsigned int i = 0; i < NB_TESTS; ++i)
+            {
+                const fxpt_UQ0_32 l_phase = i * l_phase_increment;
+                const double l_expected = sin(2. * M_PI * l_phase / 4294967296.);
+                const double l_value_interp = (double)sine_wave(l_phase) / 2147483648.;
+                const double l_value_lut = (double)fxpt_sin(l_phase >> 22) / 2147483648.;
+                l_signal += l_expected * l_expected;
+                l_error_interp += (l_value_interp - l_expected) * (l_value_interp - l_expected);
+                l_error_lut += (l_value_lut - l_expected) * (l_value_lut - l_expected);
+            }
+            printf("sine_wave(...) THD+N [440Hz] : %.1f dB, %.1f dB with fxpt_sin\n",
+                10. * log10(l_error_interp / l_signal), 10. * log10(l_error_lut / l_signal));
+        }
+
+        /*----------------------------------------------------------------------------------------*/
+
+        active_note.render_noise(NOISE_WHITE);
+        t_us = time_us_32();
+        for(unsigned int i = 0; i < NB_TESTS; ++i)
+        {
+            active_note.get_audio_value(i%1000, &saw_wave, fxpt_Q0_31(0), fxpt_Q0_31(1<<30), fxpt_Q0_31(1<<29));
+        }
+        t_us = time_us_32() - t_us;
+        duration_ns = t_us * 1000 / NB_TESTS;
+        printf("active_note.get_audio_value(...) [saw wave, alive, noise mixed] : %u ns\n", duration_ns);
+
+        /*----------------------------------------------------------------------------------------*/
+
+        {
+            // The whole cost of a note in unison mode, rendering included, spread over its oscillators
+            const unsigned int l_nb_oscillators[] = {2, 4, 8};
+            for(unsigned int n = 0; n < sizeof(l_nb_oscillators) / sizeof(l_nb_oscillators[0]); ++n)
+            {
+                const Unison l_unison(l_nb_oscillators[n]);
+                t_us = time_us_32();
+                for(unsigned int i = 0; i < NB_TESTS; i += SIZE_AUDIO_BLOCK)
+                {
+                    active_note.render_unison(l_unison, &saw_wave, fxpt_Q0_31(0), std::numeric_limits<fxpt_Q0_31>::max());
+                    for(unsigned int j = 0; j < SIZE_AUDIO_BLOCK; ++j)
+                    {
+                        active_note.get_audio_value((i + j)%1000, &saw_wave, fxpt_Q0_31(0), fxpt_Q0_31(1<<30));
+                    }
+                }
+                t_us = time_us_32() - t_us;
+                duration_ns = t_us * 1000 / NB_TESTS;
+                printf("active_note.get_audio_value(...) [saw wave, alive, unison of %u] : %u ns, %u ns per oscillator against %u ns per voice\n",
+                    l_nb_oscillators[n], duration_ns, duration_ns / l_nb_oscillators[n], l_saw_voice_ns);
+            }
+            // Back to a single oscillator for the following tests
+            active_note.render_unison(Unison(), &saw_wave, fxpt_Q0_31(0), std::numeric_limits<fxpt_Q0_31>::max());
+        }
+
+        /*----------------------------------------------------------------------------------------*/
+
+        {
+            static NoteCache l_cache;
+            printf("NoteCache memory : %u bytes, %u entries of %u frames\n", (unsigned int)sizeof(NoteCache), NOTE_CACHE_NB_ENTRIES, NoteCache::ENTRY_SIZE);
+
+            #ifndef AUDIO_OVERSAMPLING
+            // With the default controls, a first note records its attack and decay, then the same note played again streams them.
+            // The notes of the benchmarks above are long dead, and the smoothed parameters have settled while update_parameters was benchmarked.
+            constexpr unsigned int l_time_start_fs = 16 * AUDIO_SAMPLING_FREQUENCY;
+            unsigned int l_time_fs = l_time_start_fs;
+            unsigned int l_nb_cached_notes = 0;
+            for(unsigned int k = 0; k < 2; ++k)
+            {
+                g_midi_internal_buffer.push(midi_event_note_onoff(MIDI_NOTE_ON, 0, 60, 0x7F));
+                note_manager.update_active_notes(l_time_fs);
+                // The recording ends with the entry, the note being held until then
+                const unsigned int l_time_end_fs = l_time_fs + ((k == 0) ? NoteCache::ENTRY_SIZE + SIZE_AUDIO_BLOCK : SIZE_AUDIO_BLOCK);
+                for(; l_time_fs < l_time_end_fs; l_time_fs += SIZE_AUDIO_BLOCK)
+                {
+                    // As in the main loop, so that the LFOs run
+                    controls.update_parameters();
+                    note_manager.update_modulation(l_time_fs);
+                    for(unsigned int j = 0; j < SIZE_AUDIO_BLOCK; ++j)
+                    {
+                        note_manager.get_audio(l_time_fs + j);
+                    }
+                }
+                // The second note is checked while still held, the first one having left the cache once released
+                if(k == 1)
+                {
+                    l_nb_cached_notes = note_manager.get_nb_cached_notes();
+                }
+                g_midi_internal_buffer.push(midi_event_note_onoff(MIDI_NOTE_OFF, 0, 60, 0x7F));
+                note_manager.update_active_notes(l_time_fs);
+            }
+            // The released note leaves the cache
+            note_manager.update_modulation(l_time_fs);
+            printf("NoteManager note cache [default controls, second note streamed] : %s\n", (l_nb_cached_notes == 1) ? "OK" : "FAILED");
+            #endif
+
+            // Cost of the attack and decay of a note, synthesized while recorded by the first note, then streamed by the next one
+            constexpr unsigned int l_length = NoteCache::ENTRY_SIZE;
+            const unsigned int l_nb_oscillators[] = {1, 8};
+            unsigned int l_live_ns = 0, l_stream_ns = 0;
+            unsigned int l_nb_recorded_frames;
+            for(unsigned int n = 0; n < sizeof(l_nb_oscillators) / sizeof(l_nb_oscillators[0]); ++n)
+            {
+                const Unison l_unison(l_nb_oscillators[n]);
+                // Static, the notes being large for the stack
+                static ActiveNote l_notes[2];
+                l_notes[0] = ActiveNote(60, fxpt_Q0_31(1<<30), 0, l_length / 2, l_length / 2);
+                l_notes[1] = ActiveNote(60, fxpt_Q0_31(3<<29), 0, l_length / 2, l_length / 2);
+                int l_entry = l_cache.record(60 + n, 0);
+                l_notes[0].record_cache(l_cache.get_frames(l_entry), l_length, l_entry);
+                unsigned int l_durations_ns[2];
+                for(unsigned int k = 0; k < 2; ++k)
+                {
+                    if(k == 1)
+                    {
+                        l_entry = l_cache.find(60 + n, 0);
+                        l_notes[1].stream_cache(l_cache.get_frames(l_entry), l_cache.get_length(l_entry), l_entry);
+                    }
+                    t_us = time_us_32();
+                    for(unsigned int i = 0; i < l_length; i += SIZE_AUDIO_BLOCK)
+                    {
+                        l_notes[k].render_unison(l_unison, &saw_wave, fxpt_Q0_31(0), std::numeric_limits<fxpt_Q0_31>::max());
+                        for(unsigned int j = 0; j < SIZE_AUDIO_BLOCK; ++j)
+                        {
+                            l_notes[k].get_audio_value(i + j, &saw_wave, fxpt_Q0_31(0), fxpt_Q0_31(1<<30));
+                        }
+                    }
+                    t_us = time_us_32() - t_us;
+                    l_durations_ns[k] = t_us * 1000 / l_length;
+                    l_entry = l_notes[k].detach_cache(l_length, l_nb_recorded_frames);
+                    l_cache.release(l_entry, l_nb_recorded_frames);
+                }
+                printf("active_note.get_audio_value(...) [saw wave, unison of %u, attack and decay] : %u ns synthesized, %u ns streamed from NoteCache\n",
+                    l_nb_oscillators[n], l_durations_ns[0], l_durations_ns[1]);
+                if(n == 0)
+                {
+                    l_live_ns = l_durations_ns[0];
+                    l_stream_ns = l_durations_ns[1];
+                }
+            }
+
+            // Any change of the patch makes the entries stale
+            l_cache.set_patch_version(1);
+            printf("NoteCache.find() [stale after a patch change] : %s\n", (l_cache.find(60, 0) == NOTE_CACHE_NO_ENTRY) ? "OK" : "FAILED");
+
+            // Hit rate of a few play patterns, each note lasting longer than its entry, and the part of the attacks
+            // and decays of a single oscillator spared
+            constexpr unsigned int l_nb_note_ons = 256;
+            const char* l_pattern_names[] = {"arpeggio of 4 notes", "scale of 8 notes up and down", "random notes over 2 octaves"};
+            const MidiByte l_arpeggio[] = {60, 64, 67, 72};
+            const MidiByte l_scale[] = {60, 62, 64, 65, 67, 69, 71, 72, 71, 69, 67, 65, 64, 62};
+            uint32_t l_seed = 1;
+            for(unsigned int p = 0; p < 3; ++p)
+            {
+                l_cache.set_patch_version(2 + p);
+                unsigned int l_nb_hits = 0;
+                for(unsigned int i = 0; i < l_nb_note_ons; ++i)
+                {
+                    MidiByte l_midi_note;
+                    if(p == 0)
+                    {
+                        l_midi_note = l_arpeggio[i % (sizeof(l_arpeggio) / sizeof(l_arpeggio[0]))];
+                    }
+                    else if(p == 1)
+                    {
+                        l_midi_note = l_scale[i % (sizeof(l_scale) / sizeof(l_scale[0]))];
+                    }
+                    else
+                    {
+                        l_seed = l_seed * 1664525U + 1013904223U;
+                        l_midi_note = 48 + (l_seed >> 24) % 24;
+                    }
+                    const unsigned int l_time_fs = i * l_length;
+                    int l_entry = l_cache.find(l_midi_note, l_time_fs);
+                    if(l_entry != NOTE_CACHE_NO_ENTRY)
+                    {
+                        l_nb_hits++;
+                        l_cache.release(l_entry, 0);
+                    }
+                    else
+                    {
+                        l_entry = l_cache.record(l_midi_note, l_time_fs);
+                        l_cache.release(l_entry, l_length);
+                    }
+                }
+                const unsigned int l_hit_percent = l_nb_hits * 100 / l_nb_note_ons;
+                printf("NoteCache [%s] : %u%% hits, %u%% of the attacks and decays spared\n", l_pattern_names[p], l_hit_percent,
+                    (l_live_ns > l_stream_ns) ? l_hit_percent * (l_live_ns - l_stream_ns) / l_live_ns : 0);
+            }
+        }
+
+        /*----------------------------------------------------------------------------------------*/
+
+        active_note.glide_from(fxpt_convert_n(12, 0, 16), NB_TESTS);
+        t_us = time_us_32();
+        for(unsigned int i = 0; i < NB_TESTS; ++i)
+        {
+            active_note.update_pitch(fxpt_convert_n(i%3, 0, 16) - (1<<15));
+        }
+        t_us = time_us_32() - t_us;
+        duration_ns = t_us * 1000 / NB_TESTS;
+        printf("active_note.update_pitch(...) [gliding, bent] : %u ns\n", duration_ns);
 
         /*----------------------------------------------------------------------------------------*/
 
@@ -133,7 +811,7 @@ void perform_tests()
 
         /*----------------------------------------------------------------------------------------*/
 
-        constexpr unsigned int NB_ACTIVE_NOTES = 4;
+        constexpr unsigned int NB_ACTIVE_NOTES = ENGINE_CONFIG.nb_active_notes;
         // Load Notes
         for(unsigned int i = 0; i < NB_ACTIVE_NOTES; i++)
         {
@@ -169,6 +847,32 @@ void perform_tests()
         duration_ns = t_us * 1000 / NB_TESTS;
         printf("note_manager.get_audio(...) [Full pool, saw] : %u ns\n", duration_ns);
 
+        {
+            // The difference with the mono mix is the cost of the panning of the full pool
+            fxpt_Q0_31 l_frame[2];
+            t_us = time_us_32();
+            for(unsigned int i = 0; i < NB_TESTS; ++i)
+            {
+                note_manager.get_audio_stereo(i%attack_decay, l_frame);
+            }
+            t_us = time_us_32() - t_us;
+            duration_ns = t_us * 1000 / NB_TESTS;
+            printf("note_manager.get_audio_stereo(...) [Full pool, saw] : %u ns\n", duration_ns);
+        }
+
+        {
+            // The whole rendering path of the main loop, oversampled when compiled with AUDIO_OVERSAMPLING
+            fxpt_Q0_31 l_block[SIZE_AUDIO_BLOCK * NB_AUDIO_CHANNELS];
+            t_us = time_us_32();
+            for(unsigned int i = 0; i < NB_TESTS / SIZE_AUDIO_BLOCK; ++i)
+            {
+                note_manager.get_audio_block((i * SIZE_AUDIO_BLOCK) % attack_decay, l_block);
+            }
+            t_us = time_us_32() - t_us;
+            duration_ns = t_us * 1000 / (NB_TESTS / SIZE_AUDIO_BLOCK * SIZE_AUDIO_BLOCK);
+            printf("note_manager.get_audio_block(...) [Full pool, saw, oversampled x%u, per frame] : %u ns\n", OVERSAMPLING_FACTOR, duration_ns);
+        }
+
         // Release notes
         for(unsigned int i = 0; i < NB_ACTIVE_NOTES; i++)
         {
@@ -178,6 +882,120 @@ void perform_tests()
 
         /*----------------------------------------------------------------------------------------*/
 
+        MasterBus l_master_bus;
+        // Sum of two saw waves, so that the gain is reduced on every sample
+        t_us = time_us_32();
+        for(unsigned int i = 0; i < NB_TESTS; ++i)
+        {
+            l_master_bus.process((fxpt64_t)saw_wave(i<<22, 0) + (fxpt64_t)saw_wave(i<<23, 0));
+        }
+        t_us = time_us_32() - t_us;
+        duration_ns = t_us * 1000 / NB_TESTS;
+        printf("MasterBus.process(...) [two saw waves] : %u ns\n", duration_ns);
+
+        /*----------------------------------------------------------------------------------------*/
+
+        {
+            // The cost of the anti-aliasing of an oversampled voice bus, per decimated sample of one channel
+            static fxpt_Q0_31 l_input[4 * SIZE_AUDIO_BLOCK];
+            fxpt_Q0_31 l_output[SIZE_AUDIO_BLOCK];
+            for(unsigned int i = 0; i < 4 * SIZE_AUDIO_BLOCK; ++i)
+            {
+                l_input[i] = saw_wave(i * 9162500U, 0);
+            }
+            static Decimator<2> l_decimator_2;
+            t_us = time_us_32();
+            for(unsigned int i = 0; i < NB_TESTS / SIZE_AUDIO_BLOCK; ++i)
+            {
+                l_decimator_2.process_block(l_input, l_output, SIZE_AUDIO_BLOCK);
+            }
+            t_us = time_us_32() - t_us;
+            duration_ns = t_us * 1000 / (NB_TESTS / SIZE_AUDIO_BLOCK * SIZE_AUDIO_BLOCK);
+            printf("Decimator<2>.process_block(...) [%u taps, per output sample] : %u ns, %u cycles per sample\n",
+                HalfBandDecimator<8>::NB_TAPS, duration_ns, duration_ns * SYSTEM_CLOCK_FREQUENCY_KHZ / 1000000);
+
+            static Decimator<4> l_decimator_4;
+            t_us = time_us_32();
+            for(unsigned int i = 0; i < NB_TESTS / SIZE_AUDIO_BLOCK; ++i)
+            {
+                l_decimator_4.process_block(l_input, l_output, SIZE_AUDIO_BLOCK);
+            }
+            t_us = time_us_32() - t_us;
+            duration_ns = t_us * 1000 / (NB_TESTS / SIZE_AUDIO_BLOCK * SIZE_AUDIO_BLOCK);
+            printf("Decimator<4>.process_block(...) [%u + %u taps, per output sample] : %u ns, %u cycles per sample\n",
+                HalfBandDecimator<3>::NB_TAPS, HalfBandDecimator<8>::NB_TAPS, duration_ns, duration_ns * SYSTEM_CLOCK_FREQUENCY_KHZ / 1000000);
+        }
+
+        /*----------------------------------------------------------------------------------------*/
+
+        {
+            // Signal to noise ratio of a single saw wave on the 16 bits output, the noise being the quantization error.
+            // The former mix divided the sum of the notes by their number.
+            float l_signal_divided = 0.f, l_noise_divided = 0.f, l_signal_limited = 0.f, l_noise_limited = 0.f;
+            for(unsigned int i = 0; i < NB_TESTS; ++i)
+            {
+                const fxpt_Q0_31 l_saw = saw_wave(i * 9162500U, 0);
+                const fxpt_Q0_31 l_divided = l_saw / (fxpt_Q0_31)NB_ACTIVE_NOTES;
+                const fxpt_Q0_31 l_limited = l_master_bus.process(l_saw);
+                // The error is the part of the sample below the 16 bits of the output
+                const float l_error_divided = fxpt_to_float(l_divided - (l_divided & ~0xFFFF), 31);
+                const float l_error_limited = fxpt_to_float(l_limited - (l_limited & ~0xFFFF), 31);
+                l_signal_divided += fxpt_to_float(l_divided, 31) * fxpt_to_float(l_divided, 31);
+                l_noise_divided += l_error_divided * l_error_divided;
+                l_signal_limited += fxpt_to_float(l_limited, 31) * fxpt_to_float(l_limited, 31);
+                l_noise_limited += l_error_limited * l_error_limited;
+            }
+            printf("MasterBus SNR [single saw wave, 16 bits] : %.1f dB, %.1f dB when divided by the number of notes\n",
+                10.f * log10f(l_signal_limited / l_noise_limited), 10.f * log10f(l_signal_divided / l_noise_divided));
+        }
+
+        {
+            // Distortion of a single sine note at full velocity by the limiter, which must leave it untouched.
+            // The distortion is the difference with the mix amplified by the master gain alone.
+            MasterBus l_master_bus;
+            static ActiveNote l_note;
+            l_note = ActiveNote(69, fxpt_convert_n(0x7F, 7, 31), 0, AUDIO_SAMPLING_FREQUENCY / 100, AUDIO_SAMPLING_FREQUENCY / 10);
+            float l_signal = 0.f, l_distortion = 0.f;
+            for(unsigned int i = 0; i < NB_TESTS; ++i)
+            {
+                const fxpt_Q0_31 l_value = l_note.get_audio_value(i, &sine_wave, fxpt_Q0_31(0), std::numeric_limits<fxpt_Q0_31>::max());
+                const float l_linear = fxpt_to_float(fxpt_convert_n((fxpt64_t)l_value * l_master_bus.get_gain(), 16, 0), 31);
+                const float l_error = fxpt_to_float(l_master_bus.process(l_value), 31) - l_linear;
+                l_signal += l_linear * l_linear;
+                l_distortion += l_error * l_error;
+            }
+            // Below -80 dB, the distortion is about the quantization noise of the 16 bits output
+            printf("MasterBus THD [single sine note, full velocity] : %.1f dB : %s\n",
+                10.f * log10f(l_distortion / l_signal), (l_distortion <= 1e-8f * l_signal) ? "OK" : "FAILED");
+        }
+
+        {
+            // Chords of 2 and 4 full scale saw waves, which must be compressed without any sample clipped at full scale
+            for(unsigned int l_nb_notes = 2; l_nb_notes <= 4; l_nb_notes *= 2)
+            {
+                MasterBus l_master_bus;
+                bool l_is_clipped = false;
+                fxpt_Q0_31 l_peak = 0;
+                for(unsigned int i = 0; i < NB_TESTS; ++i)
+                {
+                    fxpt64_t l_mix = 0;
+                    for(unsigned int n = 0; n < l_nb_notes; ++n)
+                    {
+                        // Close to a major chord, so that the peaks of the notes add up from time to time
+                        l_mix += saw_wave(i * (9162500U + n * 2309000U), 0);
+                    }
+                    const fxpt_Q0_31 l_limited = l_master_bus.process(l_mix);
+                    l_is_clipped = l_is_clipped || (l_limited == std::numeric_limits<fxpt_Q0_31>::max())
+                        || (l_limited == std::numeric_limits<fxpt_Q0_31>::min());
+                    l_peak = (l_limited > l_peak) ? l_limited : ((-l_limited > l_peak) ? -l_limited : l_peak);
+                }
+                printf("MasterBus.process(...) [%u full scale saw waves, no clipping] : peak %f : %s\n",
+                    l_nb_notes, fxpt_to_float(l_peak, 31), l_is_clipped ? "FAILED" : "OK");
+            }
+        }
+
+        /*----------------------------------------------------------------------------------------*/
+
         Biquad l_filter;
 
         t_us = time_us_32();
@@ -202,6 +1020,88 @@ void perform_tests()
         duration_ns = t_us * 1000 / NB_TESTS;
         printf("Biquad.process(...) : %u ns\n", duration_ns);
 
+        {
+            FixedBiquad l_fixed_filter(l_filter);
+            t_us = time_us_32();
+            for(unsigned int i = 0; i < NB_TESTS; ++i)
+            {
+                l_fixed_filter.process(i);
+            }
+            t_us = time_us_32() - t_us;
+            duration_ns = t_us * 1000 / NB_TESTS;
+            printf("FixedBiquad.process(...) [Fixed template] : %u ns\n", duration_ns);
+
+            // Same filter, same state, both versions must stay bit-exact
+            Biquad l_macro_filter = Biquad::get_low_pass(fxpt_convert_n(2000, 0, 16), AUDIO_SAMPLING_FREQUENCY, fxpt_from_float(2.f, 29));
+            FixedBiquad l_template_filter(l_macro_filter);
+            bool l_fixed_ok = true;
+            for(unsigned int i = 0; i < NB_TESTS; ++i)
+            {
+                // Square wave, so that the state covers its whole range
+                const fxpt_Q0_31 l_x = (i & 64) ? (1<<30) : -(1<<30);
+                l_fixed_ok = l_fixed_ok && (l_macro_filter.process(l_x) == l_template_filter.process(l_x));
+            }
+            printf("FixedBiquad.process(...) [same output as Biquad.process] : %s\n", l_fixed_ok ? "OK" : "FAILED");
+        }
+
+        {
+            // The lowest value by itself is the only product needing the integer bit added for signed operands
+            const bool l_product_ok = (FixedQ0_15::min() * FixedQ0_15::min()).to_float() == 1.f
+                && (FixedQ0_15::min() * Fixed<0, 16>::min()).to_float() == 1.f
+                && (FixedQ0_31::min() * FixedQ0_31::min()).to_float() == 1.f;
+            printf("Fixed operator*(...) [lowest value by lowest value] : %s\n", l_product_ok ? "OK" : "FAILED");
+        }
+
+        /*----------------------------------------------------------------------------------------*/
+
+        {
+            // At 4kHz and 46875Hz, 11 taps fall by about 9dB at 6kHz and 16dB at 8kHz, as the biquad (8dB and 14dB).
+            // 31 taps are sharper, about -30dB at 6kHz and -52dB at 8kHz.
+            constexpr fxpt_UQ16_16 l_cutoff = 4000<<16;
+            Biquad l_biquad = Biquad::get_low_pass(l_cutoff, AUDIO_SAMPLING_FREQUENCY);
+            Fir<11> l_fir_11 = Fir<11>::get_low_pass(l_cutoff, AUDIO_SAMPLING_FREQUENCY);
+            Fir<31> l_fir_31 = Fir<31>::get_low_pass(l_cutoff, AUDIO_SAMPLING_FREQUENCY);
+
+            t_us = time_us_32();
+            for(unsigned int i = 0; i < NB_TESTS; ++i)
+            {
+                l_biquad.process(i<<20);
+            }
+            t_us = time_us_32() - t_us;
+            duration_ns = t_us * 1000 / NB_TESTS;
+            printf("Biquad.process(...) [low pass at 4kHz] : %u ns, %u cycles per sample\n", duration_ns, duration_ns * SYSTEM_CLOCK_FREQUENCY_KHZ / 1000000);
+
+            t_us = time_us_32();
+            for(unsigned int i = 0; i < NB_TESTS; ++i)
+            {
+                l_fir_11.process(i<<20);
+            }
+            t_us = time_us_32() - t_us;
+            duration_ns = t_us * 1000 / NB_TESTS;
+            printf("Fir<11>.process(...) [low pass at 4kHz, same selectivity] : %u ns, %u cycles per sample\n", duration_ns, duration_ns * SYSTEM_CLOCK_FREQUENCY_KHZ / 1000000);
+
+            t_us = time_us_32();
+            for(unsigned int i = 0; i < NB_TESTS; ++i)
+            {
+                l_fir_31.process(i<<20);
+            }
+            t_us = time_us_32() - t_us;
+            duration_ns = t_us * 1000 / NB_TESTS;
+            printf("Fir<31>.process(...) [low pass at 4kHz] : %u ns, %u cycles per sample\n", duration_ns, duration_ns * SYSTEM_CLOCK_FREQUENCY_KHZ / 1000000);
+
+            duration_ns = measure_process_block_ns(l_fir_31);
+            printf("Fir<31>.process_block(...) [per sample] : %u ns\n", duration_ns);
+
+            t_us = time_us_32();
+            for(unsigned int i = 0; i < 100; ++i)
+            {
+                l_fir_31 = Fir<31>::get_low_pass((1000 + 10 * i)<<16, AUDIO_SAMPLING_FREQUENCY);
+            }
+            t_us = time_us_32() - t_us;
+            duration_ns = t_us * 1000 / 100;
+            printf("Fir<31>::get_low_pass(...) : %u ns\n", duration_ns);
+        }
+
         /*----------------------------------------------------------------------------------------*/
 
         DynamicBiquad l_dynamic_filter = DynamicBiquad(Biquad::get_low_pass(500., AUDIO_SAMPLING_FREQUENCY, M_SQRT1_2));
@@ -242,6 +1142,83 @@ void perform_tests()
 
         /*----------------------------------------------------------------------------------------*/
 
+        // Each effect of the master chain, per sample, the chain being static since the delay line does not fit in the stack
+        static MasterEffectsChain l_effects;
+        l_effects.set_enabled<EFFECT_LOW_PASS_IDX>(true);
+        l_effects.set_enabled<EFFECT_WAVESHAPER_IDX>(true);
+        l_effects.set_enabled<EFFECT_DELAY_IDX>(true);
+        l_effects.set_enabled<EFFECT_REVERB_IDX>(true);
+        for(unsigned int c = 0; c < NB_AUDIO_CHANNELS; ++c)
+        {
+            get_master_low_pass(l_effects, c) = l_dynamic_filter;
+        }
+        duration_ns = measure_process_block_ns(get_master_low_pass(l_effects, 0));
+        printf("DynamicBiquad.process_block(...) [per sample] : %u ns\n", duration_ns);
+
+        /*----------------------------------------------------------------------------------------*/
+
+        Waveshaper& l_waveshaper = get_master_waveshaper(l_effects, 0);
+        l_waveshaper.set_oversampling(false);
+        duration_ns = measure_process_block_ns(l_waveshaper);
+        printf("Waveshaper.process_block(...) [per sample] : %u ns\n", duration_ns);
+
+        /*----------------------------------------------------------------------------------------*/
+
+        l_waveshaper.set_oversampling(true);
+        duration_ns = measure_process_block_ns(l_waveshaper);
+        printf("Waveshaper.process_block(...) [per sample, oversampled] : %u ns\n", duration_ns);
+
+        /*----------------------------------------------------------------------------------------*/
+
+        Delay& l_delay = l_effects.get_effect<EFFECT_DELAY_IDX>();
+        l_delay.set_delay_ms(300);
+        duration_ns = measure_process_block_ns(l_delay);
+        printf("Delay.process_block(...) [per sample, %u bytes] : %u ns\n", DelayLine<Delay::SIZE_DELAY_LINE>::SIZE_BYTES, duration_ns);
+
+        /*----------------------------------------------------------------------------------------*/
+
+        // The delay time slides during the first blocks of the measure
+        l_delay.set_delay_tempo(120, 3, 4);
+        duration_ns = measure_process_block_ns(l_delay);
+        printf("Delay.process_block(...) [per sample, sliding] : %u ns\n", duration_ns);
+
+        /*----------------------------------------------------------------------------------------*/
+
+        // Each reverberation quality, the duration is also given in cycles per sample
+        static Reverb<REVERB_QUALITY_LOW> l_reverb_low;
+        duration_ns = measure_process_block_ns(l_reverb_low);
+        printf("Reverb.process_block(...) [low quality, %u bytes] : %u ns, %u cycles per sample\n",
+            Reverb<REVERB_QUALITY_LOW>::SIZE_BYTES, duration_ns, duration_ns * SYSTEM_CLOCK_FREQUENCY_KHZ / 1000000);
+
+        /*----------------------------------------------------------------------------------------*/
+
+        duration_ns = measure_process_block_ns(l_effects.get_effect<EFFECT_REVERB_IDX>());
+        printf("Reverb.process_block(...) [medium quality, %u bytes] : %u ns, %u cycles per sample\n",
+            Reverb<REVERB_QUALITY_MEDIUM>::SIZE_BYTES, duration_ns, duration_ns * SYSTEM_CLOCK_FREQUENCY_KHZ / 1000000);
+
+        /*----------------------------------------------------------------------------------------*/
+
+        static Reverb<REVERB_QUALITY_HIGH> l_reverb_high;
+        duration_ns = measure_process_block_ns(l_reverb_high);
+        printf("Reverb.process_block(...) [high quality, %u bytes] : %u ns, %u cycles per sample\n",
+            Reverb<REVERB_QUALITY_HIGH>::SIZE_BYTES, duration_ns, duration_ns * SYSTEM_CLOCK_FREQUENCY_KHZ / 1000000);
+
+        /*----------------------------------------------------------------------------------------*/
+
+        duration_ns = measure_process_block_ns(l_effects);
+        printf("MasterEffectsChain.process_block(...) [all enabled, per sample] : %u ns\n", duration_ns);
+
+        /*----------------------------------------------------------------------------------------*/
+
+        l_effects.set_enabled<EFFECT_LOW_PASS_IDX>(false);
+        l_effects.set_enabled<EFFECT_WAVESHAPER_IDX>(false);
+        l_effects.set_enabled<EFFECT_DELAY_IDX>(false);
+        l_effects.set_enabled<EFFECT_REVERB_IDX>(false);
+        duration_ns = measure_process_block_ns(l_effects);
+        printf("MasterEffectsChain.process_block(...) [all bypassed, per sample] : %u ns\n", duration_ns);
+
+        /*----------------------------------------------------------------------------------------*/
+
         printf("\n====================   End of tests   ====================\n\n");
         sleep_ms(5000);
     }